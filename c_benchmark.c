@@ -0,0 +1,1186 @@
+/*******************************************************************************
+ *
+ *  C-OOP-Container 基准测试
+ *
+ *  覆盖 `vector(int)`、`hashmap(int, int)` 与 `hashmap(cstr, int)` 的
+ *  插入、查找与删除，元素数量从 1K 到 100M。查找分为四种访问模式：
+ *    - sequential: 按插入顺序依次查找已存在的键
+ *    - random:     均匀随机地查找已存在的键
+ *    - zipf:       按 Zipf 分布 (theta = 0.99) 查找，少数热点键占据大部分访问
+ *    - miss90:     90% 的查找命中不存在的键
+ *
+ *  每个用例先预热，再重复运行多次，报告每次操作耗时 (ns/op) 的最小值、
+ *  各分位数、中位数与最大值。被测调用的返回值都经过 `BENCH_DO_NOT_OPTIMIZE`，
+ *  编译器无法把查找循环整体删除。
+ *
+ *  `--latency` 切换为延迟模式：每次操作单独计时 (x86 上使用 rdtsc，其余平台使用
+ *  单调时钟)，记入对数分桶的 HDR 风格直方图，报告 p50/p90/p99/p99.9/p99.99
+ *  与最大值。扩容时的 realloc 与 rehash 只在尾部延迟中可见，吞吐量平均值会掩盖它们。
+ *
+ *  `--counters` 在吞吐量模式下通过 perf_event_open 采集硬件计数器 (仅 Linux)：
+ *  指令数、周期数、缓存未命中、分支预测失败、dTLB 未命中与缺页次数，
+ *  按每次操作报告。计数器只在计时区间内开启；无法使用的计数器
+ *  (虚拟机、容器或 perf_event_paranoid 限制) 输出为空，不影响其余结果。
+ *
+ *  编译 (需要 GCC 或 Clang):
+ *      gcc -std=gnu11 -O3 -march=native -I. c_benchmark.c -o c_benchmark -lm
+ *  可选:
+ *      -DBENCH_BACKEND_OPEN / -DBENCH_BACKEND_SWISS  测试其他哈希表后端
+ *      -DCOOP_STATIC_DISPATCH                        测试静态分派
+ *
+ *  运行:
+ *      ./c_benchmark [--sizes 1K,10K,100K,1M,10M] [--runs 7] [--warmup 1]
+ *                    [--format text|csv|json] [--output FILE]
+ *                    [--filter SUBSTRING] [--seed N] [--latency] [--counters]
+ *
+ *  CSV/JSON 输出的字段在各版本之间保持稳定，可以直接存档并与之后的结果比较。
+ *
+ ******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define BENCH_HAVE_PERF 1
+#endif
+
+typedef const char* cstr;
+
+// 静态分派模式下直接绑定的类型；未定义 COOP_STATIC_DISPATCH 时不起作用
+#define COOP_VECTOR_TYPES(X) X(int)
+#define COOP_HASHMAP_TYPES(X) X(int, int) X(cstr, int)
+
+#include "vector.h"
+#if defined(BENCH_BACKEND_OPEN)
+#include "hashmap_open.h"
+#define BENCH_BACKEND "open"
+#define BENCH_HASHMAP_DEFINE HASHMAP_DEFINE_OPEN
+#elif defined(BENCH_BACKEND_SWISS)
+#include "hashmap_swiss.h"
+#define BENCH_BACKEND "swiss"
+#define BENCH_HASHMAP_DEFINE HASHMAP_DEFINE_SWISS
+#else
+#include "hashmap.h"
+#define BENCH_BACKEND "chained"
+#define BENCH_HASHMAP_DEFINE HASHMAP_DEFINE
+#endif
+
+#ifdef COOP_STATIC_DISPATCH
+#define BENCH_DISPATCH "static"
+#else
+#define BENCH_DISPATCH "vtable"
+#endif
+
+VECTOR_DEFINE(int);
+BENCH_HASHMAP_DEFINE(int, int);
+BENCH_HASHMAP_DEFINE(cstr, int);
+
+
+// --- 1. 计时、随机数与防优化工具 ---
+
+#ifdef _WIN32
+#include <windows.h>
+static double bench_now(void) {
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart / frequency.QuadPart;
+}
+#else
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+#endif
+
+/**
+ * 延迟模式使用的高精度时间戳。x86 上读取 TSC，开销只有几纳秒；
+ * 其他平台退化为单调时钟的纳秒数。刻度与纳秒的换算由 `bench_calibrate` 测得。
+ */
+#if defined(__x86_64__) || defined(__i386__)
+static inline uint64_t bench_ticks(void) {
+    return __rdtsc();
+}
+#elif defined(_WIN32)
+static inline uint64_t bench_ticks(void) {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t) counter.QuadPart;
+}
+#else
+static inline uint64_t bench_ticks(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+#endif
+
+static double bench_ns_per_tick = 1.0;
+static double bench_timer_overhead_ns = 0.0;
+
+// 用单调时钟测量约 20ms 内的刻度数，并取背靠背两次读取之差的最小值作为计时开销
+static void bench_calibrate(void) {
+    double start = bench_now();
+    uint64_t first = bench_ticks();
+    while (bench_now() - start < 0.02) {
+    }
+    bench_ns_per_tick = (bench_now() - start) * 1e9 / (double) (bench_ticks() - first);
+    uint64_t overhead = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t t0 = bench_ticks();
+        uint64_t t1 = bench_ticks();
+        if (t1 - t0 < overhead) {
+            overhead = t1 - t0;
+        }
+    }
+    bench_timer_overhead_ns = overhead * bench_ns_per_tick;
+}
+
+/**
+ * 硬件计数器：所有计数器组成一个 perf 事件组，由组长统一开启、关闭与清零，
+ * 每次 `bench_resume` / `bench_pause` 只需各一次 ioctl，且系统调用落在计时区间之外。
+ * 打不开的计数器记为不可用；一个都打不开时整个采集器关闭，基准测试照常进行。
+ */
+enum {
+    BENCH_INSTRUCTIONS,
+    BENCH_CYCLES,
+    BENCH_CACHE_MISSES,
+    BENCH_BRANCH_MISSES,
+    BENCH_DTLB_MISSES,
+    BENCH_PAGE_FAULTS,
+    BENCH_COUNTERS
+};
+
+static const char* const BENCH_COUNTER_NAMES[] = {"instructions", "cycles", "cache_misses",
+                                                  "branch_misses", "dtlb_misses", "page_faults"};
+
+typedef struct {
+    int leader;                     // 事件组组长的描述符，-1 表示采集器未开启
+    int slots[BENCH_COUNTERS];      // 计数器在组读取结果中的位置，-1 表示不可用
+    int opened;
+} BenchCounters;
+
+static BenchCounters bench_counters = {-1, {-1, -1, -1, -1, -1, -1}, 0};
+
+#ifdef BENCH_HAVE_PERF
+static int bench_perf_open(uint32_t type, uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+// 打开计数器组，返回是否至少有一个计数器可用；不可用的原因输出到 stderr
+static int bench_counters_open(void) {
+#ifdef BENCH_HAVE_PERF
+    static const struct {
+        uint32_t type;
+        uint64_t config;
+    } events[BENCH_COUNTERS] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        int fd = bench_perf_open(events[i].type, events[i].config, bench_counters.leader);
+        if (fd < 0) {
+            fprintf(stderr, "counter %s unavailable: %s\n", BENCH_COUNTER_NAMES[i], strerror(errno));
+            continue;
+        }
+        if (bench_counters.leader == -1) {
+            bench_counters.leader = fd;
+        }
+        bench_counters.slots[i] = bench_counters.opened++;
+    }
+    if (bench_counters.leader == -1) {
+        fprintf(stderr, "perf counters unavailable, continuing without them "
+                        "(check /proc/sys/kernel/perf_event_paranoid)\n");
+        return 0;
+    }
+    return 1;
+#else
+    fprintf(stderr, "perf counters are only supported on Linux, continuing without them\n");
+    return 0;
+#endif
+}
+
+#ifdef BENCH_HAVE_PERF
+#define BENCH_COUNTERS_CONTROL(request) \
+    ((void) (bench_counters.leader != -1 && ioctl(bench_counters.leader, (request), PERF_IOC_FLAG_GROUP)))
+#else
+#define BENCH_COUNTERS_CONTROL(request) ((void) 0)
+#endif
+
+static inline void bench_counters_enable(void) {
+    BENCH_COUNTERS_CONTROL(PERF_EVENT_IOC_ENABLE);
+}
+
+static inline void bench_counters_disable(void) {
+    BENCH_COUNTERS_CONTROL(PERF_EVENT_IOC_DISABLE);
+}
+
+static inline void bench_counters_reset(void) {
+    BENCH_COUNTERS_CONTROL(PERF_EVENT_IOC_RESET);
+}
+
+/**
+ * 读取自上次清零以来的累计计数，按多路复用的时间比例换算。
+ * 不可用或从未被调度到的计数器记为 NAN。
+ */
+static void bench_counters_read(double values[BENCH_COUNTERS]) {
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        values[i] = NAN;
+    }
+#ifdef BENCH_HAVE_PERF
+    struct {
+        uint64_t nr;
+        uint64_t time_enabled;
+        uint64_t time_running;
+        uint64_t values[BENCH_COUNTERS];
+    } data;
+    if (bench_counters.leader == -1 || read(bench_counters.leader, &data, sizeof(data)) <= 0 ||
+        data.time_running == 0) {
+        return;
+    }
+    double scale = (double) data.time_enabled / data.time_running;
+    for (int i = 0; i < BENCH_COUNTERS; i++) {
+        if (bench_counters.slots[i] != -1) {
+            values[i] = data.values[bench_counters.slots[i]] * scale;
+        }
+    }
+#endif
+}
+
+// 让编译器认为 value 被读取且内存可能被修改，从而保留产生它的调用
+#define BENCH_DO_NOT_OPTIMIZE(value) __asm__ volatile("" : : "g"(value) : "memory")
+
+// 每次运行至少执行的操作数：小规模用例重复多轮，避免计时器精度主导结果
+#define BENCH_MIN_OPS (1 << 20)
+// 每次查找运行最多执行的操作数：大规模用例只抽样，避免访问序列本身占满内存
+#define BENCH_MAX_OPS (1 << 24)
+#define BENCH_MAX_RUNS 64
+#define BENCH_ZIPF_THETA 0.99
+// vector 随机位置插入每次运行的搬移预算 (元素个数)：每次插入平均搬移半个数组，规模越大插入次数越少
+#define BENCH_INSERT_BUDGET (1LL << 26)
+
+static uint64_t bench_rng_state;
+
+// SplitMix64
+static inline uint64_t bench_random(void) {
+    uint64_t z = (bench_rng_state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t bench_random_below(uint64_t n) {
+    return (uint64_t) (((unsigned __int128) bench_random() * n) >> 64);
+}
+
+static inline double bench_random_unit(void) {
+    return (bench_random() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// 32 位双射：不同的输入必然得到不同的键，键集合与未命中集合因此互不相交
+static inline int bench_scramble(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    x ^= x >> 16;
+    return (int) x;
+}
+
+
+// --- 2. 数据集 ---
+
+enum { BENCH_SEQUENTIAL, BENCH_RANDOM, BENCH_ZIPF, BENCH_MISS };
+
+static const char* const BENCH_PATTERN_NAMES[] = {"sequential", "random", "zipf", "miss90"};
+
+typedef struct {
+    int size;
+    long long lookup_ops;
+    int* keys;              // size 个互不相同的键，插入顺序即下标顺序
+    int* misses;            // size 个与 keys 不相交的键
+    char* strings;          // 字符串键的存储区
+    cstr* string_keys;
+    cstr* string_misses;
+    double zipf_zeta;       // 0 表示尚未计算
+    double zipf_zeta2;
+    double zipf_eta;
+    // 以下为按需构建、在同一规模的多个用例之间复用的对象
+    vector(int) vec;
+    hashmap(int, int) int_map;
+    hashmap(cstr, int) string_map;
+    int* index_order;
+    int index_order_pattern;
+    int* int_order;
+    int int_order_pattern;
+    cstr* string_order;
+    int string_order_pattern;
+} BenchWorkload;
+
+static void bench_workload_init(BenchWorkload* w, int size, uint32_t seed) {
+    memset(w, 0, sizeof(*w));
+    w->size = size;
+    w->lookup_ops = size < BENCH_MIN_OPS ? BENCH_MIN_OPS : size > BENCH_MAX_OPS ? BENCH_MAX_OPS : size;
+    w->keys = (int*) malloc(size * sizeof(int));
+    w->misses = (int*) malloc(size * sizeof(int));
+    for (int i = 0; i < size; i++) {
+        w->keys[i] = bench_scramble((uint32_t) i ^ seed);
+        w->misses[i] = bench_scramble((uint32_t) (size + i) ^ seed);
+    }
+    w->index_order_pattern = -1;
+    w->int_order_pattern = -1;
+    w->string_order_pattern = -1;
+}
+
+// 字符串键只在第一个 cstr 用例运行时生成，只测 vector 与整数键时不必为其付出内存
+static void bench_workload_strings(BenchWorkload* w) {
+    if (w->strings != NULL) {
+        return;
+    }
+    // "key" + 最多 10 位十进制数字 + '\0'
+    w->strings = (char*) malloc((size_t) w->size * 2 * 14);
+    w->string_keys = (cstr*) malloc(w->size * sizeof(cstr));
+    w->string_misses = (cstr*) malloc(w->size * sizeof(cstr));
+    char* cursor = w->strings;
+    for (int i = 0; i < w->size; i++) {
+        w->string_keys[i] = cursor;
+        cursor += sprintf(cursor, "key%u", (uint32_t) w->keys[i]) + 1;
+        w->string_misses[i] = cursor;
+        cursor += sprintf(cursor, "key%u", (uint32_t) w->misses[i]) + 1;
+    }
+}
+
+static void bench_workload_free(BenchWorkload* w) {
+    if (w->vec != NULL) {
+        vector_free(w->vec);
+    }
+    if (w->int_map != NULL) {
+        hashmap_free(w->int_map);
+    }
+    if (w->string_map != NULL) {
+        hashmap_free(w->string_map);
+    }
+    free(w->index_order);
+    free(w->int_order);
+    free(w->string_order);
+    free(w->keys);
+    free(w->misses);
+    free(w->strings);
+    free(w->string_keys);
+    free(w->string_misses);
+}
+
+// YCSB 使用的 Zipf 生成器 (Gray et al., "Quickly Generating Billion-Record Synthetic Databases")
+static int bench_zipf(BenchWorkload* w) {
+    int n = w->size;
+    if (w->zipf_zeta == 0) {
+        for (int i = 1; i <= n; i++) {
+            w->zipf_zeta += 1.0 / pow(i, BENCH_ZIPF_THETA);
+        }
+        w->zipf_zeta2 = 1.0 + 1.0 / pow(2, BENCH_ZIPF_THETA);
+        w->zipf_eta = (1.0 - pow(2.0 / n, 1.0 - BENCH_ZIPF_THETA)) / (1.0 - w->zipf_zeta2 / w->zipf_zeta);
+    }
+    double u = bench_random_unit();
+    double uz = u * w->zipf_zeta;
+    if (uz < 1.0) {
+        return 0;
+    }
+    if (uz < w->zipf_zeta2) {
+        return n > 1 ? 1 : 0;
+    }
+    double eta = w->zipf_eta;
+    int rank = (int) (n * pow(eta * u - eta + 1.0, 1.0 / (1.0 - BENCH_ZIPF_THETA)));
+    return rank < n ? rank : n - 1;
+}
+
+/**
+ * 按访问模式生成第 j 次查找的目标：返回值小于 size 时表示 keys[返回值]，
+ * 否则表示 misses[返回值 - size]。Zipf 的排名直接作为下标，
+ * 由于 keys 本身是打乱的，热点键分散在整个表中。
+ */
+static int bench_next_index(BenchWorkload* w, int pattern, long long j) {
+    switch (pattern) {
+        case BENCH_SEQUENTIAL:
+            return (int) (j % w->size);
+        case BENCH_RANDOM:
+            return (int) bench_random_below(w->size);
+        case BENCH_ZIPF:
+            return bench_zipf(w);
+        default:
+            if (bench_random_below(10) < 9) {
+                return w->size + (int) bench_random_below(w->size);
+            }
+            return (int) bench_random_below(w->size);
+    }
+}
+
+static const int* bench_index_order(BenchWorkload* w, int pattern) {
+    if (w->index_order_pattern != pattern) {
+        if (w->index_order == NULL) {
+            w->index_order = (int*) malloc(w->lookup_ops * sizeof(int));
+        }
+        for (long long j = 0; j < w->lookup_ops; j++) {
+            w->index_order[j] = bench_next_index(w, pattern, j) % w->size;
+        }
+        w->index_order_pattern = pattern;
+    }
+    return w->index_order;
+}
+
+static const int* bench_int_order(BenchWorkload* w, int pattern) {
+    if (w->int_order_pattern != pattern) {
+        if (w->int_order == NULL) {
+            w->int_order = (int*) malloc(w->lookup_ops * sizeof(int));
+        }
+        for (long long j = 0; j < w->lookup_ops; j++) {
+            int index = bench_next_index(w, pattern, j);
+            w->int_order[j] = index < w->size ? w->keys[index] : w->misses[index - w->size];
+        }
+        w->int_order_pattern = pattern;
+    }
+    return w->int_order;
+}
+
+static const cstr* bench_string_order(BenchWorkload* w, int pattern) {
+    if (w->string_order_pattern != pattern) {
+        if (w->string_order == NULL) {
+            w->string_order = (cstr*) malloc(w->lookup_ops * sizeof(cstr));
+        }
+        for (long long j = 0; j < w->lookup_ops; j++) {
+            int index = bench_next_index(w, pattern, j);
+            w->string_order[j] = index < w->size ? w->string_keys[index] : w->string_misses[index - w->size];
+        }
+        w->string_order_pattern = pattern;
+    }
+    return w->string_order;
+}
+
+static vector(int) bench_build_vector(BenchWorkload* w) {
+    vector(int) vec = vector_new(int);
+    for (int i = 0; i < w->size; i++) {
+        vector_push(vec, w->keys[i]);
+    }
+    return vec;
+}
+
+static hashmap(int, int) bench_build_int_map(BenchWorkload* w) {
+    hashmap(int, int) map = hashmap_new(int, int);
+    for (int i = 0; i < w->size; i++) {
+        hashmap_put(map, w->keys[i], i);
+    }
+    return map;
+}
+
+static hashmap(cstr, int) bench_build_string_map(BenchWorkload* w) {
+    hashmap(cstr, int) map = hashmap_new(cstr, int);
+    for (int i = 0; i < w->size; i++) {
+        hashmap_put(map, w->string_keys[i], i);
+    }
+    return map;
+}
+
+
+// --- 3. 基准用例 ---
+
+/**
+ * HDR 风格的对数分桶直方图：每个 2 的幂区间再均分为 32 个子桶，
+ * 相对误差不超过 1/32，用固定大小的计数数组即可覆盖整个 64 位刻度范围。
+ * 小于 32 的值各占一个桶，是精确计数。
+ */
+#define BENCH_HISTOGRAM_SUB_BITS 5
+#define BENCH_HISTOGRAM_SUB (1 << BENCH_HISTOGRAM_SUB_BITS)
+#define BENCH_HISTOGRAM_BUCKETS ((64 - BENCH_HISTOGRAM_SUB_BITS + 1) * BENCH_HISTOGRAM_SUB)
+
+typedef struct {
+    uint64_t counts[BENCH_HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint64_t max;
+    double sum;
+} BenchHistogram;
+
+static inline int bench_histogram_index(uint64_t value) {
+    if (value < BENCH_HISTOGRAM_SUB) {
+        return (int) value;
+    }
+    int shift = 63 - __builtin_clzll(value) - BENCH_HISTOGRAM_SUB_BITS;
+    return (shift + 1) * BENCH_HISTOGRAM_SUB + (int) ((value >> shift) - BENCH_HISTOGRAM_SUB);
+}
+
+// 桶内的最大值，与 HdrHistogram 的 "highest equivalent value" 一致
+static inline uint64_t bench_histogram_upper(int index) {
+    if (index < BENCH_HISTOGRAM_SUB) {
+        return (uint64_t) index;
+    }
+    int shift = index / BENCH_HISTOGRAM_SUB - 1;
+    uint64_t mantissa = (uint64_t) (index % BENCH_HISTOGRAM_SUB + BENCH_HISTOGRAM_SUB);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+static inline void bench_histogram_record(BenchHistogram* h, uint64_t ticks) {
+    h->counts[bench_histogram_index(ticks)]++;
+    h->total++;
+    h->sum += (double) ticks;
+    if (ticks > h->max) {
+        h->max = ticks;
+    }
+}
+
+// 第 p 百分位的延迟 (纳秒)
+static double bench_histogram_percentile(const BenchHistogram* h, double p) {
+    uint64_t rank = (uint64_t) ceil(p / 100.0 * h->total);
+    if (rank < 1) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < BENCH_HISTOGRAM_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            uint64_t upper = bench_histogram_upper(i);
+            return (upper < h->max ? upper : h->max) * bench_ns_per_tick;
+        }
+    }
+    return h->max * bench_ns_per_tick;
+}
+
+/**
+ * 每个用例执行一次完整的运行并返回本次运行的操作数。
+ * 只有 `bench_resume` 与 `bench_pause` 之间的代码计入耗时，
+ * 构建被测对象、生成访问序列和释放内存都不计时。
+ * histogram 不为 NULL 时处于延迟模式，每次操作的耗时记入其中。
+ */
+typedef struct {
+    double start;
+    double elapsed;
+    BenchHistogram* histogram;
+} Bench;
+
+static inline void bench_resume(Bench* b) {
+    bench_counters_enable();
+    b->start = bench_now();
+}
+
+static inline void bench_pause(Bench* b) {
+    b->elapsed += bench_now() - b->start;
+    bench_counters_disable();
+}
+
+/**
+ * 被测循环：j 从 0 到 count - 1，循环体为可变参数部分。
+ * 吞吐量模式下整个循环只读两次时钟；延迟模式下每次迭代前后各读一次时间戳。
+ * 两种模式各展开一份循环体，吞吐量模式的循环中没有额外的分支。
+ */
+#define BENCH_TIMED_LOOP(b, j, count, ...) \
+    do { \
+        long long bench_count_ = (count); \
+        if ((b)->histogram == NULL) { \
+            bench_resume(b); \
+            for (long long j = 0; j < bench_count_; j++) { \
+                __VA_ARGS__ \
+            } \
+            bench_pause(b); \
+        } else { \
+            for (long long j = 0; j < bench_count_; j++) { \
+                uint64_t bench_start_ = bench_ticks(); \
+                __VA_ARGS__ \
+                bench_histogram_record((b)->histogram, bench_ticks() - bench_start_); \
+            } \
+        } \
+    } while (0)
+
+static inline int bench_repeats(BenchWorkload* w) {
+    return w->size < BENCH_MIN_OPS ? BENCH_MIN_OPS / w->size : 1;
+}
+
+static long long bench_vector_push(Bench* b, BenchWorkload* w, int pattern) {
+    (void) pattern;
+    int repeats = bench_repeats(w);
+    for (int r = 0; r < repeats; r++) {
+        vector(int) vec = vector_new(int);
+        BENCH_TIMED_LOOP(b, i, w->size, vector_push(vec, w->keys[i]););
+        vector_free(vec);
+    }
+    return (long long) repeats * w->size;
+}
+
+static long long bench_vector_get(Bench* b, BenchWorkload* w, int pattern) {
+    if (w->vec == NULL) {
+        w->vec = bench_build_vector(w);
+    }
+    vector(int) vec = w->vec;
+    const int* order = bench_index_order(w, pattern);
+    BENCH_TIMED_LOOP(b, j, w->lookup_ops, {
+        const int* value = vector_get(vec, order[j]);
+        BENCH_DO_NOT_OPTIMIZE(value);
+    });
+    return w->lookup_ops;
+}
+
+static inline long long bench_insert_count(BenchWorkload* w) {
+    long long count = BENCH_INSERT_BUDGET / w->size;
+    count = count < 16 ? 16 : count;
+    return count < w->size ? count : w->size;
+}
+
+static long long bench_vector_insert(Bench* b, BenchWorkload* w, int pattern) {
+    (void) pattern;
+    long long count = bench_insert_count(w);
+    int repeats = bench_repeats(w);
+    // 第 j 次插入时数组长度为 size + j，位置在 [0, size + j] 内均匀分布
+    int* positions = (int*) malloc(count * sizeof(int));
+    for (long long j = 0; j < count; j++) {
+        positions[j] = (int) bench_random_below(w->size + j + 1);
+    }
+    for (int r = 0; r < repeats; r++) {
+        vector(int) vec = bench_build_vector(w);
+        BENCH_TIMED_LOOP(b, j, count, {
+            bool inserted = vector_insert(vec, positions[j], (int) j);
+            BENCH_DO_NOT_OPTIMIZE(inserted);
+        });
+        vector_free(vec);
+    }
+    free(positions);
+    return (long long) repeats * count;
+}
+
+static long long bench_vector_pop(Bench* b, BenchWorkload* w, int pattern) {
+    (void) pattern;
+    int repeats = bench_repeats(w);
+    for (int r = 0; r < repeats; r++) {
+        vector(int) vec = bench_build_vector(w);
+        BENCH_TIMED_LOOP(b, i, w->size, {
+            bool popped = vector_pop(vec);
+            BENCH_DO_NOT_OPTIMIZE(popped);
+        });
+        vector_free(vec);
+    }
+    return (long long) repeats * w->size;
+}
+
+static long long bench_int_put(Bench* b, BenchWorkload* w, int pattern) {
+    int repeats = bench_repeats(w);
+    for (int r = 0; r < repeats; r++) {
+        hashmap(int, int) map = hashmap_new(int, int);
+        if (pattern == BENCH_SEQUENTIAL) {
+            BENCH_TIMED_LOOP(b, i, w->size, hashmap_put(map, (int) i, (int) i););
+        } else {
+            BENCH_TIMED_LOOP(b, i, w->size, hashmap_put(map, w->keys[i], (int) i););
+        }
+        hashmap_free(map);
+    }
+    return (long long) repeats * w->size;
+}
+
+static long long bench_int_get(Bench* b, BenchWorkload* w, int pattern) {
+    if (w->int_map == NULL) {
+        w->int_map = bench_build_int_map(w);
+    }
+    hashmap(int, int) map = w->int_map;
+    const int* order = bench_int_order(w, pattern);
+    BENCH_TIMED_LOOP(b, j, w->lookup_ops, {
+        const int* value = hashmap_get(map, order[j]);
+        BENCH_DO_NOT_OPTIMIZE(value);
+    });
+    return w->lookup_ops;
+}
+
+static long long bench_int_remove(Bench* b, BenchWorkload* w, int pattern) {
+    (void) pattern;
+    int repeats = bench_repeats(w);
+    for (int r = 0; r < repeats; r++) {
+        hashmap(int, int) map = bench_build_int_map(w);
+        BENCH_TIMED_LOOP(b, i, w->size, {
+            bool removed = hashmap_remove(map, w->keys[i]);
+            BENCH_DO_NOT_OPTIMIZE(removed);
+        });
+        hashmap_free(map);
+    }
+    return (long long) repeats * w->size;
+}
+
+static long long bench_string_put(Bench* b, BenchWorkload* w, int pattern) {
+    bench_workload_strings(w);
+    (void) pattern;
+    int repeats = bench_repeats(w);
+    for (int r = 0; r < repeats; r++) {
+        hashmap(cstr, int) map = hashmap_new(cstr, int);
+        BENCH_TIMED_LOOP(b, i, w->size, hashmap_put(map, w->string_keys[i], (int) i););
+        hashmap_free(map);
+    }
+    return (long long) repeats * w->size;
+}
+
+static long long bench_string_get(Bench* b, BenchWorkload* w, int pattern) {
+    bench_workload_strings(w);
+    if (w->string_map == NULL) {
+        w->string_map = bench_build_string_map(w);
+    }
+    hashmap(cstr, int) map = w->string_map;
+    const cstr* order = bench_string_order(w, pattern);
+    BENCH_TIMED_LOOP(b, j, w->lookup_ops, {
+        const int* value = hashmap_get(map, order[j]);
+        BENCH_DO_NOT_OPTIMIZE(value);
+    });
+    return w->lookup_ops;
+}
+
+static long long bench_string_remove(Bench* b, BenchWorkload* w, int pattern) {
+    bench_workload_strings(w);
+    (void) pattern;
+    int repeats = bench_repeats(w);
+    for (int r = 0; r < repeats; r++) {
+        hashmap(cstr, int) map = bench_build_string_map(w);
+        BENCH_TIMED_LOOP(b, i, w->size, {
+            bool removed = hashmap_remove(map, w->string_keys[i]);
+            BENCH_DO_NOT_OPTIMIZE(removed);
+        });
+        hashmap_free(map);
+    }
+    return (long long) repeats * w->size;
+}
+
+typedef struct {
+    const char* container;
+    const char* operation;
+    int pattern;
+    long long (*run)(Bench* b, BenchWorkload* w, int pattern);
+} BenchCase;
+
+static const BenchCase BENCH_CASES[] = {
+    {"vector<int>", "push", BENCH_SEQUENTIAL, bench_vector_push},
+    {"vector<int>", "get", BENCH_SEQUENTIAL, bench_vector_get},
+    {"vector<int>", "get", BENCH_RANDOM, bench_vector_get},
+    {"vector<int>", "insert", BENCH_RANDOM, bench_vector_insert},
+    {"vector<int>", "pop", BENCH_SEQUENTIAL, bench_vector_pop},
+    {"hashmap<int,int>", "put", BENCH_SEQUENTIAL, bench_int_put},
+    {"hashmap<int,int>", "put", BENCH_RANDOM, bench_int_put},
+    {"hashmap<int,int>", "get", BENCH_SEQUENTIAL, bench_int_get},
+    {"hashmap<int,int>", "get", BENCH_RANDOM, bench_int_get},
+    {"hashmap<int,int>", "get", BENCH_ZIPF, bench_int_get},
+    {"hashmap<int,int>", "get", BENCH_MISS, bench_int_get},
+    {"hashmap<int,int>", "remove", BENCH_RANDOM, bench_int_remove},
+    {"hashmap<cstr,int>", "put", BENCH_RANDOM, bench_string_put},
+    {"hashmap<cstr,int>", "get", BENCH_SEQUENTIAL, bench_string_get},
+    {"hashmap<cstr,int>", "get", BENCH_RANDOM, bench_string_get},
+    {"hashmap<cstr,int>", "get", BENCH_ZIPF, bench_string_get},
+    {"hashmap<cstr,int>", "get", BENCH_MISS, bench_string_get},
+    {"hashmap<cstr,int>", "remove", BENCH_RANDOM, bench_string_remove},
+};
+
+
+// --- 4. 统计与输出 ---
+
+enum { BENCH_TEXT, BENCH_CSV, BENCH_JSON };
+
+typedef struct {
+    int format;
+    FILE* out;
+    int runs;
+    int warmup;
+    uint32_t seed;
+    const char* filter;
+    int latency;
+    int counters;
+    int emitted;
+} BenchOptions;
+
+typedef struct {
+    double min;
+    double p10;
+    double p25;
+    double median;
+    double p75;
+    double p90;
+    double max;
+    double mean;
+} BenchSummary;
+
+static int bench_compare_double(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+// 线性插值的分位数，sorted 已按升序排列
+static double bench_percentile(const double* sorted, int n, double p) {
+    double rank = p / 100.0 * (n - 1);
+    int lower = (int) rank;
+    int upper = lower + 1 < n ? lower + 1 : lower;
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - lower);
+}
+
+static BenchSummary bench_summarize(double* samples, int n) {
+    BenchSummary s;
+    qsort(samples, n, sizeof(double), bench_compare_double);
+    s.min = samples[0];
+    s.p10 = bench_percentile(samples, n, 10);
+    s.p25 = bench_percentile(samples, n, 25);
+    s.median = bench_percentile(samples, n, 50);
+    s.p75 = bench_percentile(samples, n, 75);
+    s.p90 = bench_percentile(samples, n, 90);
+    s.max = samples[n - 1];
+    s.mean = 0;
+    for (int i = 0; i < n; i++) {
+        s.mean += samples[i] / n;
+    }
+    return s;
+}
+
+static void bench_emit_latency_header(BenchOptions* o) {
+    switch (o->format) {
+        case BENCH_TEXT:
+            fprintf(o->out, "# mode=latency backend=%s dispatch=%s runs=%d warmup=%d seed=%u timer_overhead=%.1fns\n",
+                    BENCH_BACKEND, BENCH_DISPATCH, o->runs, o->warmup, o->seed, bench_timer_overhead_ns);
+            fprintf(o->out, "%-18s %-7s %-10s %10s %12s %10s %10s %10s %10s %10s %12s\n", "container", "op",
+                    "pattern", "size", "samples", "p50", "p90", "p99", "p99.9", "p99.99", "max");
+            break;
+        case BENCH_CSV:
+            fprintf(o->out, "backend,dispatch,container,operation,pattern,size,samples,"
+                            "ns_p50,ns_p90,ns_p99,ns_p999,ns_p9999,ns_max,ns_mean\n");
+            break;
+        case BENCH_JSON:
+            fprintf(o->out, "{\n  \"suite\": \"c-oop-container\",\n  \"mode\": \"latency\",\n"
+                            "  \"backend\": \"%s\",\n  \"dispatch\": \"%s\",\n  \"compiler\": \"%s\",\n"
+                            "  \"seed\": %u,\n  \"warmup\": %d,\n  \"runs\": %d,\n"
+                            "  \"timer_overhead_ns\": %.3f,\n  \"results\": [",
+                    BENCH_BACKEND, BENCH_DISPATCH, __VERSION__, o->seed, o->warmup, o->runs,
+                    bench_timer_overhead_ns);
+            break;
+    }
+}
+
+static void bench_emit_header(BenchOptions* o) {
+    if (o->latency) {
+        bench_emit_latency_header(o);
+        return;
+    }
+    switch (o->format) {
+        case BENCH_TEXT:
+            fprintf(o->out, "# backend=%s dispatch=%s runs=%d warmup=%d seed=%u\n",
+                    BENCH_BACKEND, BENCH_DISPATCH, o->runs, o->warmup, o->seed);
+            fprintf(o->out, "%-18s %-7s %-10s %10s %10s %10s %10s %10s %10s %10s", "container", "op",
+                    "pattern", "size", "ops/run", "median", "p10", "p90", "min", "Mops/s");
+            if (o->counters) {
+                fprintf(o->out, " %9s %9s %9s %9s %9s %9s %9s", "instr/op", "cyc/op", "IPC", "cache/op",
+                        "branch/op", "dtlb/op", "fault/op");
+            }
+            fprintf(o->out, "\n");
+            break;
+        case BENCH_CSV:
+            fprintf(o->out, "backend,dispatch,container,operation,pattern,size,ops_per_run,runs,"
+                            "ns_min,ns_p10,ns_p25,ns_median,ns_p75,ns_p90,ns_max,ns_mean,mops_median");
+            if (o->counters) {
+                for (int i = 0; i < BENCH_COUNTERS; i++) {
+                    fprintf(o->out, ",%s_per_op", BENCH_COUNTER_NAMES[i]);
+                }
+            }
+            fprintf(o->out, "\n");
+            break;
+        case BENCH_JSON:
+            fprintf(o->out, "{\n  \"suite\": \"c-oop-container\",\n  \"backend\": \"%s\",\n"
+                            "  \"dispatch\": \"%s\",\n  \"compiler\": \"%s\",\n  \"seed\": %u,\n"
+                            "  \"warmup\": %d,\n  \"runs\": %d,\n  \"results\": [",
+                    BENCH_BACKEND, BENCH_DISPATCH, __VERSION__, o->seed, o->warmup, o->runs);
+            break;
+    }
+}
+
+/**
+ * 输出每次操作的计数器值。不可用的计数器 (NAN) 在文本中显示为 "-"，
+ * 在 CSV 中留空，在 JSON 中为 null。
+ */
+static void bench_emit_counters(BenchOptions* o, const double per_op[BENCH_COUNTERS]) {
+    double ipc = per_op[BENCH_INSTRUCTIONS] / per_op[BENCH_CYCLES];
+    switch (o->format) {
+        case BENCH_TEXT: {
+            const double columns[] = {per_op[BENCH_INSTRUCTIONS], per_op[BENCH_CYCLES], ipc,
+                                      per_op[BENCH_CACHE_MISSES], per_op[BENCH_BRANCH_MISSES],
+                                      per_op[BENCH_DTLB_MISSES], per_op[BENCH_PAGE_FAULTS]};
+            for (size_t i = 0; i < sizeof(columns) / sizeof(columns[0]); i++) {
+                if (isnan(columns[i])) {
+                    fprintf(o->out, " %9s", "-");
+                } else {
+                    fprintf(o->out, " %9.3f", columns[i]);
+                }
+            }
+            break;
+        }
+        case BENCH_CSV:
+            for (int i = 0; i < BENCH_COUNTERS; i++) {
+                if (isnan(per_op[i])) {
+                    fprintf(o->out, ",");
+                } else {
+                    fprintf(o->out, ",%.4f", per_op[i]);
+                }
+            }
+            break;
+        case BENCH_JSON:
+            fprintf(o->out, ",\n     \"counters_per_op\": {");
+            for (int i = 0; i < BENCH_COUNTERS; i++) {
+                fprintf(o->out, i > 0 ? ", \"%s\": " : "\"%s\": ", BENCH_COUNTER_NAMES[i]);
+                if (isnan(per_op[i])) {
+                    fprintf(o->out, "null");
+                } else {
+                    fprintf(o->out, "%.4f", per_op[i]);
+                }
+            }
+            fprintf(o->out, "}");
+            break;
+    }
+}
+
+// counters 为每次操作的计数器值，未开启 --counters 时为 NULL
+static void bench_emit(BenchOptions* o, const BenchCase* c, int size, long long ops, const BenchSummary* s,
+                       const double* counters) {
+    const char* pattern = BENCH_PATTERN_NAMES[c->pattern];
+    double mops = 1e3 / s->median;
+    switch (o->format) {
+        case BENCH_TEXT:
+            fprintf(o->out, "%-18s %-7s %-10s %10d %10lld %10.2f %10.2f %10.2f %10.2f %10.2f", c->container,
+                    c->operation, pattern, size, ops, s->median, s->p10, s->p90, s->min, mops);
+            break;
+        case BENCH_CSV:
+            fprintf(o->out, "%s,%s,\"%s\",%s,%s,%d,%lld,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f",
+                    BENCH_BACKEND, BENCH_DISPATCH, c->container, c->operation, pattern, size, ops, o->runs,
+                    s->min, s->p10, s->p25, s->median, s->p75, s->p90, s->max, s->mean, mops);
+            break;
+        case BENCH_JSON:
+            fprintf(o->out, "%s\n    {\"container\": \"%s\", \"operation\": \"%s\", \"pattern\": \"%s\", "
+                            "\"size\": %d, \"ops_per_run\": %lld, \"runs\": %d,\n     \"ns_per_op\": "
+                            "{\"min\": %.3f, \"p10\": %.3f, \"p25\": %.3f, \"median\": %.3f, \"p75\": %.3f, "
+                            "\"p90\": %.3f, \"max\": %.3f, \"mean\": %.3f}, \"mops_median\": %.3f",
+                    o->emitted > 0 ? "," : "", c->container, c->operation, pattern, size, ops, o->runs,
+                    s->min, s->p10, s->p25, s->median, s->p75, s->p90, s->max, s->mean, mops);
+            break;
+    }
+    if (counters != NULL) {
+        bench_emit_counters(o, counters);
+    }
+    fprintf(o->out, o->format == BENCH_JSON ? "}" : "\n");
+    o->emitted++;
+    fflush(o->out);
+}
+
+// 延迟模式下的一行结果；所有正式运行的样本合并在同一个直方图中
+static void bench_emit_latency(BenchOptions* o, const BenchCase* c, int size, const BenchHistogram* h) {
+    const char* pattern = BENCH_PATTERN_NAMES[c->pattern];
+    double p50 = bench_histogram_percentile(h, 50);
+    double p90 = bench_histogram_percentile(h, 90);
+    double p99 = bench_histogram_percentile(h, 99);
+    double p999 = bench_histogram_percentile(h, 99.9);
+    double p9999 = bench_histogram_percentile(h, 99.99);
+    double max = h->max * bench_ns_per_tick;
+    double mean = h->sum / h->total * bench_ns_per_tick;
+    switch (o->format) {
+        case BENCH_TEXT:
+            fprintf(o->out, "%-18s %-7s %-10s %10d %12llu %10.1f %10.1f %10.1f %10.1f %10.1f %12.1f\n",
+                    c->container, c->operation, pattern, size, (unsigned long long) h->total, p50, p90, p99,
+                    p999, p9999, max);
+            break;
+        case BENCH_CSV:
+            fprintf(o->out, "%s,%s,\"%s\",%s,%s,%d,%llu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.3f\n", BENCH_BACKEND,
+                    BENCH_DISPATCH, c->container, c->operation, pattern, size, (unsigned long long) h->total,
+                    p50, p90, p99, p999, p9999, max, mean);
+            break;
+        case BENCH_JSON:
+            fprintf(o->out, "%s\n    {\"container\": \"%s\", \"operation\": \"%s\", \"pattern\": \"%s\", "
+                            "\"size\": %d, \"samples\": %llu,\n     \"latency_ns\": {\"p50\": %.1f, "
+                            "\"p90\": %.1f, \"p99\": %.1f, \"p99.9\": %.1f, \"p99.99\": %.1f, \"max\": %.1f, "
+                            "\"mean\": %.3f}}",
+                    o->emitted > 0 ? "," : "", c->container, c->operation, pattern, size,
+                    (unsigned long long) h->total, p50, p90, p99, p999, p9999, max, mean);
+            break;
+    }
+    o->emitted++;
+    fflush(o->out);
+}
+
+static void bench_emit_footer(BenchOptions* o) {
+    if (o->format == BENCH_JSON) {
+        fprintf(o->out, "\n  ]\n}\n");
+    }
+}
+
+
+// --- 5. 命令行与主流程 ---
+
+static long long bench_parse_count(const char* text) {
+    char* end;
+    double value = strtod(text, &end);
+    switch (*end) {
+        case 'k': case 'K': value *= 1e3; break;
+        case 'm': case 'M': value *= 1e6; break;
+        case 'g': case 'G': value *= 1e9; break;
+        default: break;
+    }
+    return (long long) value;
+}
+
+static void bench_usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--sizes 1K,10K,100K,1M,10M] [--runs N] [--warmup N]\n"
+            "          [--format text|csv|json] [--output FILE] [--filter SUBSTRING] [--seed N]\n"
+            "          [--latency] [--counters]\n"
+            "sizes accept K/M/G suffixes; the largest supported size is 100M.\n"
+            "--latency times every operation and reports tail percentiles instead of throughput.\n"
+            "--counters adds per-operation hardware counters (Linux perf_event_open) to throughput runs.\n",
+            program);
+}
+
+// 延迟模式：预热运行同样逐次计时，保证正式运行时走的是已预热的代码路径，结束后清空直方图
+static void bench_run_latency_case(BenchOptions* o, const BenchCase* c, BenchWorkload* w) {
+    BenchHistogram* h = (BenchHistogram*) malloc(sizeof(BenchHistogram));
+    for (int r = -o->warmup; r < o->runs; r++) {
+        if (r <= 0) {
+            memset(h, 0, sizeof(*h));
+        }
+        Bench b = {0, 0, h};
+        c->run(&b, w, c->pattern);
+    }
+    bench_emit_latency(o, c, w->size, h);
+    free(h);
+}
+
+static void bench_run_case(BenchOptions* o, const BenchCase* c, BenchWorkload* w) {
+    if (o->latency) {
+        bench_run_latency_case(o, c, w);
+        return;
+    }
+    double samples[BENCH_MAX_RUNS];
+    long long ops = 0;
+    for (int r = -o->warmup; r < o->runs; r++) {
+        if (r == 0) {
+            bench_counters_reset();
+        }
+        Bench b = {0, 0, NULL};
+        ops = c->run(&b, w, c->pattern);
+        if (r >= 0) {
+            samples[r] = b.elapsed * 1e9 / ops;
+        }
+    }
+    BenchSummary s = bench_summarize(samples, o->runs);
+    double counters[BENCH_COUNTERS];
+    if (o->counters) {
+        bench_counters_read(counters);
+        for (int i = 0; i < BENCH_COUNTERS; i++) {
+            counters[i] /= (double) ops * o->runs;
+        }
+    }
+    bench_emit(o, c, w->size, ops, &s, o->counters ? counters : NULL);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions o = {BENCH_TEXT, stdout, 7, 1, 0x5EED, NULL, 0, 0, 0};
+    const char* sizes = "1K,10K,100K,1M,10M";
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--latency") == 0) {
+            o.latency = 1;
+            continue;
+        }
+        if (strcmp(arg, "--counters") == 0) {
+            o.counters = 1;
+            continue;
+        }
+        if (value == NULL) {
+            bench_usage(argv[0]);
+            return 2;
+        }
+        if (strcmp(arg, "--sizes") == 0) {
+            sizes = value;
+        } else if (strcmp(arg, "--runs") == 0) {
+            o.runs = atoi(value);
+        } else if (strcmp(arg, "--warmup") == 0) {
+            o.warmup = atoi(value);
+        } else if (strcmp(arg, "--format") == 0) {
+            o.format = strcmp(value, "csv") == 0 ? BENCH_CSV : strcmp(value, "json") == 0 ? BENCH_JSON : BENCH_TEXT;
+        } else if (strcmp(arg, "--output") == 0) {
+            o.out = fopen(value, "w");
+            if (o.out == NULL) {
+                perror(value);
+                return 1;
+            }
+        } else if (strcmp(arg, "--filter") == 0) {
+            o.filter = value;
+        } else if (strcmp(arg, "--seed") == 0) {
+            o.seed = (uint32_t) strtoul(value, NULL, 0);
+        } else {
+            bench_usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+    if (o.runs < 1 || o.runs > BENCH_MAX_RUNS || o.warmup < 0) {
+        fprintf(stderr, "--runs must be between 1 and %d, --warmup must not be negative\n", BENCH_MAX_RUNS);
+        return 2;
+    }
+
+    if (o.latency) {
+        bench_calibrate();
+        if (o.counters) {
+            fprintf(stderr, "--counters is ignored in latency mode: "
+                            "per-operation timestamps would dominate the counts\n");
+            o.counters = 0;
+        }
+    }
+    if (o.counters) {
+        bench_counters_open();
+    }
+    bench_emit_header(&o);
+    char* list = strdup(sizes);
+    for (char* token = strtok(list, ","); token != NULL; token = strtok(NULL, ",")) {
+        long long size = bench_parse_count(token);
+        if (size < 1 || size > 100000000) {
+            fprintf(stderr, "skipping size %s: must be between 1 and 100M\n", token);
+            continue;
+        }
+        bench_rng_state = o.seed;
+        BenchWorkload w;
+        bench_workload_init(&w, (int) size, o.seed);
+        for (size_t c = 0; c < sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]); c++) {
+            const BenchCase* bench_case = &BENCH_CASES[c];
+            char name[64];
+            snprintf(name, sizeof(name), "%s/%s/%s", bench_case->container, bench_case->operation,
+                     BENCH_PATTERN_NAMES[bench_case->pattern]);
+            if (o.filter != NULL && strstr(name, o.filter) == NULL) {
+                continue;
+            }
+            fprintf(stderr, "running %s [%lld]\n", name, size);
+            bench_run_case(&o, bench_case, &w);
+        }
+        bench_workload_free(&w);
+    }
+    free(list);
+    bench_emit_footer(&o);
+    if (o.out != stdout) {
+        fclose(o.out);
+    }
+    return 0;
+}
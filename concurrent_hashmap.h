@@ -0,0 +1,562 @@
+#ifndef CONCURRENT_HASHMAP_H
+#define CONCURRENT_HASHMAP_H
+
+#include <pthread.h>
+#include "hashmap.h"
+
+/**
+ * @file concurrent_hashmap.h
+ * @brief 一个可被多个线程同时读写的、基于锁分段的泛型哈希表 (C-OOP-Container)。
+ *
+ * 存储结构与 `hashmap.h` 中的链式哈希表相同：桶数组加上按块分配的条目链表。
+ * 不同之处在于全部操作由 `CONCURRENT_HASHMAP_STRIPES` 把锁保护：哈希值的低位
+ * 决定条目属于哪一个分段，第 `s` 个分段拥有下标满足 `i % STRIPES == s` 的所有桶。
+ * 由于桶数组的容量总是分段数的整数倍，一个键所属的分段在扩容前后保持不变，
+ * 不同线程只要落在不同分段上就完全不会相互阻塞。
+ *
+ * 每个分段独立统计自己的元素数量，当某个分段的平均链长超过 1 时触发扩容，
+ * 因此计数不会成为所有线程争用的热点。
+ *
+ * 扩容是协作式的：发现负载过高的线程只负责分配新的桶数组并发布，每个分段在下一次
+ * 被访问时由持有该分段锁的线程迁移到新数组，此外每次写操作还会顺带迁移一个尚未
+ * 迁移的分段。上一轮迁移完成 (所有分段都已迁入当前桶数组) 之前不会开始新一轮扩容，
+ * 此时的扩容请求直接放弃，由之后的写操作重新发起。任何时刻都不会有某个线程独自搬运整张表。
+ *
+ * 由于其他线程可能随时修改或删除条目，本容器不返回指向内部的指针：
+ * `concurrent_hashmap_get` 把值复制到调用者提供的变量中，需要原子地"读-改-写"时
+ * 请使用 `concurrent_hashmap_compute`。
+ *
+ * @note 依赖 POSIX 线程，编译时需要 `-pthread`。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+// === 公共API: 编译期配置 ===
+
+/**
+ * @brief 每个并发哈希表使用的锁分段数量 (必须是 2 的幂)。
+ *
+ * 分段越多，线程落在同一把锁上的概率越小，但每个实例固定占用的内存
+ * (每个分段一个缓存行) 也越多。桶数组的容量不会小于分段数。
+ */
+#ifndef CONCURRENT_HASHMAP_STRIPES
+#define CONCURRENT_HASHMAP_STRIPES 256
+#endif
+/**
+ * @brief 静态分派模式下需要直接绑定的并发哈希表类型列表，用法与 `COOP_HASHMAP_TYPES` 相同。
+ */
+#ifndef COOP_CONCURRENT_HASHMAP_TYPES
+#define COOP_CONCURRENT_HASHMAP_TYPES(X)
+#endif
+
+#ifdef COOP_STATIC_DISPATCH
+// --- Internal Macros ---
+#define __CONCURRENT_HASHMAP_VTABLE(self, K, V) (&CONCURRENT_HASHMAP_##K##V##FUNCTIONS)
+// --- Internal Macros ---
+#define __CONCURRENT_HASHMAP_FNS_CASE(K, V) ConcurrentHashmap_##K##_##V*: &CONCURRENT_HASHMAP_##K##V##FUNCTIONS,
+// --- Internal Macros ---
+#define __CONCURRENT_HASHMAP_FNS(map)                                                                               \
+    _Generic((map), COOP_CONCURRENT_HASHMAP_TYPES(__CONCURRENT_HASHMAP_FNS_CASE) default: (map)->fns)
+#else
+// --- Internal Macros ---
+#define __CONCURRENT_HASHMAP_VTABLE(self, K, V) ((self)->fns)
+// --- Internal Macros ---
+#define __CONCURRENT_HASHMAP_FNS(map) (map)->fns
+#endif
+
+// === 公共API: 定义宏 ===
+
+/**
+ * @brief 为指定的键值对类型定义一个具有默认行为的并发哈希表。
+ *
+ * 与 `HASHMAP_DEFINE` 相同，为基本类型自动生成哈希、比较和显示函数。
+ * 同一对 `K, V` 可以同时定义普通哈希表与并发哈希表。
+ *
+ * @note **重要提示**: `K` 和 `V` 的类型名不能包含空格或星号 (`*`)。
+ *       请使用 `typedef` 创建一个单一名词的别名。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ *
+ * @example
+ * CONCURRENT_HASHMAP_DEFINE(cstr, int)
+ * concurrent_hashmap(cstr, int) map = concurrent_hashmap_new(cstr, int);
+ */
+#define CONCURRENT_HASHMAP_DEFINE(K, V)                                                                             \
+__HASHMAP_DEFINE_DEFAULT_FUNCTIONS(ConcurrentHashmap, K, V)                                                         \
+CONCURRENT_HASHMAP_DEFINE_CUSTOM(K, V,                                                                              \
+    ConcurrentHashmap_##K##_##V##_hash,                                                                             \
+    ConcurrentHashmap_##K##_##V##_equals,                                                                           \
+    ConcurrentHashmap_##K##_##V##_key_display,                                                                      \
+    ConcurrentHashmap_##K##_##V##_value_display                                                                     \
+)                                                                                                                   \
+/**
+ * @brief 定义一个具有自定义行为函数的并发哈希表。
+ *
+ * 参数约定与 `HASHMAP_DEFINE_CUSTOM` 完全一致。所有回调都会在持有分段锁时被调用，
+ * 因此它们不能再访问同一个并发哈希表。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ * @param HashFn 用于哈希键的函数指针，类型为 `uint64_t (*)(K key)`。
+ * @param EqualsFn 用于比较键的函数指针，类型为 `bool (*)(K key1, K key2)`。
+ * @param DisplayKeyFn 用于打印键的函数指针，类型为 `void (*)(FILE* stream, K key)`。
+ * @param DisplayValueFn 用于打印值的函数指针，类型为 `void (*)(FILE* stream, V value)`。
+ */
+#define CONCURRENT_HASHMAP_DEFINE_CUSTOM(K, V, HashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)                      \
+                                                                                                                    \
+typedef struct __ConcurrentHashmap_##K##_##V ConcurrentHashmap_##K##_##V;                                           \
+                                                                                                                    \
+struct ConcurrentHashmapEntry_##K##_##V {                                                                           \
+    K key;                                                                                                          \
+    V value;                                                                                                        \
+    uint64_t hash;                                                                                                  \
+    struct ConcurrentHashmapEntry_##K##_##V* next;                                                                  \
+};                                                                                                                  \
+                                                                                                                    \
+struct ConcurrentHashmapSlab_##K##_##V {                                                                            \
+    struct ConcurrentHashmapSlab_##K##_##V* next;                                                                   \
+    int capacity;                                                                                                   \
+    int used;                                                                                                       \
+    struct ConcurrentHashmapEntry_##K##_##V entries[];                                                              \
+};                                                                                                                  \
+                                                                                                                    \
+struct ConcurrentHashmapTable_##K##_##V {                                                                           \
+    int capacity;                                                                                                   \
+    struct ConcurrentHashmapEntry_##K##_##V* buckets[];                                                             \
+};                                                                                                                  \
+                                                                                                                    \
+struct ConcurrentHashmapStripe_##K##_##V {                                                                          \
+    pthread_mutex_t lock;                                                                                           \
+    struct ConcurrentHashmapTable_##K##_##V* table;                                                                 \
+    int size;                                                                                                       \
+    struct ConcurrentHashmapSlab_##K##_##V* slabs;                                                                  \
+    struct ConcurrentHashmapEntry_##K##_##V* free_entries;                                                          \
+} __attribute__((aligned(64)));                                                                                     \
+                                                                                                                    \
+struct ConcurrentHashmap_##K##_##V##_Functions {                                                                    \
+    uint64_t (*hash)(K key);                                                                                        \
+    bool (*equals)(K key1, K key2);                                                                                 \
+    void (*display_key)(FILE* stream, K key);                                                                       \
+    void (*display_value)(FILE* stream, V value);                                                                   \
+    void (*display)(ConcurrentHashmap_##K##_##V* self, FILE* stream);                                               \
+    void (*put)(ConcurrentHashmap_##K##_##V* self, K key, V value);                                                 \
+    bool (*get)(ConcurrentHashmap_##K##_##V* self, K key, V* value);                                                \
+    bool (*compute)(ConcurrentHashmap_##K##_##V* self, K key, V default_value,                                      \
+                    void (*fn)(V* value, void* context), void* context);                                            \
+    bool (*remove)(ConcurrentHashmap_##K##_##V* self, K key);                                                       \
+    bool (*contains)(ConcurrentHashmap_##K##_##V* self, K key);                                                     \
+    int (*size)(ConcurrentHashmap_##K##_##V* self);                                                                 \
+    void (*clear)(ConcurrentHashmap_##K##_##V* self);                                                               \
+    void (*free)(ConcurrentHashmap_##K##_##V* self);                                                                \
+};                                                                                                                  \
+                                                                                                                    \
+struct __ConcurrentHashmap_##K##_##V {                                                                              \
+    const struct ConcurrentHashmap_##K##_##V##_Functions* fns;                                                      \
+    struct ConcurrentHashmapTable_##K##_##V* table;                                                                 \
+    struct ConcurrentHashmapTable_##K##_##V* old_table;                                                             \
+    int migrate_index;                                                                                              \
+    int migrated;                                                                                                   \
+    pthread_mutex_t resize_lock;                                                                                    \
+    struct ConcurrentHashmapStripe_##K##_##V stripes[CONCURRENT_HASHMAP_STRIPES];                                   \
+};                                                                                                                  \
+                                                                                                                    \
+const static struct ConcurrentHashmap_##K##_##V##_Functions CONCURRENT_HASHMAP_##K##V##FUNCTIONS;                   \
+                                                                                                                    \
+static struct ConcurrentHashmapTable_##K##_##V* ConcurrentHashmap_##K##_##V##_table_new(int capacity) {             \
+    size_t size = sizeof(struct ConcurrentHashmapTable_##K##_##V) +                                                 \
+                  capacity * sizeof(struct ConcurrentHashmapEntry_##K##_##V*);                                      \
+    struct ConcurrentHashmapTable_##K##_##V* table = (struct ConcurrentHashmapTable_##K##_##V*) calloc(1, size);    \
+    table->capacity = capacity;                                                                                     \
+    return table;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static struct ConcurrentHashmapEntry_##K##_##V* ConcurrentHashmap_##K##_##V##_alloc_entry(                          \
+    struct ConcurrentHashmapStripe_##K##_##V* stripe) {                                                             \
+    struct ConcurrentHashmapEntry_##K##_##V* entry = stripe->free_entries;                                          \
+    if (entry != NULL) {                                                                                            \
+        stripe->free_entries = entry->next;                                                                         \
+        return entry;                                                                                               \
+    }                                                                                                               \
+    struct ConcurrentHashmapSlab_##K##_##V* slab = stripe->slabs;                                                   \
+    if (slab == NULL || slab->used == slab->capacity) {                                                             \
+        int capacity = slab == NULL ? __HASHMAP_SLAB_MIN_ENTRIES : slab->capacity * 2;                              \
+        if (capacity > __HASHMAP_SLAB_MAX_ENTRIES) {                                                                \
+            capacity = __HASHMAP_SLAB_MAX_ENTRIES;                                                                  \
+        }                                                                                                           \
+        size_t size = sizeof(struct ConcurrentHashmapSlab_##K##_##V) +                                              \
+                      capacity * sizeof(struct ConcurrentHashmapEntry_##K##_##V);                                   \
+        slab = (struct ConcurrentHashmapSlab_##K##_##V*) malloc(size);                                              \
+        slab->next = stripe->slabs;                                                                                 \
+        slab->capacity = capacity;                                                                                  \
+        slab->used = 0;                                                                                             \
+        stripe->slabs = slab;                                                                                       \
+    }                                                                                                               \
+    return &slab->entries[slab->used++];                                                                            \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_release_slabs(struct ConcurrentHashmapStripe_##K##_##V* stripe) {         \
+    struct ConcurrentHashmapSlab_##K##_##V* slab = stripe->slabs;                                                   \
+    while (slab != NULL) {                                                                                          \
+        struct ConcurrentHashmapSlab_##K##_##V* next = slab->next;                                                  \
+        free(slab);                                                                                                 \
+        slab = next;                                                                                                \
+    }                                                                                                               \
+    stripe->slabs = NULL;                                                                                           \
+    stripe->free_entries = NULL;                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_migrate(ConcurrentHashmap_##K##_##V* self, int index,                     \
+                                                  struct ConcurrentHashmapTable_##K##_##V* table) {                 \
+    struct ConcurrentHashmapStripe_##K##_##V* stripe = &self->stripes[index];                                       \
+    struct ConcurrentHashmapTable_##K##_##V* old_table = stripe->table;                                             \
+    for (int i = index; i < old_table->capacity; i += CONCURRENT_HASHMAP_STRIPES) {                                 \
+        struct ConcurrentHashmapEntry_##K##_##V* entry = old_table->buckets[i];                                     \
+        while (entry != NULL) {                                                                                     \
+            int bucket = (int) (entry->hash & (table->capacity - 1));                                               \
+            struct ConcurrentHashmapEntry_##K##_##V* next_entry = entry->next;                                      \
+            entry->next = table->buckets[bucket];                                                                   \
+            table->buckets[bucket] = entry;                                                                         \
+            entry = next_entry;                                                                                     \
+        }                                                                                                           \
+        old_table->buckets[i] = NULL;                                                                               \
+    }                                                                                                               \
+    stripe->table = table;                                                                                          \
+    __atomic_add_fetch(&self->migrated, 1, __ATOMIC_RELEASE);                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+static struct ConcurrentHashmapStripe_##K##_##V* ConcurrentHashmap_##K##_##V##_lock(                                \
+    ConcurrentHashmap_##K##_##V* self, int index) {                                                                 \
+    struct ConcurrentHashmapStripe_##K##_##V* stripe = &self->stripes[index];                                       \
+    pthread_mutex_lock(&stripe->lock);                                                                              \
+    struct ConcurrentHashmapTable_##K##_##V* table = __atomic_load_n(&self->table, __ATOMIC_ACQUIRE);               \
+    if (stripe->table != table) {                                                                                   \
+        ConcurrentHashmap_##K##_##V##_migrate(self, index, table);                                                  \
+    }                                                                                                               \
+    return stripe;                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_help_migrate(ConcurrentHashmap_##K##_##V* self) {                         \
+    if (__atomic_load_n(&self->migrate_index, __ATOMIC_RELAXED) >= CONCURRENT_HASHMAP_STRIPES) {                    \
+        return;                                                                                                     \
+    }                                                                                                               \
+    int index = __atomic_fetch_add(&self->migrate_index, 1, __ATOMIC_ACQUIRE);                                      \
+    if (index < CONCURRENT_HASHMAP_STRIPES) {                                                                       \
+        pthread_mutex_unlock(&ConcurrentHashmap_##K##_##V##_lock(self, index)->lock);                               \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_grow(ConcurrentHashmap_##K##_##V* self, int capacity) {                   \
+    pthread_mutex_lock(&self->resize_lock);                                                                         \
+    if (self->table->capacity == capacity                                                                           \
+        && __atomic_load_n(&self->migrated, __ATOMIC_ACQUIRE) == CONCURRENT_HASHMAP_STRIPES) {                      \
+        free(self->old_table);                                                                                      \
+        self->old_table = self->table;                                                                              \
+        __atomic_store_n(&self->migrated, 0, __ATOMIC_RELAXED);                                                     \
+        __atomic_store_n(&self->table, ConcurrentHashmap_##K##_##V##_table_new(capacity * 2), __ATOMIC_RELEASE);    \
+        __atomic_store_n(&self->migrate_index, 0, __ATOMIC_RELEASE);                                                \
+    }                                                                                                               \
+    pthread_mutex_unlock(&self->resize_lock);                                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+static struct ConcurrentHashmapEntry_##K##_##V* ConcurrentHashmap_##K##_##V##_find(                                 \
+    ConcurrentHashmap_##K##_##V* self, struct ConcurrentHashmapStripe_##K##_##V* stripe, K key, uint64_t hash) {    \
+    struct ConcurrentHashmapEntry_##K##_##V* entry = stripe->table->buckets[hash & (stripe->table->capacity - 1)];  \
+    while (entry != NULL) {                                                                                         \
+        if (entry->hash == hash && __CONCURRENT_HASHMAP_VTABLE(self, K, V)->equals(entry->key, key)) {              \
+            return entry;                                                                                           \
+        }                                                                                                           \
+        entry = entry->next;                                                                                        \
+    }                                                                                                               \
+    return NULL;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static struct ConcurrentHashmapEntry_##K##_##V* ConcurrentHashmap_##K##_##V##_insert(                               \
+    struct ConcurrentHashmapStripe_##K##_##V* stripe, K key, uint64_t hash, V value, int* grow_from) {              \
+    struct ConcurrentHashmapTable_##K##_##V* table = stripe->table;                                                 \
+    struct ConcurrentHashmapEntry_##K##_##V** bucket = &table->buckets[hash & (table->capacity - 1)];               \
+    struct ConcurrentHashmapEntry_##K##_##V* entry = ConcurrentHashmap_##K##_##V##_alloc_entry(stripe);             \
+    entry->key = key;                                                                                               \
+    entry->value = value;                                                                                           \
+    entry->hash = hash;                                                                                             \
+    entry->next = *bucket;                                                                                          \
+    *bucket = entry;                                                                                                \
+    __atomic_store_n(&stripe->size, stripe->size + 1, __ATOMIC_RELAXED);                                            \
+    if (stripe->size > table->capacity / CONCURRENT_HASHMAP_STRIPES) {                                              \
+        *grow_from = table->capacity;                                                                               \
+    }                                                                                                               \
+    return entry;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_after_write(ConcurrentHashmap_##K##_##V* self, int grow_from) {           \
+    if (grow_from != 0) {                                                                                           \
+        ConcurrentHashmap_##K##_##V##_grow(self, grow_from);                                                        \
+    }                                                                                                               \
+    ConcurrentHashmap_##K##_##V##_help_migrate(self);                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_display(ConcurrentHashmap_##K##_##V* self, FILE* stream) {                \
+    fprintf(stream, "{");                                                                                           \
+    bool first = true;                                                                                              \
+    for (int s = 0; s < CONCURRENT_HASHMAP_STRIPES; s++) {                                                          \
+        struct ConcurrentHashmapStripe_##K##_##V* stripe = ConcurrentHashmap_##K##_##V##_lock(self, s);             \
+        for (int i = s; i < stripe->table->capacity; i += CONCURRENT_HASHMAP_STRIPES) {                             \
+            for (struct ConcurrentHashmapEntry_##K##_##V* entry = stripe->table->buckets[i]; entry != NULL;         \
+                 entry = entry->next) {                                                                             \
+                if (!first) {                                                                                       \
+                    fprintf(stream, ", ");                                                                          \
+                }                                                                                                   \
+                first = false;                                                                                      \
+                __CONCURRENT_HASHMAP_VTABLE(self, K, V)->display_key(stream, entry->key);                           \
+                fprintf(stream, ": ");                                                                              \
+                __CONCURRENT_HASHMAP_VTABLE(self, K, V)->display_value(stream, entry->value);                       \
+            }                                                                                                       \
+        }                                                                                                           \
+        pthread_mutex_unlock(&stripe->lock);                                                                        \
+    }                                                                                                               \
+    fprintf(stream, "}");                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_put(ConcurrentHashmap_##K##_##V* self, K key, V value) {                  \
+    uint64_t hash = __CONCURRENT_HASHMAP_VTABLE(self, K, V)->hash(key);                                             \
+    int grow_from = 0;                                                                                              \
+    struct ConcurrentHashmapStripe_##K##_##V* stripe =                                                              \
+        ConcurrentHashmap_##K##_##V##_lock(self, (int) (hash & (CONCURRENT_HASHMAP_STRIPES - 1)));                  \
+    struct ConcurrentHashmapEntry_##K##_##V* entry = ConcurrentHashmap_##K##_##V##_find(self, stripe, key, hash);   \
+    if (entry != NULL) {                                                                                            \
+        entry->value = value;                                                                                       \
+    } else {                                                                                                        \
+        ConcurrentHashmap_##K##_##V##_insert(stripe, key, hash, value, &grow_from);                                 \
+    }                                                                                                               \
+    pthread_mutex_unlock(&stripe->lock);                                                                            \
+    ConcurrentHashmap_##K##_##V##_after_write(self, grow_from);                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+static bool ConcurrentHashmap_##K##_##V##_get(ConcurrentHashmap_##K##_##V* self, K key, V* value) {                 \
+    uint64_t hash = __CONCURRENT_HASHMAP_VTABLE(self, K, V)->hash(key);                                             \
+    struct ConcurrentHashmapStripe_##K##_##V* stripe =                                                              \
+        ConcurrentHashmap_##K##_##V##_lock(self, (int) (hash & (CONCURRENT_HASHMAP_STRIPES - 1)));                  \
+    struct ConcurrentHashmapEntry_##K##_##V* entry = ConcurrentHashmap_##K##_##V##_find(self, stripe, key, hash);   \
+    if (entry != NULL && value != NULL) {                                                                           \
+        *value = entry->value;                                                                                      \
+    }                                                                                                               \
+    pthread_mutex_unlock(&stripe->lock);                                                                            \
+    return entry != NULL;                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static bool ConcurrentHashmap_##K##_##V##_compute(ConcurrentHashmap_##K##_##V* self, K key, V default_value,        \
+                                                  void (*fn)(V* value, void* context), void* context) {             \
+    uint64_t hash = __CONCURRENT_HASHMAP_VTABLE(self, K, V)->hash(key);                                             \
+    int grow_from = 0;                                                                                              \
+    struct ConcurrentHashmapStripe_##K##_##V* stripe =                                                              \
+        ConcurrentHashmap_##K##_##V##_lock(self, (int) (hash & (CONCURRENT_HASHMAP_STRIPES - 1)));                  \
+    struct ConcurrentHashmapEntry_##K##_##V* entry = ConcurrentHashmap_##K##_##V##_find(self, stripe, key, hash);   \
+    bool inserted = entry == NULL;                                                                                  \
+    if (inserted) {                                                                                                 \
+        entry = ConcurrentHashmap_##K##_##V##_insert(stripe, key, hash, default_value, &grow_from);                 \
+    }                                                                                                               \
+    fn(&entry->value, context);                                                                                     \
+    pthread_mutex_unlock(&stripe->lock);                                                                            \
+    ConcurrentHashmap_##K##_##V##_after_write(self, grow_from);                                                     \
+    return inserted;                                                                                                \
+}                                                                                                                   \
+                                                                                                                    \
+static bool ConcurrentHashmap_##K##_##V##_remove(ConcurrentHashmap_##K##_##V* self, K key) {                        \
+    uint64_t hash = __CONCURRENT_HASHMAP_VTABLE(self, K, V)->hash(key);                                             \
+    struct ConcurrentHashmapStripe_##K##_##V* stripe =                                                              \
+        ConcurrentHashmap_##K##_##V##_lock(self, (int) (hash & (CONCURRENT_HASHMAP_STRIPES - 1)));                  \
+    struct ConcurrentHashmapEntry_##K##_##V** link = &stripe->table->buckets[hash & (stripe->table->capacity - 1)]; \
+    bool removed = false;                                                                                           \
+    while (*link != NULL) {                                                                                         \
+        struct ConcurrentHashmapEntry_##K##_##V* entry = *link;                                                     \
+        if (entry->hash == hash && __CONCURRENT_HASHMAP_VTABLE(self, K, V)->equals(entry->key, key)) {              \
+            *link = entry->next;                                                                                    \
+            entry->next = stripe->free_entries;                                                                     \
+            stripe->free_entries = entry;                                                                           \
+            __atomic_store_n(&stripe->size, stripe->size - 1, __ATOMIC_RELAXED);                                    \
+            removed = true;                                                                                         \
+            break;                                                                                                  \
+        }                                                                                                           \
+        link = &entry->next;                                                                                        \
+    }                                                                                                               \
+    pthread_mutex_unlock(&stripe->lock);                                                                            \
+    ConcurrentHashmap_##K##_##V##_after_write(self, 0);                                                             \
+    return removed;                                                                                                 \
+}                                                                                                                   \
+                                                                                                                    \
+static bool ConcurrentHashmap_##K##_##V##_contains(ConcurrentHashmap_##K##_##V* self, K key) {                      \
+    return ConcurrentHashmap_##K##_##V##_get(self, key, NULL);                                                      \
+}                                                                                                                   \
+                                                                                                                    \
+static int ConcurrentHashmap_##K##_##V##_size(ConcurrentHashmap_##K##_##V* self) {                                  \
+    int size = 0;                                                                                                   \
+    for (int i = 0; i < CONCURRENT_HASHMAP_STRIPES; i++) {                                                          \
+        size += __atomic_load_n(&self->stripes[i].size, __ATOMIC_RELAXED);                                          \
+    }                                                                                                               \
+    return size;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_clear(ConcurrentHashmap_##K##_##V* self) {                                \
+    for (int s = 0; s < CONCURRENT_HASHMAP_STRIPES; s++) {                                                          \
+        struct ConcurrentHashmapStripe_##K##_##V* stripe = ConcurrentHashmap_##K##_##V##_lock(self, s);             \
+        for (int i = s; i < stripe->table->capacity; i += CONCURRENT_HASHMAP_STRIPES) {                             \
+            stripe->table->buckets[i] = NULL;                                                                       \
+        }                                                                                                           \
+        ConcurrentHashmap_##K##_##V##_release_slabs(stripe);                                                        \
+        __atomic_store_n(&stripe->size, 0, __ATOMIC_RELAXED);                                                       \
+        pthread_mutex_unlock(&stripe->lock);                                                                        \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void ConcurrentHashmap_##K##_##V##_free(ConcurrentHashmap_##K##_##V* self) {                                 \
+    for (int i = 0; i < CONCURRENT_HASHMAP_STRIPES; i++) {                                                          \
+        ConcurrentHashmap_##K##_##V##_release_slabs(&self->stripes[i]);                                             \
+        pthread_mutex_destroy(&self->stripes[i].lock);                                                              \
+    }                                                                                                               \
+    pthread_mutex_destroy(&self->resize_lock);                                                                      \
+    free(self->old_table);                                                                                          \
+    free(self->table);                                                                                              \
+    free(self);                                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+const static struct ConcurrentHashmap_##K##_##V##_Functions CONCURRENT_HASHMAP_##K##V##FUNCTIONS = {                \
+    .hash = HashFn,                                                                                                 \
+    .equals = EqualsFn,                                                                                             \
+    .display_key = DisplayKeyFn,                                                                                    \
+    .display_value = DisplayValueFn,                                                                                \
+    .display = ConcurrentHashmap_##K##_##V##_display,                                                               \
+    .put = ConcurrentHashmap_##K##_##V##_put,                                                                       \
+    .get = ConcurrentHashmap_##K##_##V##_get,                                                                       \
+    .compute = ConcurrentHashmap_##K##_##V##_compute,                                                               \
+    .remove = ConcurrentHashmap_##K##_##V##_remove,                                                                 \
+    .contains = ConcurrentHashmap_##K##_##V##_contains,                                                             \
+    .size = ConcurrentHashmap_##K##_##V##_size,                                                                     \
+    .clear = ConcurrentHashmap_##K##_##V##_clear,                                                                   \
+    .free = ConcurrentHashmap_##K##_##V##_free,                                                                     \
+};                                                                                                                  \
+                                                                                                                    \
+static ConcurrentHashmap_##K##_##V* ConcurrentHashmap_##K##_##V##_new(int capacity) {                               \
+    ConcurrentHashmap_##K##_##V* self = (ConcurrentHashmap_##K##_##V*) aligned_alloc(                               \
+        __alignof__(ConcurrentHashmap_##K##_##V), sizeof(ConcurrentHashmap_##K##_##V));                             \
+    self->fns = &CONCURRENT_HASHMAP_##K##V##FUNCTIONS;                                                              \
+    int table_capacity = CONCURRENT_HASHMAP_STRIPES;                                                                \
+    while (table_capacity < capacity) {                                                                             \
+        table_capacity *= 2;                                                                                        \
+    }                                                                                                               \
+    self->table = ConcurrentHashmap_##K##_##V##_table_new(table_capacity);                                          \
+    self->old_table = NULL;                                                                                         \
+    self->migrate_index = CONCURRENT_HASHMAP_STRIPES;                                                               \
+    self->migrated = CONCURRENT_HASHMAP_STRIPES;                                                                    \
+    pthread_mutex_init(&self->resize_lock, NULL);                                                                   \
+    for (int i = 0; i < CONCURRENT_HASHMAP_STRIPES; i++) {                                                          \
+        pthread_mutex_init(&self->stripes[i].lock, NULL);                                                           \
+        self->stripes[i].table = self->table;                                                                       \
+        self->stripes[i].size = 0;                                                                                  \
+        self->stripes[i].slabs = NULL;                                                                              \
+        self->stripes[i].free_entries = NULL;                                                                       \
+    }                                                                                                               \
+    return self;                                                                                                    \
+}                                                                                                                   \
+
+// === 公共API: 类型与构造函数宏 ===
+/**
+ * @brief 声明一个指向特定并发哈希表类型的指针。
+ * @param K 在 CONCURRENT_HASHMAP_DEFINE 中使用的键类型。
+ * @param V 在 CONCURRENT_HASHMAP_DEFINE 中使用的值类型。
+ * @example concurrent_hashmap(cstr, int) my_map;
+ */
+#define concurrent_hashmap(K, V) ConcurrentHashmap_##K##_##V*
+/**
+ * @brief 创建一个新的并发哈希表，初始桶数量等于锁分段数量。
+ * @param K 键的类型。
+ * @param V 值的类型。
+ * @return 指向新创建的并发哈希表的指针。
+ * @example my_map = concurrent_hashmap_new(cstr, int);
+ */
+#define concurrent_hashmap_new(K, V) ConcurrentHashmap_##K##_##V##_new(0)
+/**
+ * @brief 创建一个至少具有指定桶数量的新并发哈希表 (内部向上取整到 2 的幂)。
+ * @param K 键的类型。
+ * @param V 值的类型。
+ * @param capacity 初始桶数量。
+ * @return 指向新创建的并发哈希表的指针。
+ * @example my_map = concurrent_hashmap_new_with_capacity(cstr, int, 1 << 20);
+ */
+#define concurrent_hashmap_new_with_capacity(K, V, capacity) ConcurrentHashmap_##K##_##V##_new(capacity)
+// === 公共API: 核心操作宏 ===
+/**
+ * @brief 在并发哈希表中插入或更新一个键值对。可被多个线程同时调用。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @param key (K) 键。
+ * @param ... (V value) 与键关联的值。
+ * @example concurrent_hashmap_put(my_map, "hello", 42);
+ */
+#define concurrent_hashmap_put(map, key, ...) __CONCURRENT_HASHMAP_FNS(map)->put((map), (key), __VA_ARGS__)
+/**
+ * @brief 查找键，并在找到时把值复制到 `*out`。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @param key (K) 要查找的键。
+ * @param out (V*) 接收值的变量地址，可以为 NULL。
+ * @return (bool) 如果找到键，则返回 `true`；否则返回 `false`。
+ * @example int val; if (concurrent_hashmap_get(my_map, "hello", &val)) { printf("%d", val); }
+ */
+#define concurrent_hashmap_get(map, key, out) __CONCURRENT_HASHMAP_FNS(map)->get((map), (key), (out))
+/**
+ * @brief 原子地读取并修改一个值：键不存在时先以 `default_value` 插入，然后在持有锁的情况下调用 `fn(&value, context)`。
+ * `fn` 应当尽量短小，并且不能再访问同一个并发哈希表。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @param key (K) 键。
+ * @param default_value (V) 键不存在时插入的初始值。
+ * @param fn (void (*)(V* value, void* context)) 修改值的回调。
+ * @param context (void*) 原样传给 `fn` 的参数。
+ * @return (bool) 如果本次插入了新条目，则返回 `true`。
+ * @example static void inc(int* v, void* ctx) { (*v)++; } concurrent_hashmap_compute(counts, word, 0, inc, NULL);
+ */
+#define concurrent_hashmap_compute(map, key, default_value, fn, context)                                            \
+    __CONCURRENT_HASHMAP_FNS(map)->compute((map), (key), (default_value), (fn), (context))
+/**
+ * @brief 从并发哈希表中移除一个键值对。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @param key (K) 要移除条目的键。
+ * @return (bool) 如果成功移除了一个元素，则返回 `true`；否则返回 `false`。
+ * @example bool removed = concurrent_hashmap_remove(my_map, "hello");
+ */
+#define concurrent_hashmap_remove(map, key) __CONCURRENT_HASHMAP_FNS(map)->remove((map), (key))
+/**
+ * @brief 检查并发哈希表是否包含指定的键。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @param key (K) 要检查的键。
+ * @return (bool) 如果键存在，则返回 `true`；否则返回 `false`。
+ * @example if (concurrent_hashmap_contains(my_map, "world")) { ... }
+ */
+#define concurrent_hashmap_contains(map, key) __CONCURRENT_HASHMAP_FNS(map)->contains((map), (key))
+// === 公共API: 工具与生命周期宏 ===
+/**
+ * @brief 将并发哈希表的内容显示到给定的文件流。各分段依次加锁，结果不是全表的一致快照。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @param stream (FILE*) 输出流。
+ * @example concurrent_hashmap_display(my_map, stdout);
+ */
+#define concurrent_hashmap_display(map, stream) __CONCURRENT_HASHMAP_FNS(map)->display((map), (stream))
+/**
+ * @brief 返回并发哈希表中键值对的数量。并发修改期间只是一个近似值。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @return (int) 当前大小。
+ * @example int count = concurrent_hashmap_size(my_map);
+ */
+#define concurrent_hashmap_size(map) __CONCURRENT_HASHMAP_FNS(map)->size(map)
+/**
+ * @brief 移除所有键值对。各分段依次清空，不保证与并发插入之间的先后顺序。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @example concurrent_hashmap_clear(my_map);
+ */
+#define concurrent_hashmap_clear(map) __CONCURRENT_HASHMAP_FNS(map)->clear(map)
+/**
+ * @brief 释放与并发哈希表相关的所有内存。调用时不能再有其他线程访问该哈希表。
+ * @param map (concurrent_hashmap(K,V)) 并发哈希表实例。
+ * @example concurrent_hashmap_free(my_map);
+ */
+#define concurrent_hashmap_free(map) __CONCURRENT_HASHMAP_FNS(map)->free(map)
+
+#endif // CONCURRENT_HASHMAP_H
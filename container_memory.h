@@ -0,0 +1,226 @@
+#ifndef CONTAINER_MEMORY_H
+#define CONTAINER_MEMORY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__linux__) || defined(_WIN32)
+#include <malloc.h>
+#endif
+
+/**
+ * @file container_memory.h
+ * @brief 容器内存占用统计与全局分配跟踪 (C-OOP-Container)。
+ *
+ * `vector.h` 与 `hashmap.h` 都包含本头文件，一般不需要单独包含。
+ *
+ * `vector_memory_usage` 与 `hashmap_memory_usage` 返回 `ContainerMemoryUsage`，
+ * 区分三个层次的字节数：元素本身 (logical)、向分配器申请的字节数 (requested，
+ * 包括表头、容量余量、桶数组与节点)，以及分配器实际给出的字节数 (allocated，
+ * Linux 与 Windows 上为 `malloc_usable_size` / `_msize` 之和，macOS 上为 `malloc_size` 之和)。
+ * 三者之差分别是容量余量与分配器的取整开销。
+ *
+ * 在包含任何容器头文件之前 `#define COOP_TRACK_ALLOCATIONS 1`，每个容器类型的所有分配
+ * 都会按类型名 (如 `"vector(int)"`、`"hashmap(cstr, int)"`) 汇总到一张全局表中，
+ * 由 `container_memory_snapshot` 与 `container_memory_display` 读取，用于找出占用内存最多的实例化。
+ * 全局表以弱符号定义，同一程序中的所有翻译单元共享同一张表；计数使用原子操作，可以在多线程中使用。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+// === 公共API: 编译期配置 ===
+
+/**
+ * @brief 是否启用全局分配跟踪 (默认关闭)。
+ *
+ * 关闭时跟踪代码在编译期被消除，没有任何运行时开销。
+ */
+#ifndef COOP_TRACK_ALLOCATIONS
+#define COOP_TRACK_ALLOCATIONS 0
+#endif
+/**
+ * @brief 全局分配跟踪表最多容纳的容器类型数量，超出的类型不再被跟踪。
+ */
+#ifndef COOP_TRACK_ALLOCATIONS_SLOTS
+#define COOP_TRACK_ALLOCATIONS_SLOTS 256
+#endif
+
+// === 公共API: 类型 ===
+
+/**
+ * @brief 单个容器的内存占用，由 `vector_memory_usage` / `hashmap_memory_usage` 返回。
+ */
+typedef struct {
+    size_t logical_bytes;       // 元素 (键值对) 本身：size * sizeof(元素)
+    size_t requested_bytes;     // 向分配器申请的字节数：表头、容量余量、桶数组与节点
+    size_t allocated_bytes;     // 分配器实际给出的字节数，不支持查询的平台上等于 requested_bytes
+    int blocks;                 // 持有的堆块数量
+} ContainerMemoryUsage;
+
+/**
+ * @brief 全局分配跟踪表中一个容器类型的统计，字节数按申请大小计算。
+ */
+typedef struct {
+    const char* name;           // 容器类型名，如 "vector(int)"
+    long long live_bytes;       // 当前仍未释放的字节数
+    long long peak_bytes;       // live_bytes 的历史最大值
+    long long live_blocks;      // 当前仍未释放的堆块数量
+    long long total_allocations;// 累计分配 (含 realloc) 次数
+} ContainerAllocStats;
+
+// --- Internal Helper Functions ---
+static inline size_t ContainerMemory_usable_size(const void* block, size_t requested) {
+    if (block == NULL) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    (void) requested;
+    return malloc_size(block);
+#elif defined(__linux__)
+    (void) requested;
+    return malloc_usable_size((void*) block);
+#elif defined(_WIN32)
+    (void) requested;
+    return _msize((void*) block);
+#else
+    return requested;
+#endif
+}
+// --- Internal Helper Functions ---
+static inline void ContainerMemory_add_block(ContainerMemoryUsage* usage, const void* block, size_t requested) {
+    if (block == NULL) {
+        return;
+    }
+    usage->requested_bytes += requested;
+    usage->allocated_bytes += ContainerMemory_usable_size(block, requested);
+    usage->blocks++;
+}
+
+#if COOP_TRACK_ALLOCATIONS
+typedef struct {
+    int lock;
+    int count;
+    ContainerAllocStats slots[COOP_TRACK_ALLOCATIONS_SLOTS];
+} ContainerMemoryRegistry;
+
+__attribute__((weak)) ContainerMemoryRegistry container_memory_registry;
+
+// --- Internal Helper Functions ---
+static inline int ContainerMemory_register(const char* name) {
+    ContainerMemoryRegistry* registry = &container_memory_registry;
+    while (__atomic_test_and_set(&registry->lock, __ATOMIC_ACQUIRE)) {
+    }
+    int slot = 0;
+    while (slot < registry->count && strcmp(registry->slots[slot].name, name) != 0) {
+        slot++;
+    }
+    if (slot == registry->count) {
+        if (slot < COOP_TRACK_ALLOCATIONS_SLOTS) {
+            registry->slots[slot].name = name;
+            __atomic_store_n(&registry->count, slot + 1, __ATOMIC_RELEASE);
+        } else {
+            slot = COOP_TRACK_ALLOCATIONS_SLOTS;
+        }
+    }
+    __atomic_clear(&registry->lock, __ATOMIC_RELEASE);
+    return slot;
+}
+// --- Internal Helper Functions ---
+/**
+ * 记录一次分配变化：bytes 为字节数的增量 (释放时为负)，blocks 为堆块数的增量。
+ * *slot 缓存该类型在全局表中的位置，-1 表示尚未注册。
+ */
+static inline void ContainerMemory_track(const char* name, int* slot, long long bytes, int blocks) {
+    int index = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    if (index < 0) {
+        index = ContainerMemory_register(name);
+        __atomic_store_n(slot, index, __ATOMIC_RELAXED);
+    }
+    if (index >= COOP_TRACK_ALLOCATIONS_SLOTS) {
+        return;
+    }
+    ContainerAllocStats* stats = &container_memory_registry.slots[index];
+    long long live = __atomic_add_fetch(&stats->live_bytes, bytes, __ATOMIC_RELAXED);
+    long long peak = __atomic_load_n(&stats->peak_bytes, __ATOMIC_RELAXED);
+    while (live > peak &&
+           !__atomic_compare_exchange_n(&stats->peak_bytes, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    __atomic_add_fetch(&stats->live_blocks, blocks, __ATOMIC_RELAXED);
+    if (bytes > 0) {
+        __atomic_add_fetch(&stats->total_allocations, 1, __ATOMIC_RELAXED);
+    }
+}
+// --- Internal Macros ---
+#define __CONTAINER_MEMORY_TRACK(name, bytes, blocks)                                                               \
+    do {                                                                                                            \
+        static int slot_ = -1;                                                                                      \
+        ContainerMemory_track((name), &slot_, (bytes), (blocks));                                                   \
+    } while (0)
+#else
+// --- Internal Macros ---
+#define __CONTAINER_MEMORY_TRACK(name, bytes, blocks) ((void) (bytes), (void) (blocks))
+#endif
+
+// --- Internal Helper Functions ---
+static inline int ContainerMemory_snapshot(ContainerAllocStats* out, int max) {
+#if COOP_TRACK_ALLOCATIONS
+    int count = __atomic_load_n(&container_memory_registry.count, __ATOMIC_ACQUIRE);
+    count = count < max ? count : max;
+    for (int i = 0; i < count; i++) {
+        const ContainerAllocStats* stats = &container_memory_registry.slots[i];
+        out[i].name = stats->name;
+        out[i].live_bytes = __atomic_load_n(&stats->live_bytes, __ATOMIC_RELAXED);
+        out[i].peak_bytes = __atomic_load_n(&stats->peak_bytes, __ATOMIC_RELAXED);
+        out[i].live_blocks = __atomic_load_n(&stats->live_blocks, __ATOMIC_RELAXED);
+        out[i].total_allocations = __atomic_load_n(&stats->total_allocations, __ATOMIC_RELAXED);
+    }
+    return count;
+#else
+    (void) out;
+    (void) max;
+    return 0;
+#endif
+}
+// --- Internal Helper Functions ---
+static inline int ContainerMemory_compare_live(const void* a, const void* b) {
+    long long x = ((const ContainerAllocStats*) a)->live_bytes;
+    long long y = ((const ContainerAllocStats*) b)->live_bytes;
+    return (x < y) - (x > y);
+}
+// --- Internal Helper Functions ---
+static inline void ContainerMemory_display(FILE* stream) {
+    ContainerAllocStats stats[COOP_TRACK_ALLOCATIONS_SLOTS];
+    int count = ContainerMemory_snapshot(stats, COOP_TRACK_ALLOCATIONS_SLOTS);
+    qsort(stats, count, sizeof(stats[0]), ContainerMemory_compare_live);
+    fprintf(stream, "%-32s %14s %14s %12s %14s\n", "container", "live bytes", "peak bytes", "live blocks",
+            "allocations");
+    for (int i = 0; i < count; i++) {
+        fprintf(stream, "%-32s %14lld %14lld %12lld %14lld\n", stats[i].name, stats[i].live_bytes,
+                stats[i].peak_bytes, stats[i].live_blocks, stats[i].total_allocations);
+    }
+}
+
+// === 公共API: 全局分配跟踪 ===
+
+/**
+ * @brief 复制全局分配跟踪表的当前内容。未开启 `COOP_TRACK_ALLOCATIONS` 时总是返回 0。
+ * @param out (ContainerAllocStats*) 接收结果的数组。
+ * @param max (int) 数组容量。
+ * @return (int) 写入的条目数量，按类型第一次分配的先后排列。
+ * @example
+ * ContainerAllocStats stats[64];
+ * int n = container_memory_snapshot(stats, 64);
+ */
+#define container_memory_snapshot(out, max) ContainerMemory_snapshot((out), (max))
+/**
+ * @brief 按当前占用从大到小打印全局分配跟踪表。
+ * @param stream (FILE*) 输出流。
+ * @example container_memory_display(stderr);
+ */
+#define container_memory_display(stream) ContainerMemory_display(stream)
+
+#endif // CONTAINER_MEMORY_H
@@ -5,6 +5,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "container_memory.h"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /**
  * @file hashmap.h
@@ -18,50 +27,802 @@
  */
 
 // --- Internal Helper Functions ---
-static int Hashmap_hash_cstr(const char* key) {
-    const char* str = (const char*) key;
-    int hash = 0;
-    while (*str != '\0') {
-        hash = hash * 31 + *str;
-        str++;
+static inline uint64_t Hashmap_read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_mul128(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t) *a * *b;
+    *a = (uint64_t) r;
+    *b = (uint64_t) (r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t) *a, lb = (uint32_t) *b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_mix(uint64_t a, uint64_t b) {
+    Hashmap_mul128(&a, &b);
+    return a ^ b;
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_hash_bytes(const void* key, size_t len, uint64_t seed) {
+    static const uint64_t secret[4] = {
+        0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+    };
+    const unsigned char* p = (const unsigned char*) key;
+    uint64_t a, b;
+    seed ^= Hashmap_mix(seed ^ secret[0], secret[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (Hashmap_read32(p) << 32) | Hashmap_read32(p + ((len >> 3) << 2));
+            b = (Hashmap_read32(p + len - 4) << 32) | Hashmap_read32(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = ((uint64_t) p[0] << 16) | ((uint64_t) p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = Hashmap_mix(Hashmap_read64(p) ^ secret[1], Hashmap_read64(p + 8) ^ seed);
+                seed1 = Hashmap_mix(Hashmap_read64(p + 16) ^ secret[2], Hashmap_read64(p + 24) ^ seed1);
+                seed2 = Hashmap_mix(Hashmap_read64(p + 32) ^ secret[3], Hashmap_read64(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = Hashmap_mix(Hashmap_read64(p) ^ secret[1], Hashmap_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = Hashmap_read64(p + i - 16);
+        b = Hashmap_read64(p + i - 8);
     }
-    return hash;
+    a ^= secret[1];
+    b ^= seed;
+    Hashmap_mul128(&a, &b);
+    return Hashmap_mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_hash_mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
 }
 // --- Internal Helper Functions ---
-static int Hashmap_hash_int64(long long key) { 
+static inline uint64_t Hashmap_hash_cstr(const char* key) {
+    return Hashmap_hash_bytes(key, strlen(key), 0);
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_hash_int64(long long key) {
+    return Hashmap_hash_mix64((uint64_t) key);
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_hash_uint64(unsigned long long key) {
+    return Hashmap_hash_mix64((uint64_t) key);
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_hash_float64(double key) {
     union {
-        long long llval;
-        int parts[2];
-    } u = {key};
-    return u.parts[0] ^ u.parts[1];
+        double lfval;
+        uint64_t bits;
+    } u = {key == 0.0 ? 0.0 : key};
+    return Hashmap_hash_mix64(u.bits);
 }
 // --- Internal Helper Functions ---
-static int Hashmap_hash_uint64(unsigned long long key) { 
-    union {             
-        unsigned long long llval;
-        int parts[2];
-    } u = {key};
-    return u.parts[0] ^ u.parts[1];
+static inline uint64_t Hashmap_hash_pointer(void* key) {
+    return Hashmap_hash_mix64((uint64_t) (uintptr_t) key);
+}
+
+/**
+ * @brief 带密钥哈希 (keyed hash) 使用的 128 位种子。
+ *
+ * 每个通过 `HASHMAP_DEFINE_SEEDED` 系列宏定义的哈希表在创建时都会获得一个随机种子，
+ * 并将其传递给带密钥的哈希函数。
+ */
+typedef struct {
+    uint64_t k0;
+    uint64_t k1;
+} HashmapSeed;
+
+// --- Internal Macros ---
+#define __HASHMAP_ROTL(x, b) (uint64_t) (((x) << (b)) | ((x) >> (64 - (b))))
+// --- Internal Macros ---
+#define __HASHMAP_SIPROUND(v0, v1, v2, v3) do {                                                                     \
+    v0 += v1; v1 = __HASHMAP_ROTL(v1, 13); v1 ^= v0; v0 = __HASHMAP_ROTL(v0, 32);                                   \
+    v2 += v3; v3 = __HASHMAP_ROTL(v3, 16); v3 ^= v2;                                                                \
+    v0 += v3; v3 = __HASHMAP_ROTL(v3, 21); v3 ^= v0;                                                                \
+    v2 += v1; v1 = __HASHMAP_ROTL(v1, 17); v1 ^= v2; v2 = __HASHMAP_ROTL(v2, 32);                                   \
+} while (0)
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_siphash(const void* key, size_t len, const HashmapSeed* seed) {
+    const unsigned char* p = (const unsigned char*) key;
+    uint64_t v0 = 0x736f6d6570736575ULL ^ seed->k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ seed->k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ seed->k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ seed->k1;
+    const unsigned char* end = p + (len & ~(size_t) 7);
+    for (; p != end; p += 8) {
+        uint64_t m = Hashmap_read64(p);
+        v3 ^= m;
+        __HASHMAP_SIPROUND(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+    uint64_t b = (uint64_t) len << 56;
+    for (size_t i = 0; i < (len & 7); i++) {
+        b |= (uint64_t) p[i] << (8 * i);
+    }
+    v3 ^= b;
+    __HASHMAP_SIPROUND(v0, v1, v2, v3);
+    v0 ^= b;
+    v2 ^= 0xff;
+    __HASHMAP_SIPROUND(v0, v1, v2, v3);
+    __HASHMAP_SIPROUND(v0, v1, v2, v3);
+    __HASHMAP_SIPROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
 }
 // --- Internal Helper Functions ---
-static int Hashmap_hash_float64(double key) {
-    union {             
+static inline uint64_t Hashmap_siphash_uint64(uint64_t key, const HashmapSeed* seed) {
+    return Hashmap_siphash(&key, sizeof(key), seed);
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_siphash_float64(double key, const HashmapSeed* seed) {
+    union {
         double lfval;
-        int parts[2];
-    } u = {key};
-    return u.parts[0] ^ u.parts[1];
+        uint64_t bits;
+    } u = {key == 0.0 ? 0.0 : key};
+    return Hashmap_siphash_uint64(u.bits, seed);
+}
+// --- Internal Helper Functions ---
+#if defined(_WIN32)
+extern int __cdecl rand_s(unsigned int* random_value);
+#endif
+static inline void Hashmap_os_entropy(HashmapSeed* seed) {
+    uint64_t fallback = (uint64_t) (uintptr_t) seed ^ ((uint64_t) time(NULL) << 32) ^ (uint64_t) clock();
+    seed->k0 = Hashmap_hash_mix64(fallback);
+    seed->k1 = Hashmap_hash_mix64(seed->k0 ^ (uint64_t) (uintptr_t) &Hashmap_os_entropy);
+#if defined(_WIN32)
+    unsigned int words[4];
+    if (rand_s(&words[0]) == 0 && rand_s(&words[1]) == 0 && rand_s(&words[2]) == 0 && rand_s(&words[3]) == 0) {
+        seed->k0 ^= ((uint64_t) words[0] << 32) | words[1];
+        seed->k1 ^= ((uint64_t) words[2] << 32) | words[3];
+    }
+#else
+    FILE* urandom = fopen("/dev/urandom", "rb");
+    if (urandom != NULL) {
+        HashmapSeed random;
+        if (fread(&random, sizeof(random), 1, urandom) == 1) {
+            seed->k0 ^= random.k0;
+            seed->k1 ^= random.k1;
+        }
+        fclose(urandom);
+    }
+#endif
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_random_seed(HashmapSeed* seed) {
+    static HashmapSeed process_key;
+    static int initialized;
+    static uint64_t counter;
+    if (!__atomic_load_n(&initialized, __ATOMIC_ACQUIRE)) {
+        HashmapSeed key;
+        Hashmap_os_entropy(&key);
+        __atomic_store_n(&process_key.k0, key.k0, __ATOMIC_RELAXED);
+        __atomic_store_n(&process_key.k1, key.k1, __ATOMIC_RELAXED);
+        __atomic_store_n(&initialized, 1, __ATOMIC_RELEASE);
+    }
+    HashmapSeed key = {
+        __atomic_load_n(&process_key.k0, __ATOMIC_RELAXED),
+        __atomic_load_n(&process_key.k1, __ATOMIC_RELAXED)
+    };
+    uint64_t n = __atomic_fetch_add(&counter, 2, __ATOMIC_RELAXED);
+    seed->k0 = Hashmap_siphash_uint64(n, &key);
+    seed->k1 = Hashmap_siphash_uint64(n + 1, &key);
+}
+// --- Internal Helper Functions ---
+static inline int Hashmap_capacity_for(int n, float load_factor) {
+    int capacity = 16;
+    while (capacity * load_factor < n) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+// --- Internal Helper Functions ---
+static inline uint64_t* Hashmap_bitmap_new(int bits) {
+    return (uint64_t*) calloc((bits + 63) / 64, sizeof(uint64_t));
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_bitmap_set(uint64_t* bitmap, int index) {
+    bitmap[index >> 6] |= 1ULL << (index & 63);
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_bitmap_reset(uint64_t* bitmap, int index) {
+    bitmap[index >> 6] &= ~(1ULL << (index & 63));
+}
+// --- Internal Helper Functions ---
+static inline int Hashmap_bitmap_next(const uint64_t* bitmap, int bits, int index) {
+    if (index >= bits) {
+        return bits;
+    }
+    int word = index >> 6;
+    uint64_t mask = bitmap[word] & (~0ULL << (index & 63));
+    while (mask == 0) {
+        if (++word >= (bits + 63) / 64) {
+            return bits;
+        }
+        mask = bitmap[word];
+    }
+    return word * 64 + __builtin_ctzll(mask);
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_fastrange(uint64_t x, uint64_t range) {
+    Hashmap_mul128(&x, &range);
+    return range;
+}
+// --- Internal Helper Functions ---
+static inline int Hashmap_mph_slot(uint64_t hash, uint64_t salt, int pilot, int slots) {
+    return (int) Hashmap_fastrange(Hashmap_hash_mix64(hash ^ Hashmap_hash_mix64(salt + pilot)), slots);
+}
+// --- Internal Helper Functions ---
+static inline int Hashmap_mph_bucket(uint64_t hash, int buckets) {
+    // 60% 的键落入前 30% 的桶：大桶在表还空的时候先放置，尾部只剩下容易放置的小桶
+    int dense = (int) (buckets * 0.3);
+    if ((uint32_t) hash < (uint32_t) (0.6 * 4294967296.0)) {
+        return (int) Hashmap_fastrange(hash, dense);
+    }
+    return dense + (int) Hashmap_fastrange(hash, buckets - dense);
+}
+// --- Internal Helper Functions ---
+static inline bool Hashmap_mph_build(const uint64_t* hashes, int n, uint64_t salt, int buckets, int slots,
+                                     uint16_t* pilots, uint32_t* remap, int* positions) {
+    int* start = (int*) calloc(buckets + 1, sizeof(int));
+    int* members = (int*) malloc((n > 0 ? n : 1) * sizeof(int));
+    int* order = (int*) malloc(buckets * sizeof(int));
+    uint64_t* taken = Hashmap_bitmap_new(slots);
+    uint64_t* pilot_hashes = (uint64_t*) malloc((UINT16_MAX + 1) * sizeof(uint64_t));
+    for (int pilot = 0; pilot <= UINT16_MAX; pilot++) {
+        pilot_hashes[pilot] = Hashmap_hash_mix64(salt + pilot);
+    }
+    bool built = true;
+    int max_size = 0;
+    for (int i = 0; i < n; i++) {
+        start[Hashmap_mph_bucket(hashes[i], buckets) + 1]++;
+    }
+    for (int b = 0; b < buckets; b++) {
+        max_size = start[b + 1] > max_size ? start[b + 1] : max_size;
+        start[b + 1] += start[b];
+    }
+    int* fill = (int*) malloc((buckets > max_size + 2 ? buckets : max_size + 2) * sizeof(int));
+    memcpy(fill, start, buckets * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        members[fill[Hashmap_mph_bucket(hashes[i], buckets)]++] = i;
+    }
+    // 按桶大小从大到小排序：大桶在表还空的时候最容易找到可用的 pilot
+    memset(fill, 0, (max_size + 2) * sizeof(int));
+    for (int b = 0; b < buckets; b++) {
+        fill[max_size - (start[b + 1] - start[b]) + 1]++;
+    }
+    for (int s = 0; s <= max_size; s++) {
+        fill[s + 1] += fill[s];
+    }
+    for (int b = 0; b < buckets; b++) {
+        order[fill[max_size - (start[b + 1] - start[b])]++] = b;
+    }
+    for (int k = 0; k < buckets && built; k++) {
+        int b = order[k];
+        pilots[b] = 0;
+        for (int i = start[b]; i < start[b + 1] && built; i++) {
+            for (int j = start[b]; j < i; j++) {
+                if (hashes[members[i]] == hashes[members[j]]) {
+                    built = false;
+                }
+            }
+        }
+        int pilot = 0;
+        for (; built && start[b + 1] > start[b] && pilot <= UINT16_MAX; pilot++) {
+            int placed = 0;
+            for (int i = start[b]; i < start[b + 1]; i++, placed++) {
+                uint64_t mixed = Hashmap_hash_mix64(hashes[members[i]] ^ pilot_hashes[pilot]);
+                int slot = (int) Hashmap_fastrange(mixed, slots);
+                if (taken[slot >> 6] & (1ULL << (slot & 63))) {
+                    break;
+                }
+                Hashmap_bitmap_set(taken, slot);
+                positions[members[i]] = slot;
+            }
+            if (placed == start[b + 1] - start[b]) {
+                pilots[b] = (uint16_t) pilot;
+                break;
+            }
+            for (int i = start[b]; i < start[b] + placed; i++) {
+                Hashmap_bitmap_reset(taken, positions[members[i]]);
+            }
+        }
+        built = built && pilot <= UINT16_MAX;
+    }
+    // 落在 [n, slots) 的键被重映射到 [0, n) 中剩余的空槽位，使结果成为最小完美哈希
+    for (int slot = n, free_slot = 0; built && slot < slots; slot++) {
+        if (taken[slot >> 6] & (1ULL << (slot & 63))) {
+            while (taken[free_slot >> 6] & (1ULL << (free_slot & 63))) {
+                free_slot++;
+            }
+            remap[slot - n] = (uint32_t) free_slot++;
+        } else {
+            remap[slot - n] = 0;
+        }
+    }
+    for (int i = 0; built && i < n; i++) {
+        if (positions[i] >= n) {
+            positions[i] = (int) remap[positions[i] - n];
+        }
+    }
+    free(start);
+    free(members);
+    free(order);
+    free(fill);
+    free(taken);
+    free(pilot_hashes);
+    return built;
+}
+/**
+ * @brief 冻结哈希表快照文件头 (`hashmap_save` 写出，`hashmap_open_mmap` 读入)。
+ *
+ * 文件布局为：文件头，随后依次是 pilot 数组、重映射数组、键数组、值数组与字符串区，
+ * 每一段都按 64 字节对齐，段的位置以相对文件开头的偏移量记录，因此整个文件与加载地址无关，
+ * 映射到内存后即可直接使用。字符串键 (`cstr`) 的键数组存放的是字符串区中的偏移量，
+ * 字符串区中每个键按 `[uint32 长度][字节][\0]` 存放，偏移量指向字节部分。
+ * 所有整数按本机字节序存储。
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t flags;
+    uint64_t size;
+    uint64_t slots;
+    uint64_t buckets;
+    uint64_t salt;
+    HashmapSeed seed;
+    uint64_t pilots;
+    uint64_t remap;
+    uint64_t keys;
+    uint64_t values;
+    uint64_t strings;
+    uint64_t strings_size;
+} HashmapSnapshotHeader;
+
+// --- Internal Macros ---
+#define __HASHMAP_SNAPSHOT_MAGIC "COOPHMAP"
+// --- Internal Macros ---
+#define __HASHMAP_SNAPSHOT_VERSION 1u
+// --- Internal Macros ---
+#define __HASHMAP_SNAPSHOT_ALIGN 64u
+// --- Internal Macros ---
+#define __HASHMAP_SNAPSHOT_STRING_KEYS 1u
+// --- Internal Macros ---
+#define __HASHMAP_SNAPSHOT_SEEDED 2u
+// --- Internal Macros ---
+#define __HASHMAP_IS_STRING(T) _Generic((T*) 0, const char**: 1, char**: 1, default: 0)
+// --- Internal Macros ---
+#define __HASHMAP_SNAPSHOT_FLAGS(K, Seeded)                                                                         \
+    ((__HASHMAP_IS_STRING(K) ? __HASHMAP_SNAPSHOT_STRING_KEYS : 0u) | ((Seeded) ? __HASHMAP_SNAPSHOT_SEEDED : 0u))
+// --- Internal Macros ---
+#define __HASHMAP_STRING_OF(value) _Generic((value), const char*: (value), char*: (value), default: (const char*) "")
+
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_snapshot_align(uint64_t offset) {
+    return (offset + __HASHMAP_SNAPSHOT_ALIGN - 1) & ~(uint64_t) (__HASHMAP_SNAPSHOT_ALIGN - 1);
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_snapshot_layout(HashmapSnapshotHeader* header, uint64_t keys_size, uint64_t values_size) {
+    header->pilots = Hashmap_snapshot_align(sizeof(HashmapSnapshotHeader));
+    header->remap = Hashmap_snapshot_align(header->pilots + header->buckets * sizeof(uint16_t));
+    header->keys = Hashmap_snapshot_align(header->remap + (header->slots - header->size) * sizeof(uint32_t));
+    header->values = Hashmap_snapshot_align(header->keys + keys_size);
+    header->strings = Hashmap_snapshot_align(header->values + values_size);
+}
+// --- Internal Helper Functions ---
+static inline bool Hashmap_snapshot_write(FILE* file, uint64_t* position, uint64_t offset, const void* data,
+                                          uint64_t size) {
+    static const char padding[__HASHMAP_SNAPSHOT_ALIGN];
+    uint64_t gap = offset - *position;
+    if (gap > 0 && fwrite(padding, 1, gap, file) != gap) {
+        return false;
+    }
+    if (size > 0 && fwrite(data, 1, size, file) != size) {
+        return false;
+    }
+    *position = offset + size;
+    return true;
+}
+// --- Internal Helper Functions ---
+static inline bool Hashmap_snapshot_section_valid(uint64_t file_size, uint64_t offset, uint64_t count,
+                                                  uint64_t width) {
+    return offset % __HASHMAP_SNAPSHOT_ALIGN == 0 && offset <= file_size && count <= (file_size - offset) / width;
+}
+// --- Internal Helper Functions ---
+static inline bool Hashmap_snapshot_valid(const HashmapSnapshotHeader* header, uint64_t file_size,
+                                          uint32_t key_size, uint32_t value_size, uint32_t flags,
+                                          uint64_t key_width) {
+    if (file_size < sizeof(HashmapSnapshotHeader)
+        || memcmp(header->magic, __HASHMAP_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0
+        || header->version != __HASHMAP_SNAPSHOT_VERSION || header->key_size != key_size
+        || header->value_size != value_size || header->flags != flags || header->size > INT32_MAX
+        || header->slots <= header->size || header->slots > INT32_MAX || header->buckets == 0
+        || header->buckets > INT32_MAX) {
+        return false;
+    }
+    const char* data = (const char*) header;
+    if (!Hashmap_snapshot_section_valid(file_size, header->pilots, header->buckets, sizeof(uint16_t))
+        || !Hashmap_snapshot_section_valid(file_size, header->remap, header->slots - header->size, sizeof(uint32_t))
+        || !Hashmap_snapshot_section_valid(file_size, header->keys, header->size, key_width)
+        || !Hashmap_snapshot_section_valid(file_size, header->values, header->size, value_size > 0 ? value_size : 1)
+        || !Hashmap_snapshot_section_valid(file_size, header->strings, header->strings_size, 1)
+        || (header->strings_size > 0 && data[header->strings + header->strings_size - 1] != '\0')) {
+        return false;
+    }
+    return true;
+}
+// --- Internal Helper Functions ---
+static inline const char* Hashmap_snapshot_map(const char* path, size_t* size) {
+#if defined(_WIN32)
+    FILE* file = fopen(path, "rb");
+    char* data = NULL;
+    if (file != NULL && fseek(file, 0, SEEK_END) == 0) {
+        long length = ftell(file);
+        data = length > 0 ? (char*) malloc(length) : NULL;
+        if (data != NULL && (fseek(file, 0, SEEK_SET) != 0 || fread(data, 1, length, file) != (size_t) length)) {
+            free(data);
+            data = NULL;
+        }
+        *size = data != NULL ? (size_t) length : 0;
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+    return data;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    void* data = NULL;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        data = data == MAP_FAILED ? NULL : data;
+        *size = data != NULL ? (size_t) st.st_size : 0;
+    }
+    close(fd);
+    return (const char*) data;
+#endif
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_snapshot_unmap(const char* data, size_t size) {
+#if defined(_WIN32)
+    (void) size;
+    free((void*) data);
+#else
+    munmap((void*) data, size);
+#endif
+}
+
+// === 公共API: 编译期配置 ===
+
+/**
+ * @brief 是否启用渐进式扩容 (默认关闭)。
+ *
+ * 关闭时，链式哈希表在某一次 `hashmap_put` 中一次性把所有节点迁移到两倍大小的
+ * 桶数组。开启后 (在包含本头文件之前 `#define HASHMAP_INCREMENTAL_RESIZE 1`)，
+ * 扩容只分配新桶数组，新旧两个桶数组在迁移期间共存：此后每次 `hashmap_put` 与
+ * `hashmap_remove` 只迁移 `HASHMAP_INCREMENTAL_RESIZE_STEP` 个旧桶，
+ * `hashmap_get`、`hashmap_contains` 与迭代器会同时查询两个桶数组。
+ * 单次操作的最坏延迟因此不再随哈希表的大小增长。
+ */
+#ifndef HASHMAP_INCREMENTAL_RESIZE
+#define HASHMAP_INCREMENTAL_RESIZE 0
+#endif
+/**
+ * @brief 渐进式扩容时每次修改操作迁移的旧桶数量 (至少为 2，才能保证在下一次扩容前迁移完毕)。
+ */
+#ifndef HASHMAP_INCREMENTAL_RESIZE_STEP
+#define HASHMAP_INCREMENTAL_RESIZE_STEP 8
+#endif
+/**
+ * @brief 是否在删除后自动收缩 (默认关闭)。
+ *
+ * 开启后，当 `hashmap_remove` 使元素数量低于最大负载的 1/4 时，桶数组 (或槽位数组)
+ * 缩小一半，但不会小于默认容量 16。收缩后负载仍不到扩容阈值的一半，
+ * 因此不会在阈值附近反复扩容、收缩。任何时候也可以手动调用 `hashmap_shrink_to_fit`。
+ */
+#ifndef HASHMAP_AUTO_SHRINK
+#define HASHMAP_AUTO_SHRINK 0
+#endif
+/**
+ * @brief 链式哈希表不分配桶数组的最多条目数 (默认 8，设为 0 关闭)。
+ *
+ * 新建的哈希表不分配桶数组，不超过 N 个条目时全部串成一条链，查找时线性扫描；
+ * 插入第 N+1 个条目时才按当前元素数分配桶数组，把已有条目原样挂入各个桶，
+ * 之后与普通链式哈希表完全相同 (条目继续作为节点使用，地址不变)。
+ * 前几个条目取自哈希表头部内嵌的条目数组 (大小见 `HASHMAP_INLINE_BYTES`)，
+ * 其余条目取自第一个 slab，其容量等于内嵌条目数，因此 N 以内的小哈希表最多只有两次 `malloc`。
+ */
+#ifndef HASHMAP_INLINE_CAPACITY
+#define HASHMAP_INLINE_CAPACITY 8
+#endif
+/**
+ * @brief 链式哈希表内联条目数组的字节预算 (默认 96)。
+ *
+ * 内联数组无论是否用到都计入表头，按字节而非条目数限定其大小，实际内联
+ * `min(HASHMAP_INLINE_CAPACITY, HASHMAP_INLINE_BYTES / sizeof(条目))` 个条目：
+ * `hashmap(cstr, int)` 与 `hashmap(int, int)` 的条目均为 24 字节，各内联 4 个，表头 152 字节；
+ * 条目大于预算的类型 (如较大的结构体值) 不内联，表头不会因此膨胀。
+ */
+#ifndef HASHMAP_INLINE_BYTES
+#define HASHMAP_INLINE_BYTES 96
+#endif
+/**
+ * @brief 静态分派模式 (默认关闭，`#define COOP_STATIC_DISPATCH` 开启)。
+ *
+ * 默认情况下每个 `hashmap_*` 宏都经由 `(map)->fns` 间接调用，哈希表内部对哈希、
+ * 比较函数的调用也同样经过函数表，编译器通常无法内联。开启后：
+ * - 生成的实现直接引用本类型的静态函数表 `HASHMAP_KVFUNCTIONS`，
+ *   表是编译期常量，`HashFn`/`EqualsFn` 因而成为可内联的直接调用；
+ * - 列在 `COOP_HASHMAP_TYPES` 中的 `K, V` 组合，公共宏在编译期通过 `_Generic`
+ *   选中对应的静态函数表，同样变为直接调用。未列出的类型仍走 `(map)->fns`。
+ *
+ * 函数表本身保持不变，仍可用于多态用途。`COOP_HASHMAP_TYPES` 必须在包含本头文件之前定义，
+ * 其中列出的类型必须在第一次使用公共宏之前全部通过定义宏生成，且不能重复。
+ *
+ * @example
+ * #define COOP_STATIC_DISPATCH
+ * #define COOP_HASHMAP_TYPES(X) X(int, int) X(cstr, int)
+ * #include "hashmap.h"
+ */
+#ifndef COOP_HASHMAP_TYPES
+#define COOP_HASHMAP_TYPES(X)
+#endif
+/**
+ * @brief 静态分派模式下需要直接绑定的冻结哈希表类型列表，用法与 `COOP_HASHMAP_TYPES` 相同。
+ */
+#ifndef COOP_FROZEN_HASHMAP_TYPES
+#define COOP_FROZEN_HASHMAP_TYPES(X)
+#endif
+/**
+ * @brief 是否启用累计查找计数器 (默认关闭)。
+ *
+ * 开启后 (在包含本头文件之前 `#define HASHMAP_STATS_COUNTERS 1`)，每个哈希表累计按键查找的次数
+ * (`hashmap_get`、`hashmap_put`、`hashmap_remove` 等内部的查找都计入)、探测次数与 `equals` 调用次数，
+ * 通过 `hashmap_stats` 读取。关闭时计数代码在编译期被消除，表头也不包含计数器字段，没有任何运行时与内存开销。
+ */
+#ifndef HASHMAP_STATS_COUNTERS
+#define HASHMAP_STATS_COUNTERS 0
+#endif
+
+// === 公共API: 统计信息 ===
+
+/**
+ * @brief 链长分布直方图的长度：第 i 项 (i < 15) 为恰好有 i 个键落入的桶数，最后一项汇总 15 个及以上。
+ */
+#define HASHMAP_STATS_HISTOGRAM_SIZE 16
+
+/**
+ * @brief 累计查找计数器，仅在 `HASHMAP_STATS_COUNTERS` 开启时递增。
+ *
+ * `probes` 的单位随后端而定：链式哈希表为检查过的节点数，开放寻址为检查过的槽位数，
+ * 分组探测为检查过的控制字节组数。`probes / lookups` 即平均每次查找的探测次数。
+ */
+typedef struct {
+    uint64_t lookups;
+    uint64_t probes;
+    uint64_t equals_calls;
+} HashmapCounters;
+
+/**
+ * @brief 哈希表的健康状况快照，由 `hashmap_stats` 填充。
+ *
+ * 所有后端都按 "落入同一个桶的键" 统计链长：链式哈希表即每条链的长度；
+ * 开放寻址与分组探测按每个键的初始探测位置归入对应的桶，因此链长分布、`max_chain`
+ * 与 `empty_bucket_ratio` 反映的是哈希函数本身的分布质量，与冲突的解决方式无关。
+ * 链式哈希表尚处于内联存储阶段 (未分配桶数组) 时，全部条目视为同一个桶。
+ * 对均匀的哈希函数，`empty_bucket_ratio` 约为 e^(-load_factor)，明显偏高说明键发生了聚集。
+ */
+typedef struct {
+    int size;                       // 键值对数量
+    int bucket_count;               // 桶 (槽位) 数量；渐进式扩容期间包括新旧两个桶数组
+    double load_factor;             // size / bucket_count
+    double empty_bucket_ratio;      // 没有任何键落入的桶所占的比例
+    int chain_histogram[HASHMAP_STATS_HISTOGRAM_SIZE];
+    int max_chain;                  // 落入同一个桶的最多键数
+    int max_probe;                  // 找到任意一个已有键所需的最多探测次数，单位同 HashmapCounters.probes
+    int resize_count;               // 桶数组重新分配并迁移条目的次数 (不含第一次分配)
+    size_t total_bytes;             // 表头、桶数组、条目等全部分配的字节数
+    HashmapCounters counters;       // 累计计数器，未开启 HASHMAP_STATS_COUNTERS 时全为 0
+} HashmapStats;
+
+// --- Internal Helper Functions ---
+static inline void Hashmap_stats_add_chain(HashmapStats* stats, int length) {
+    stats->bucket_count++;
+    stats->chain_histogram[length < HASHMAP_STATS_HISTOGRAM_SIZE - 1 ? length : HASHMAP_STATS_HISTOGRAM_SIZE - 1]++;
+    if (length > stats->max_chain) {
+        stats->max_chain = length;
+    }
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_stats_finish(HashmapStats* stats) {
+    if (stats->bucket_count > 0) {
+        stats->load_factor = (double) stats->size / stats->bucket_count;
+        stats->empty_bucket_ratio = (double) stats->chain_histogram[0] / stats->bucket_count;
+    }
 }
 // --- Internal Helper Functions ---
-static int Hashmap_hash_pointer(void* key) {
-    union {             
-        void* ptr;
-        int parts[2];
-    } u = {key};
-    return u.parts[0] ^ u.parts[1];
+// 开放寻址与分组探测共用：homes[i] 为初始探测位置为 i 的键数
+static inline void Hashmap_stats_add_homes(HashmapStats* stats, const uint16_t* homes, int capacity) {
+    for (int i = 0; i < capacity; i++) {
+        Hashmap_stats_add_chain(stats, homes[i]);
+    }
 }
+
 // --- Internal Macros ---
 #define __HASHMAP_LOAD_FACTOR 0.75f
 // --- Internal Macros ---
+#define __HASHMAP_SLAB_MIN_ENTRIES 8
+// --- Internal Macros ---
+#define __HASHMAP_SLAB_MAX_ENTRIES 8192
+// --- Internal Macros ---
+#define __HASHMAP_BATCH_SIZE 32
+// --- Internal Macros ---
+#define __HASHMAP_MPH_BUCKET_SIZE 5
+// --- Internal Macros ---
+#define __HASHMAP_INLINE_ENTRIES(K, V)                                                                              \
+    (HASHMAP_INLINE_BYTES / sizeof(struct HashmapEntry_##K##_##V) < HASHMAP_INLINE_CAPACITY                         \
+         ? (int) (HASHMAP_INLINE_BYTES / sizeof(struct HashmapEntry_##K##_##V))                                     \
+         : (int) HASHMAP_INLINE_CAPACITY)
+// --- Internal Macros ---
+// 链式哈希表的占用位图紧跟在桶数组之后，与之共用一次分配
+#define __HASHMAP_OCCUPIED(entries, capacity) ((uint64_t*) ((entries) + (capacity)))
+// --- Internal Macros ---
+// 只有带密钥的哈希表才包含 seed 字段，Seeded 必须是字面量 0 或 1
+#define __HASHMAP_SEED_FIELD(Seeded) __HASHMAP_SEED_FIELD_##Seeded
+#define __HASHMAP_SEED_FIELD_0
+#define __HASHMAP_SEED_FIELD_1 HashmapSeed seed;
+// --- Internal Macros ---
+#define __HASHMAP_SEED(self, Seeded) __HASHMAP_SEED_##Seeded(self)
+#define __HASHMAP_SEED_0(self) (&(HashmapSeed) {0, 0})
+#define __HASHMAP_SEED_1(self) (&(self)->seed)
+// --- Internal Macros ---
+#define __HASHMAP_SEED_INIT(self, Seeded) __HASHMAP_SEED_INIT_##Seeded(self)
+#define __HASHMAP_SEED_INIT_0(self) ((void) 0)
+#define __HASHMAP_SEED_INIT_1(self) Hashmap_random_seed(&(self)->seed)
+// --- Internal Macros ---
+#define __HASHMAP_HASH(self, K, V, Seeded, key)                                                                     \
+    ((Seeded) ? __HASHMAP_VTABLE(self, K, V)->keyed_hash((key), __HASHMAP_SEED(self, Seeded))                       \
+              : __HASHMAP_VTABLE(self, K, V)->hash(key))
+#if HASHMAP_STATS_COUNTERS
+// --- Internal Macros ---
+#define __HASHMAP_COUNTERS_FIELD HashmapCounters counters;
+// --- Internal Macros ---
+#define __HASHMAP_COUNTERS(self) ((self)->counters)
+// --- Internal Macros ---
+#define __HASHMAP_COUNTERS_RESET(self) ((self)->counters = (HashmapCounters) {0, 0, 0})
+// --- Internal Macros ---
+#define __HASHMAP_COUNT(self, field) ((void) (self)->counters.field++)
+#else
+// --- Internal Macros ---
+#define __HASHMAP_COUNTERS_FIELD
+// --- Internal Macros ---
+#define __HASHMAP_COUNTERS(self) ((HashmapCounters) {0, 0, 0})
+// --- Internal Macros ---
+#define __HASHMAP_COUNTERS_RESET(self) ((void) 0)
+// --- Internal Macros ---
+#define __HASHMAP_COUNT(self, field) ((void) 0)
+#endif
+#if HASHMAP_INCREMENTAL_RESIZE
+// --- Internal Macros ---
+// 旧桶数组及迁移进度只在开启渐进式扩容时存在；关闭时访问宏返回空值，写入旧桶数组的函数为空实现
+#define __HASHMAP_RESIZE_FIELDS(K, V)                                                                               \
+    struct HashmapEntry_##K##_##V** old_entries;                                                                    \
+    int old_capacity;                                                                                               \
+    int migrate_index;
+// --- Internal Macros ---
+#define __HASHMAP_OLD_ENTRIES(self) ((self)->old_entries)
+// --- Internal Macros ---
+#define __HASHMAP_OLD_CAPACITY(self) ((self)->old_capacity)
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_INCREMENTAL(K, V)                                                                          \
+static void Hashmap_##K##_##V##_reset_old(Hashmap_##K##_##V* self) {                                                \
+    self->old_entries = NULL;                                                                                       \
+    self->old_capacity = 0;                                                                                         \
+    self->migrate_index = 0;                                                                                        \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_retire_buckets(Hashmap_##K##_##V* self) {                                           \
+    self->old_entries = self->entries;                                                                              \
+    self->old_capacity = self->capacity;                                                                            \
+    self->migrate_index = 0;                                                                                        \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_migrate(Hashmap_##K##_##V* self, int buckets) {                                     \
+    while (buckets-- > 0 && self->old_entries != NULL) {                                                            \
+        Hashmap_##K##_##V##_relink(self, self->old_entries[self->migrate_index]);                                   \
+        self->old_entries[self->migrate_index] = NULL;                                                              \
+        Hashmap_bitmap_reset(__HASHMAP_OCCUPIED(self->old_entries, self->old_capacity), self->migrate_index);       \
+        if (++self->migrate_index == self->old_capacity) {                                                          \
+            Hashmap_##K##_##V##_free_buckets(self->old_entries, self->old_capacity);                                \
+            Hashmap_##K##_##V##_reset_old(self);                                                                    \
+        }                                                                                                           \
+    }                                                                                                               \
+}
+#else
+// --- Internal Macros ---
+#define __HASHMAP_RESIZE_FIELDS(K, V)
+// --- Internal Macros ---
+#define __HASHMAP_OLD_ENTRIES(self) ((typeof((self)->entries)) NULL)
+// --- Internal Macros ---
+#define __HASHMAP_OLD_CAPACITY(self) 0
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_INCREMENTAL(K, V)                                                                          \
+static void Hashmap_##K##_##V##_reset_old(Hashmap_##K##_##V* self) {                                                \
+    (void) self;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_retire_buckets(Hashmap_##K##_##V* self) {                                           \
+    (void) self;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_migrate(Hashmap_##K##_##V* self, int buckets) {                                     \
+    (void) self;                                                                                                    \
+    (void) buckets;                                                                                                 \
+}
+#endif
+// --- Internal Macros ---
+#define __HASHMAP_KEY_EQUALS(self, K, V, key1, key2)                                                                \
+    (__HASHMAP_COUNT(self, equals_calls), __HASHMAP_VTABLE(self, K, V)->equals((key1), (key2)))
+#ifdef COOP_STATIC_DISPATCH
+// --- Internal Macros ---
+#define __HASHMAP_VTABLE(self, K, V) (&HASHMAP_##K##V##FUNCTIONS)
+// --- Internal Macros ---
+#define __HASHMAP_FNS_CASE(K, V) Hashmap_##K##_##V*: &HASHMAP_##K##V##FUNCTIONS,
+// --- Internal Macros ---
+#define __HASHMAP_FNS(map) _Generic((map), COOP_HASHMAP_TYPES(__HASHMAP_FNS_CASE) default: (map)->fns)
+// --- Internal Macros ---
+#define __FROZEN_HASHMAP_FNS_CASE(K, V) FrozenHashmap_##K##_##V*: &FROZEN_HASHMAP_##K##V##FUNCTIONS,
+// --- Internal Macros ---
+#define __FROZEN_HASHMAP_FNS(map)                                                                                   \
+    _Generic((map), COOP_FROZEN_HASHMAP_TYPES(__FROZEN_HASHMAP_FNS_CASE) default: (map)->fns)
+#else
+// --- Internal Macros ---
+#define __HASHMAP_VTABLE(self, K, V) ((self)->fns)
+// --- Internal Macros ---
+#define __HASHMAP_FNS(map) (map)->fns
+// --- Internal Macros ---
+#define __FROZEN_HASHMAP_FNS(map) (map)->fns
+#endif
+// --- Internal Macros ---
 #define __HASHMAP_DISPLAY_ELEMENT(stream, e)                                                                        \
 _Generic(e,                                                                                                         \
     bool: fprintf(stream, "%s", e ? "true" : "false"),                                                              \
@@ -82,6 +843,374 @@ _Generic(e,
     default: fprintf(stream, "0x%p", e)                                                                             \
 );                                                                                                                  \
 
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_DEFAULT_KEY_FUNCTIONS(Name, K)                                                             \
+static uint64_t Name##_hash(K key) {                                                                                \
+    union {                                                                                                         \
+        K k;                                                                                                        \
+        bool bval;                                                                                                  \
+        signed char cval;                                                                                           \
+        short sval;                                                                                                 \
+        int ival;                                                                                                   \
+        long lval;                                                                                                  \
+        long long llval;                                                                                            \
+        unsigned char ucval;                                                                                        \
+        unsigned short usval;                                                                                       \
+        unsigned int uval;                                                                                          \
+        unsigned long ulval;                                                                                        \
+        unsigned long long ullval;                                                                                  \
+        float fval;                                                                                                 \
+        double lfval;                                                                                               \
+        long double ldval;                                                                                          \
+        const char* strval;                                                                                         \
+        void* ptrval;                                                                                               \
+    } u = {key};                                                                                                    \
+    return _Generic(key,                                                                                            \
+        bool: Hashmap_hash_uint64(u.bval),                                                                          \
+        char: Hashmap_hash_int64(u.cval),                                                                           \
+        short: Hashmap_hash_int64(u.sval),                                                                          \
+        int: Hashmap_hash_int64(u.ival),                                                                            \
+        long: Hashmap_hash_int64(u.lval),                                                                           \
+        long long: Hashmap_hash_int64(u.llval),                                                                     \
+        unsigned char: Hashmap_hash_uint64(u.ucval),                                                                \
+        unsigned short: Hashmap_hash_uint64(u.usval),                                                               \
+        unsigned int: Hashmap_hash_uint64(u.uval),                                                                  \
+        unsigned long: Hashmap_hash_uint64(u.ulval),                                                                \
+        unsigned long long: Hashmap_hash_uint64(u.ullval),                                                          \
+        float: Hashmap_hash_float64(u.fval),                                                                        \
+        double: Hashmap_hash_float64(u.lfval),                                                                      \
+        long double: Hashmap_hash_float64((double) u.ldval),                                                        \
+        const char*: Hashmap_hash_cstr(u.strval),                                                                   \
+        default: Hashmap_hash_pointer(u.ptrval)                                                                     \
+    );                                                                                                              \
+}                                                                                                                   \
+static bool Name##_equals(K key1, K key2) {                                                                         \
+    union { K k; const char* strval; } u1 = {key1};                                                                 \
+    union { K k; const char* strval; } u2 = {key2};                                                                 \
+    return _Generic(key1,                                                                                           \
+        const char*: strcmp(u1.strval, u2.strval) == 0,                                                             \
+        default: u1.k == u2.k                                                                                       \
+    );                                                                                                              \
+}                                                                                                                   \
+static void Name##_key_display(FILE* stream, K key) {                                                               \
+    __HASHMAP_DISPLAY_ELEMENT(stream, key);                                                                         \
+}
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_DEFAULT_FUNCTIONS(Prefix, K, V)                                                            \
+__HASHMAP_DEFINE_DEFAULT_KEY_FUNCTIONS(Prefix##_##K##_##V, K)                                                       \
+static void Prefix##_##K##_##V##_value_display(FILE* stream, V value) {                                             \
+    __HASHMAP_DISPLAY_ELEMENT(stream, value);                                                                       \
+}
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_DEFAULT_KEYED_HASH(K, V)                                                                   \
+static uint64_t Hashmap_##K##_##V##_keyed_hash(K key, const HashmapSeed* seed) {                                    \
+    union {                                                                                                         \
+        K k;                                                                                                        \
+        bool bval;                                                                                                  \
+        signed char cval;                                                                                           \
+        short sval;                                                                                                 \
+        int ival;                                                                                                   \
+        long lval;                                                                                                  \
+        long long llval;                                                                                            \
+        unsigned char ucval;                                                                                        \
+        unsigned short usval;                                                                                       \
+        unsigned int uval;                                                                                          \
+        unsigned long ulval;                                                                                        \
+        unsigned long long ullval;                                                                                  \
+        float fval;                                                                                                 \
+        double lfval;                                                                                               \
+        long double ldval;                                                                                          \
+        const char* strval;                                                                                         \
+        void* ptrval;                                                                                               \
+    } u = {key};                                                                                                    \
+    return _Generic(key,                                                                                            \
+        bool: Hashmap_siphash_uint64(u.bval, seed),                                                                 \
+        char: Hashmap_siphash_uint64((uint64_t) u.cval, seed),                                                      \
+        short: Hashmap_siphash_uint64((uint64_t) u.sval, seed),                                                     \
+        int: Hashmap_siphash_uint64((uint64_t) u.ival, seed),                                                       \
+        long: Hashmap_siphash_uint64((uint64_t) u.lval, seed),                                                      \
+        long long: Hashmap_siphash_uint64((uint64_t) u.llval, seed),                                                \
+        unsigned char: Hashmap_siphash_uint64(u.ucval, seed),                                                       \
+        unsigned short: Hashmap_siphash_uint64(u.usval, seed),                                                      \
+        unsigned int: Hashmap_siphash_uint64(u.uval, seed),                                                         \
+        unsigned long: Hashmap_siphash_uint64(u.ulval, seed),                                                       \
+        unsigned long long: Hashmap_siphash_uint64(u.ullval, seed),                                                 \
+        float: Hashmap_siphash_float64(u.fval, seed),                                                               \
+        double: Hashmap_siphash_float64(u.lfval, seed),                                                             \
+        long double: Hashmap_siphash_float64((double) u.ldval, seed),                                               \
+        const char*: Hashmap_siphash(u.strval, strlen(u.strval), seed),                                             \
+        default: Hashmap_siphash_uint64((uint64_t) (uintptr_t) u.ptrval, seed)                                      \
+    );                                                                                                              \
+}
+
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_MERGE(K, V)                                                                                \
+static void Hashmap_##K##_##V##_merge_into(                                                                         \
+    Hashmap_##K##_##V* self, Hashmap_##K##_##V* other, void (*combine)(V* value, V other_value)) {                  \
+    Hashmap_##K##_##V##_reserve(self, self->size > other->size ? self->size : other->size);                         \
+    struct HashmapIterator_##K##_##V iter = Hashmap_##K##_##V##_get_iterator(other);                                \
+    while (Hashmap_##K##_##V##_iterator_next(&iter)) {                                                              \
+        const V* other_value = Hashmap_##K##_##V##_iterator_current_value(&iter);                                   \
+        bool inserted;                                                                                              \
+        V* value = Hashmap_##K##_##V##_get_or_insert(                                                               \
+            self, *Hashmap_##K##_##V##_iterator_current_key(&iter), *other_value, &inserted);                       \
+        if (!inserted) {                                                                                            \
+            if (combine != NULL) {                                                                                  \
+                combine(value, *other_value);                                                                       \
+            } else {                                                                                                \
+                *value = *other_value;                                                                              \
+            }                                                                                                       \
+        }                                                                                                           \
+    }                                                                                                               \
+}
+
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_FROZEN(K, V, Seeded)                                                                       \
+struct FrozenHashmap_##K##_##V##_Functions {                                                                        \
+    void (*display)(FrozenHashmap_##K##_##V* self, FILE* stream);                                                   \
+    const V* (*get)(FrozenHashmap_##K##_##V* self, K key);                                                          \
+    bool (*contains)(FrozenHashmap_##K##_##V* self, K key);                                                         \
+    K (*key_at)(FrozenHashmap_##K##_##V* self, int index);                                                          \
+    bool (*save)(FrozenHashmap_##K##_##V* self, const char* path);                                                  \
+    void (*free)(FrozenHashmap_##K##_##V* self);                                                                    \
+};                                                                                                                  \
+                                                                                                                    \
+struct __FrozenHashmap_##K##_##V {                                                                                  \
+    const struct FrozenHashmap_##K##_##V##_Functions* fns;                                                          \
+    int size;                                                                                                       \
+    int slots;                                                                                                      \
+    int buckets;                                                                                                    \
+    uint64_t salt;                                                                                                  \
+    HashmapSeed seed;                                                                                               \
+    uint16_t* pilots;                                                                                               \
+    uint32_t* remap;                                                                                                \
+    K* keys;                                                                                                        \
+    V* values;                                                                                                      \
+    const uint64_t* key_offsets;                                                                                    \
+    const char* strings;                                                                                            \
+    uint64_t strings_size;                                                                                          \
+    const char* mapping;                                                                                            \
+    size_t mapping_size;                                                                                            \
+};                                                                                                                  \
+                                                                                                                    \
+static uint64_t FrozenHashmap_##K##_##V##_hash(FrozenHashmap_##K##_##V* self, K key) {                              \
+    return (Seeded) ? HASHMAP_##K##V##FUNCTIONS.keyed_hash(key, &self->seed) : HASHMAP_##K##V##FUNCTIONS.hash(key); \
+}                                                                                                                   \
+                                                                                                                    \
+static bool FrozenHashmap_##K##_##V##_key_valid(FrozenHashmap_##K##_##V* self, int index) {                         \
+    return self->key_offsets == NULL || self->key_offsets[index] < self->strings_size;                              \
+}                                                                                                                   \
+                                                                                                                    \
+static K FrozenHashmap_##K##_##V##_key_at(FrozenHashmap_##K##_##V* self, int index) {                               \
+    if (self->key_offsets == NULL) {                                                                                \
+        return self->keys[index];                                                                                   \
+    }                                                                                                               \
+    union { K key; const char* string; } key;                                                                       \
+    key.string = FrozenHashmap_##K##_##V##_key_valid(self, index) ? self->strings + self->key_offsets[index] : "";  \
+    return key.key;                                                                                                 \
+}                                                                                                                   \
+                                                                                                                    \
+static void FrozenHashmap_##K##_##V##_display(FrozenHashmap_##K##_##V* self, FILE* stream) {                        \
+    fprintf(stream, "{");                                                                                           \
+    for (int i = 0; i < self->size; i++) {                                                                          \
+        HASHMAP_##K##V##FUNCTIONS.display_key(stream, FrozenHashmap_##K##_##V##_key_at(self, i));                   \
+        fprintf(stream, ": ");                                                                                      \
+        HASHMAP_##K##V##FUNCTIONS.display_value(stream, self->values[i]);                                           \
+        if (i < self->size - 1) {                                                                                   \
+            fprintf(stream, ", ");                                                                                  \
+        }                                                                                                           \
+    }                                                                                                               \
+    fprintf(stream, "}");                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static const V* FrozenHashmap_##K##_##V##_get(FrozenHashmap_##K##_##V* self, K key) {                               \
+    if (self->size == 0) {                                                                                          \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    uint64_t hash = FrozenHashmap_##K##_##V##_hash(self, key);                                                      \
+    int pilot = self->pilots[Hashmap_mph_bucket(hash, self->buckets)];                                              \
+    int slot = Hashmap_mph_slot(hash, self->salt, pilot, self->slots);                                              \
+    if (slot >= self->size) {                                                                                       \
+        uint32_t target = self->remap[slot - self->size];                                                           \
+        if (target >= (uint32_t) self->size) {                                                                      \
+            return NULL;                                                                                            \
+        }                                                                                                           \
+        slot = (int) target;                                                                                        \
+    }                                                                                                               \
+    if (!FrozenHashmap_##K##_##V##_key_valid(self, slot)) {                                                         \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    return HASHMAP_##K##V##FUNCTIONS.equals(FrozenHashmap_##K##_##V##_key_at(self, slot), key)                      \
+               ? &self->values[slot] : NULL;                                                                        \
+}                                                                                                                   \
+                                                                                                                    \
+static bool FrozenHashmap_##K##_##V##_contains(FrozenHashmap_##K##_##V* self, K key) {                              \
+    return FrozenHashmap_##K##_##V##_get(self, key) != NULL;                                                        \
+}                                                                                                                   \
+                                                                                                                    \
+static bool FrozenHashmap_##K##_##V##_save(FrozenHashmap_##K##_##V* self, const char* path) {                       \
+    bool string_keys = __HASHMAP_IS_STRING(K);                                                                      \
+    if (__HASHMAP_IS_STRING(V)) {                                                                                   \
+        return false;                                                                                               \
+    }                                                                                                               \
+    HashmapSnapshotHeader header;                                                                                   \
+    memset(&header, 0, sizeof(header));                                                                             \
+    memcpy(header.magic, __HASHMAP_SNAPSHOT_MAGIC, sizeof(header.magic));                                           \
+    header.version = __HASHMAP_SNAPSHOT_VERSION;                                                                    \
+    header.key_size = sizeof(K);                                                                                    \
+    header.value_size = sizeof(V);                                                                                  \
+    header.flags = __HASHMAP_SNAPSHOT_FLAGS(K, Seeded);                                                             \
+    header.size = self->size;                                                                                       \
+    header.slots = self->slots;                                                                                     \
+    header.buckets = self->buckets;                                                                                 \
+    header.salt = self->salt;                                                                                       \
+    header.seed = self->seed;                                                                                       \
+    int n = self->size;                                                                                             \
+    uint64_t* offsets = NULL;                                                                                       \
+    char* strings = NULL;                                                                                           \
+    if (string_keys) {                                                                                              \
+        offsets = (uint64_t*) malloc((n > 0 ? n : 1) * sizeof(uint64_t));                                           \
+        for (int i = 0; i < n; i++) {                                                                               \
+            offsets[i] = strlen(__HASHMAP_STRING_OF(FrozenHashmap_##K##_##V##_key_at(self, i)));                    \
+            header.strings_size += sizeof(uint32_t) + offsets[i] + 1;                                               \
+        }                                                                                                           \
+        strings = (char*) malloc(header.strings_size > 0 ? header.strings_size : 1);                                \
+        for (uint64_t i = 0, position = 0; i < (uint64_t) n; i++) {                                                 \
+            uint32_t length = (uint32_t) offsets[i];                                                                \
+            memcpy(strings + position, &length, sizeof(length));                                                    \
+            offsets[i] = position + sizeof(length);                                                                 \
+            const char* key = __HASHMAP_STRING_OF(FrozenHashmap_##K##_##V##_key_at(self, i));                       \
+            memcpy(strings + offsets[i], key, length + 1);                                                          \
+            position = offsets[i] + length + 1;                                                                     \
+        }                                                                                                           \
+    }                                                                                                               \
+    uint64_t keys_size = (uint64_t) n * (string_keys ? sizeof(uint64_t) : sizeof(K));                               \
+    Hashmap_snapshot_layout(&header, keys_size, (uint64_t) n * sizeof(V));                                          \
+    FILE* file = fopen(path, "wb");                                                                                 \
+    uint64_t position = 0;                                                                                          \
+    bool saved = file != NULL                                                                                       \
+        && Hashmap_snapshot_write(file, &position, 0, &header, sizeof(header))                                      \
+        && Hashmap_snapshot_write(file, &position, header.pilots, self->pilots, header.buckets * sizeof(uint16_t))  \
+        && Hashmap_snapshot_write(file, &position, header.remap, self->remap,                                       \
+                                  (header.slots - header.size) * sizeof(uint32_t))                                  \
+        && Hashmap_snapshot_write(file, &position, header.keys, string_keys ? (const void*) offsets                 \
+                                  : (const void*) self->keys, keys_size)                                            \
+        && Hashmap_snapshot_write(file, &position, header.values, self->values, (uint64_t) n * sizeof(V))           \
+        && Hashmap_snapshot_write(file, &position, header.strings, string_keys ? strings : "",                      \
+                                  header.strings_size);                                                             \
+    if (file != NULL && fclose(file) != 0) {                                                                        \
+        saved = false;                                                                                              \
+    }                                                                                                               \
+    free(offsets);                                                                                                  \
+    free(strings);                                                                                                  \
+    return saved;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static void FrozenHashmap_##K##_##V##_free(FrozenHashmap_##K##_##V* self) {                                         \
+    if (self->mapping != NULL) {                                                                                    \
+        Hashmap_snapshot_unmap(self->mapping, self->mapping_size);                                                  \
+    } else {                                                                                                        \
+        free(self->pilots);                                                                                         \
+        free(self->remap);                                                                                          \
+        free(self->keys);                                                                                           \
+        free(self->values);                                                                                         \
+    }                                                                                                               \
+    free(self);                                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+const static struct FrozenHashmap_##K##_##V##_Functions FROZEN_HASHMAP_##K##V##FUNCTIONS = {                        \
+    .display = FrozenHashmap_##K##_##V##_display,                                                                   \
+    .get = FrozenHashmap_##K##_##V##_get,                                                                           \
+    .contains = FrozenHashmap_##K##_##V##_contains,                                                                 \
+    .key_at = FrozenHashmap_##K##_##V##_key_at,                                                                     \
+    .save = FrozenHashmap_##K##_##V##_save,                                                                         \
+    .free = FrozenHashmap_##K##_##V##_free,                                                                         \
+};                                                                                                                  \
+                                                                                                                    \
+static inline FrozenHashmap_##K##_##V* FrozenHashmap_##K##_##V##_open_mmap(const char* path) {                      \
+    bool string_keys = __HASHMAP_IS_STRING(K);                                                                      \
+    uint32_t flags = __HASHMAP_SNAPSHOT_FLAGS(K, Seeded);                                                           \
+    size_t size = 0;                                                                                                \
+    const char* data = Hashmap_snapshot_map(path, &size);                                                           \
+    const HashmapSnapshotHeader* header = (const HashmapSnapshotHeader*) data;                                      \
+    if (data == NULL || !Hashmap_snapshot_valid(header, size, sizeof(K), sizeof(V), flags,                          \
+                                                string_keys ? sizeof(uint64_t) : sizeof(K))) {                      \
+        if (data != NULL) {                                                                                         \
+            Hashmap_snapshot_unmap(data, size);                                                                     \
+        }                                                                                                           \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    FrozenHashmap_##K##_##V* frozen = (FrozenHashmap_##K##_##V*) malloc(sizeof(FrozenHashmap_##K##_##V));           \
+    frozen->fns = &FROZEN_HASHMAP_##K##V##FUNCTIONS;                                                                \
+    frozen->size = (int) header->size;                                                                              \
+    frozen->slots = (int) header->slots;                                                                            \
+    frozen->buckets = (int) header->buckets;                                                                        \
+    frozen->salt = header->salt;                                                                                    \
+    frozen->seed = header->seed;                                                                                    \
+    frozen->pilots = (uint16_t*) (data + header->pilots);                                                           \
+    frozen->remap = (uint32_t*) (data + header->remap);                                                             \
+    frozen->keys = string_keys ? NULL : (K*) (data + header->keys);                                                 \
+    frozen->values = (V*) (data + header->values);                                                                  \
+    frozen->key_offsets = string_keys ? (const uint64_t*) (data + header->keys) : NULL;                             \
+    frozen->strings = data + header->strings;                                                                       \
+    frozen->strings_size = header->strings_size;                                                                    \
+    frozen->mapping = data;                                                                                         \
+    frozen->mapping_size = size;                                                                                    \
+    return frozen;                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static FrozenHashmap_##K##_##V* Hashmap_##K##_##V##_freeze(Hashmap_##K##_##V* self) {                               \
+    int n = self->size;                                                                                             \
+    FrozenHashmap_##K##_##V* frozen = (FrozenHashmap_##K##_##V*) malloc(sizeof(FrozenHashmap_##K##_##V));           \
+    frozen->fns = &FROZEN_HASHMAP_##K##V##FUNCTIONS;                                                                \
+    frozen->size = n;                                                                                               \
+    frozen->slots = n + n / 49 + 1;                                                                                 \
+    frozen->buckets = n / __HASHMAP_MPH_BUCKET_SIZE + 1;                                                            \
+    frozen->seed = *__HASHMAP_SEED(self, Seeded);                                                                   \
+    frozen->pilots = (uint16_t*) malloc(frozen->buckets * sizeof(uint16_t));                                        \
+    frozen->remap = (uint32_t*) malloc((frozen->slots - n) * sizeof(uint32_t));                                     \
+    frozen->keys = (K*) malloc((n > 0 ? n : 1) * sizeof(K));                                                        \
+    frozen->values = (V*) malloc((n > 0 ? n : 1) * sizeof(V));                                                      \
+    frozen->key_offsets = NULL;                                                                                     \
+    frozen->strings = NULL;                                                                                         \
+    frozen->strings_size = 0;                                                                                       \
+    frozen->mapping = NULL;                                                                                         \
+    frozen->mapping_size = 0;                                                                                       \
+    uint64_t* hashes = (uint64_t*) malloc((n > 0 ? n : 1) * sizeof(uint64_t));                                      \
+    int* positions = (int*) malloc((n > 0 ? n : 1) * sizeof(int));                                                  \
+    struct HashmapIterator_##K##_##V iter = Hashmap_##K##_##V##_get_iterator(self);                                 \
+    for (int i = 0; Hashmap_##K##_##V##_iterator_next(&iter); i++) {                                                \
+        hashes[i] = FrozenHashmap_##K##_##V##_hash(frozen, *Hashmap_##K##_##V##_iterator_current_key(&iter));       \
+    }                                                                                                               \
+    bool built = false;                                                                                             \
+    for (uint64_t attempt = 1; attempt <= 4 && !built; attempt++) {                                                 \
+        frozen->salt = Hashmap_hash_mix64(attempt);                                                                 \
+        built = Hashmap_mph_build(hashes, n, frozen->salt, frozen->buckets, frozen->slots,                          \
+                                  frozen->pilots, frozen->remap, positions);                                        \
+    }                                                                                                               \
+    iter = Hashmap_##K##_##V##_get_iterator(self);                                                                  \
+    for (int i = 0; built && Hashmap_##K##_##V##_iterator_next(&iter); i++) {                                       \
+        frozen->keys[positions[i]] = *Hashmap_##K##_##V##_iterator_current_key(&iter);                              \
+        frozen->values[positions[i]] = *Hashmap_##K##_##V##_iterator_current_value(&iter);                          \
+    }                                                                                                               \
+    free(hashes);                                                                                                   \
+    free(positions);                                                                                                \
+    if (!built) {                                                                                                   \
+        FrozenHashmap_##K##_##V##_free(frozen);                                                                     \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    return frozen;                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashmap_##K##_##V##_save(Hashmap_##K##_##V* self, const char* path) {                                   \
+    FrozenHashmap_##K##_##V* frozen = Hashmap_##K##_##V##_freeze(self);                                             \
+    bool saved = frozen != NULL && FrozenHashmap_##K##_##V##_save(frozen, path);                                    \
+    if (frozen != NULL) {                                                                                           \
+        FrozenHashmap_##K##_##V##_free(frozen);                                                                     \
+    }                                                                                                               \
+    return saved;                                                                                                   \
+}
+
 // === 公共API: 定义宏 ===
 
 /**
@@ -107,49 +1236,7 @@ _Generic(e,
  * HASHMAP_DEFINE(ulong, cstr)
  */
 #define HASHMAP_DEFINE(K, V)                                                                                        \
-static int Hashmap_##K##_##V##_hash(K key) {                                                                        \
-    union {                                                                                                         \
-        K k;                                                                                                        \
-        int ival;                                                                                                   \
-        long long llval;                                                                                            \
-        unsigned long long ullval;                                                                                  \
-        const char* strval;                                                                                         \
-        double lfval;                                                                                               \
-        void* ptrval;                                                                                               \
-    } u = {key};                                                                                                    \
-    return _Generic(key,                                                                                            \
-        bool: u.ival,                                                                                               \
-        char: u.ival,                                                                                               \
-        short: u.ival,                                                                                              \
-        int: u.ival,                                                                                                \
-        long: sizeof(long) == 4 ? u.ival : Hashmap_hash_int64(u.llval),                                             \
-        long long: Hashmap_hash_int64(u.llval),                                                                     \
-        unsigned char: u.ival,                                                                                      \
-        unsigned short: u.ival,                                                                                     \
-        unsigned int: u.ival,                                                                                       \
-        unsigned long: sizeof(long) == 4 ? u.ival : Hashmap_hash_uint64(u.ullval),                                  \
-        unsigned long long: Hashmap_hash_uint64(u.ullval),                                                          \
-        float: u.ival,                                                                                              \
-        double: Hashmap_hash_float64(u.lfval),                                                                      \
-        long double: Hashmap_hash_float64(u.lfval),                                                                 \
-        const char*: Hashmap_hash_cstr(u.strval),                                                                   \
-        default: Hashmap_hash_pointer(u.ptrval)                                                                     \
-    );                                                                                                              \
-}                                                                                                                   \
-static bool Hashmap_##K##_##V##_equals(K key1, K key2) {                                                            \
-    union { K k; const char* strval; } u1 = {key1};                                                                 \
-    union { K k; const char* strval; } u2 = {key2};                                                                 \
-    return _Generic(key1,                                                                                           \
-        const char*: strcmp(u1.strval, u2.strval) == 0,                                                             \
-        default: u1.k == u2.k                                                                                       \
-    );                                                                                                              \
-}                                                                                                                   \
-static void Hashmap_##K##_##V##_key_display(FILE* stream, K key) {                                                  \
-    __HASHMAP_DISPLAY_ELEMENT(stream, key);                                                                         \
-}                                                                                                                   \
-static void Hashmap_##K##_##V##_value_display(FILE* stream, V value) {                                              \
-    __HASHMAP_DISPLAY_ELEMENT(stream, value);                                                                       \
-}                                                                                                                   \
+__HASHMAP_DEFINE_DEFAULT_FUNCTIONS(Hashmap, K, V)                                                                   \
 HASHMAP_DEFINE_CUSTOM(K, V,                                                                                         \
     Hashmap_##K##_##V##_hash,                                                                                       \
     Hashmap_##K##_##V##_equals,                                                                                     \
@@ -162,27 +1249,82 @@ HASHMAP_DEFINE_CUSTOM(K, V,
  * 这是创建任何哈希表类型的核心宏。它允许您为哈希、相等性检查和显示键/值
  * 提供自己的函数，使其适用于自定义结构体或复杂类型。
  *
+ * 条目节点从每个哈希表私有的内存块 (slab) 中批量切分，而不是逐个 `malloc`；
+ * 被移除的节点进入空闲链表供后续插入复用，`hashmap_clear` 与 `hashmap_free`
+ * 则按块整体释放。元素不超过 `HASHMAP_INLINE_CAPACITY` 时不分配桶数组，前几个条目直接存放在哈希表头部。
+ *
  * @note **重要提示**: `K` 和 `V` 的类型名不能包含空格或星号 (`*`)。
  *       请使用 `typedef` 创建一个单一名词的别名。
  *
  * @param K 键的类型（必须是单个词）。
  * @param V 值的类型（必须是单个词）。
- * @param HashFn 用于哈希键的函数指针，类型为 `int (*)(K key)`。
+ * @param HashFn 用于哈希键的函数指针，类型为 `uint64_t (*)(K key)`。
  * @param EqualsFn 用于比较键的函数指针，类型为 `bool (*)(K key1, K key2)`。
  * @param DisplayKeyFn 用于打印键的函数指针，类型为 `void (*)(FILE* stream, K key)`。
  * @param DisplayValueFn 用于打印值的函数指针，类型为 `void (*)(FILE* stream, V value)`。
  */
 #define HASHMAP_DEFINE_CUSTOM(K, V, HashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)                                 \
+__HASHMAP_DEFINE_CHAINED(K, V, 0, HashFn, NULL, EqualsFn, DisplayKeyFn, DisplayValueFn)                             \
+/**
+ * @brief 为指定的键值对类型定义一个使用带密钥哈希的新哈希表。
+ *
+ * 适用于键来自不可信输入 (如客户端请求) 的场景。每个哈希表实例在
+ * `hashmap_new` 时获得一个随机的 128 位种子，默认的哈希函数为 SipHash-1-3，
+ * 攻击者在不知道种子的情况下无法构造出大量冲突的键。
+ * 受信任的内部哈希表应继续使用 `HASHMAP_DEFINE`，以获得更快的无密钥哈希。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ *
+ * @example
+ * typedef const char* cstr;
+ * HASHMAP_DEFINE_SEEDED(cstr, int)
+ * hashmap(cstr, int) map = hashmap_new(cstr, int);
+ */
+#define HASHMAP_DEFINE_SEEDED(K, V)                                                                                 \
+__HASHMAP_DEFINE_DEFAULT_FUNCTIONS(Hashmap, K, V)                                                                   \
+__HASHMAP_DEFINE_DEFAULT_KEYED_HASH(K, V)                                                                           \
+__HASHMAP_DEFINE_CHAINED(K, V, 1,                                                                                   \
+    Hashmap_##K##_##V##_hash,                                                                                       \
+    Hashmap_##K##_##V##_keyed_hash,                                                                                 \
+    Hashmap_##K##_##V##_equals,                                                                                     \
+    Hashmap_##K##_##V##_key_display,                                                                                \
+    Hashmap_##K##_##V##_value_display                                                                               \
+)                                                                                                                   \
+/**
+ * @brief 定义一个使用自定义带密钥哈希函数的新哈希表。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ * @param KeyedHashFn 带密钥的哈希函数，类型为 `uint64_t (*)(K key, const HashmapSeed* seed)`。
+ *                    可以借助 `Hashmap_siphash(data, len, seed)` 实现。
+ * @param EqualsFn 用于比较键的函数指针，类型为 `bool (*)(K key1, K key2)`。
+ * @param DisplayKeyFn 用于打印键的函数指针，类型为 `void (*)(FILE* stream, K key)`。
+ * @param DisplayValueFn 用于打印值的函数指针，类型为 `void (*)(FILE* stream, V value)`。
+ */
+#define HASHMAP_DEFINE_SEEDED_CUSTOM(K, V, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)                     \
+__HASHMAP_DEFINE_CHAINED(K, V, 1, NULL, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)
+
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_CHAINED(K, V, Seeded, HashFn, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)         \
                                                                                                                     \
 typedef struct __Hashmap_##K##_##V Hashmap_##K##_##V;                                                               \
+typedef struct __FrozenHashmap_##K##_##V FrozenHashmap_##K##_##V;                                                   \
                                                                                                                     \
 struct HashmapEntry_##K##_##V {                                                                                     \
     K key;                                                                                                          \
     V value;                                                                                                        \
-    int hash;                                                                                                       \
+    uint32_t hash;                                                                                                  \
     struct HashmapEntry_##K##_##V* next;                                                                            \
 };                                                                                                                  \
                                                                                                                     \
+struct HashmapSlab_##K##_##V {                                                                                      \
+    struct HashmapSlab_##K##_##V* next;                                                                             \
+    int capacity;                                                                                                   \
+    int used;                                                                                                       \
+    struct HashmapEntry_##K##_##V entries[];                                                                        \
+};                                                                                                                  \
+                                                                                                                    \
 struct HashmapIterator_##K##_##V {                                                                                  \
     Hashmap_##K##_##V* map;                                                                                         \
     int index;                                                                                                      \
@@ -190,20 +1332,33 @@ struct HashmapIterator_##K##_##V {
 };                                                                                                                  \
                                                                                                                     \
 struct Hashmap_##K##_##V##_Functions {                                                                              \
-    int (*hash)(K key);                                                                                             \
+    uint64_t (*hash)(K key);                                                                                        \
+    uint64_t (*keyed_hash)(K key, const HashmapSeed* seed);                                                         \
     bool (*equals)(K key1, K key2);                                                                                 \
     void (*display_key)(FILE* stream, K key);                                                                       \
     void (*display_value)(FILE* stream, V value);                                                                   \
     void (*display)(Hashmap_##K##_##V* self, FILE* stream);                                                         \
     void (*put)(Hashmap_##K##_##V* self, K key, V value);                                                           \
     const V* (*get)(Hashmap_##K##_##V* self, K key);                                                                \
+    V* (*get_mut)(Hashmap_##K##_##V* self, K key);                                                                  \
+    V* (*get_or_insert)(Hashmap_##K##_##V* self, K key, V default_value, bool* inserted);                           \
+    void (*put_many)(Hashmap_##K##_##V* self, const K* keys, const V* values, int n);                               \
+    int (*get_many)(Hashmap_##K##_##V* self, const K* keys, int n, const V** values);                               \
     bool (*remove)(Hashmap_##K##_##V* self, K key);                                                                 \
     bool (*contains)(Hashmap_##K##_##V* self, K key);                                                               \
     void (*clear)(Hashmap_##K##_##V* self);                                                                         \
+    void (*reserve)(Hashmap_##K##_##V* self, int n);                                                                \
+    void (*shrink_to_fit)(Hashmap_##K##_##V* self);                                                                 \
     struct HashmapIterator_##K##_##V (*get_iterator)(Hashmap_##K##_##V* self);                                      \
     bool (*iterator_next)(struct HashmapIterator_##K##_##V* self);                                                  \
     const K* (*iterator_current_key)(struct HashmapIterator_##K##_##V* self);                                       \
     const V* (*iterator_current_value)(struct HashmapIterator_##K##_##V* self);                                     \
+    FrozenHashmap_##K##_##V* (*freeze)(Hashmap_##K##_##V* self);                                                    \
+    bool (*save)(Hashmap_##K##_##V* self, const char* path);                                                        \
+    void (*merge_into)(Hashmap_##K##_##V* self, Hashmap_##K##_##V* other,                                           \
+                       void (*combine)(V* value, V other_value));                                                   \
+    void (*stats)(Hashmap_##K##_##V* self, HashmapStats* stats);                                                    \
+    ContainerMemoryUsage (*memory_usage)(Hashmap_##K##_##V* self);                                                  \
     void (*free)(Hashmap_##K##_##V* self);                                                                          \
 };                                                                                                                  \
                                                                                                                     \
@@ -212,17 +1367,132 @@ struct __Hashmap_##K##_##V {
     struct HashmapEntry_##K##_##V** entries;                                                                        \
     int size;                                                                                                       \
     int capacity;                                                                                                   \
+    __HASHMAP_SEED_FIELD(Seeded)                                                                                    \
+    __HASHMAP_RESIZE_FIELDS(K, V)                                                                                   \
+    struct HashmapSlab_##K##_##V* slabs;                                                                            \
+    struct HashmapEntry_##K##_##V* free_entries;                                                                    \
+    struct HashmapEntry_##K##_##V* inline_head;                                                                     \
+    int inline_used;                                                                                                \
+    int resizes;                                                                                                    \
+    __HASHMAP_COUNTERS_FIELD                                                                                        \
+    struct HashmapEntry_##K##_##V inline_entries[__HASHMAP_INLINE_ENTRIES(K, V)];                                   \
 };                                                                                                                  \
                                                                                                                     \
+const static struct Hashmap_##K##_##V##_Functions HASHMAP_##K##V##FUNCTIONS;                                        \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_track(long long bytes, int blocks) {                                                \
+    __CONTAINER_MEMORY_TRACK("hashmap(" #K ", " #V ")", bytes, blocks);                                             \
+}                                                                                                                   \
+                                                                                                                    \
+static size_t Hashmap_##K##_##V##_buckets_bytes(int capacity) {                                                     \
+    return capacity * sizeof(struct HashmapEntry_##K##_##V*) + (capacity + 63) / 64 * sizeof(uint64_t);             \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapEntry_##K##_##V** Hashmap_##K##_##V##_alloc_buckets(int capacity) {                            \
+    Hashmap_##K##_##V##_track(Hashmap_##K##_##V##_buckets_bytes(capacity), 1);                                      \
+    return (struct HashmapEntry_##K##_##V**) calloc(1, Hashmap_##K##_##V##_buckets_bytes(capacity));                \
+}                                                                                                                   \
+                                                                                                                    \
+static size_t Hashmap_##K##_##V##_slab_bytes(int capacity) {                                                        \
+    return sizeof(struct HashmapSlab_##K##_##V) + capacity * sizeof(struct HashmapEntry_##K##_##V);                 \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_free_buckets(struct HashmapEntry_##K##_##V** entries, int capacity) {               \
+    if (entries != NULL) {                                                                                          \
+        Hashmap_##K##_##V##_track(-(long long) Hashmap_##K##_##V##_buckets_bytes(capacity), -1);                    \
+    }                                                                                                               \
+    free(entries);                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapEntry_##K##_##V* Hashmap_##K##_##V##_alloc_entry(Hashmap_##K##_##V* self) {                    \
+    struct HashmapEntry_##K##_##V* entry = self->free_entries;                                                      \
+    if (entry != NULL) {                                                                                            \
+        self->free_entries = entry->next;                                                                           \
+        return entry;                                                                                               \
+    }                                                                                                               \
+    if (self->inline_used < __HASHMAP_INLINE_ENTRIES(K, V)) {                                                       \
+        return &self->inline_entries[self->inline_used++];                                                          \
+    }                                                                                                               \
+    struct HashmapSlab_##K##_##V* slab = self->slabs;                                                               \
+    if (slab == NULL || slab->used == slab->capacity) {                                                             \
+        int capacity = slab != NULL ? slab->capacity * 2                                                            \
+                       : self->inline_used > 0 ? self->inline_used : __HASHMAP_SLAB_MIN_ENTRIES;                    \
+        if (capacity > __HASHMAP_SLAB_MAX_ENTRIES) {                                                                \
+            capacity = __HASHMAP_SLAB_MAX_ENTRIES;                                                                  \
+        }                                                                                                           \
+        slab = (struct HashmapSlab_##K##_##V*) malloc(Hashmap_##K##_##V##_slab_bytes(capacity));                    \
+        Hashmap_##K##_##V##_track(Hashmap_##K##_##V##_slab_bytes(capacity), 1);                                     \
+        slab->next = self->slabs;                                                                                   \
+        slab->capacity = capacity;                                                                                  \
+        slab->used = 0;                                                                                             \
+        self->slabs = slab;                                                                                         \
+    }                                                                                                               \
+    return &slab->entries[slab->used++];                                                                            \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_free_entry(Hashmap_##K##_##V* self, struct HashmapEntry_##K##_##V* entry) {         \
+    entry->next = self->free_entries;                                                                               \
+    self->free_entries = entry;                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_release_slabs(Hashmap_##K##_##V* self) {                                            \
+    struct HashmapSlab_##K##_##V* slab = self->slabs;                                                               \
+    while (slab != NULL) {                                                                                          \
+        struct HashmapSlab_##K##_##V* next = slab->next;                                                            \
+        Hashmap_##K##_##V##_track(-(long long) Hashmap_##K##_##V##_slab_bytes(slab->capacity), -1);                 \
+        free(slab);                                                                                                 \
+        slab = next;                                                                                                \
+    }                                                                                                               \
+    self->slabs = NULL;                                                                                             \
+    self->free_entries = NULL;                                                                                      \
+    self->inline_used = 0;                                                                                          \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapEntry_##K##_##V** Hashmap_##K##_##V##_head(Hashmap_##K##_##V* self, uint64_t hash) {           \
+    return self->entries != NULL ? &self->entries[hash & (self->capacity - 1)] : &self->inline_head;                \
+}                                                                                                                   \
+                                                                                                                    \
+static int Hashmap_##K##_##V##_bucket_count(Hashmap_##K##_##V* self) {                                              \
+    return self->entries != NULL ? __HASHMAP_OLD_CAPACITY(self) + self->capacity : 1;                               \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapEntry_##K##_##V* Hashmap_##K##_##V##_bucket(Hashmap_##K##_##V* self, int index) {              \
+    if (self->entries == NULL) {                                                                                    \
+        return self->inline_head;                                                                                   \
+    }                                                                                                               \
+    if (index < __HASHMAP_OLD_CAPACITY(self)) {                                                                     \
+        return __HASHMAP_OLD_ENTRIES(self)[index];                                                                  \
+    }                                                                                                               \
+    return self->entries[index - __HASHMAP_OLD_CAPACITY(self)];                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+static int Hashmap_##K##_##V##_next_bucket(Hashmap_##K##_##V* self, int index) {                                    \
+    if (self->entries == NULL) {                                                                                    \
+        return index == 0 && self->inline_head != NULL ? 0 : 1;                                                     \
+    }                                                                                                               \
+    int old_capacity = __HASHMAP_OLD_CAPACITY(self);                                                                \
+    if (index < old_capacity) {                                                                                     \
+        int next = Hashmap_bitmap_next(__HASHMAP_OCCUPIED(__HASHMAP_OLD_ENTRIES(self), old_capacity), old_capacity, \
+                                       index);                                                                      \
+        if (next < old_capacity) {                                                                                  \
+            return next;                                                                                            \
+        }                                                                                                           \
+        index = old_capacity;                                                                                       \
+    }                                                                                                               \
+    uint64_t* occupied = __HASHMAP_OCCUPIED(self->entries, self->capacity);                                         \
+    return old_capacity + Hashmap_bitmap_next(occupied, self->capacity, index - old_capacity);                      \
+}                                                                                                                   \
+                                                                                                                    \
 static void Hashmap_##K##_##V##_display(Hashmap_##K##_##V* self, FILE* stream) {                                    \
     fprintf(stream, "{");                                                                                           \
     int count = 0;                                                                                                  \
-    for (int i = 0; i < self->capacity; i++) {                                                                      \
-        struct HashmapEntry_##K##_##V* entry = self->entries[i];                                                    \
+    for (int i = Hashmap_##K##_##V##_next_bucket(self, 0); i < Hashmap_##K##_##V##_bucket_count(self);              \
+         i = Hashmap_##K##_##V##_next_bucket(self, i + 1)) {                                                        \
+        struct HashmapEntry_##K##_##V* entry = Hashmap_##K##_##V##_bucket(self, i);                                 \
         while (entry != NULL) {                                                                                     \
-            self->fns->display_key(stream, entry->key);                                                             \
+            __HASHMAP_VTABLE(self, K, V)->display_key(stream, entry->key);                                          \
             fprintf(stream, ": ");                                                                                  \
-            self->fns->display_value(stream, entry->value);                                                         \
+            __HASHMAP_VTABLE(self, K, V)->display_value(stream, entry->value);                                      \
             if (count < self->size - 1) {                                                                           \
                 fprintf(stream, ", ");                                                                              \
             }                                                                                                       \
@@ -233,82 +1503,226 @@ static void Hashmap_##K##_##V##_display(Hashmap_##K##_##V* self, FILE* stream) {
     fprintf(stream, "}");                                                                                           \
 }                                                                                                                   \
                                                                                                                     \
-static void Hashmap_##K##_##V##_resize(Hashmap_##K##_##V* self) {                                                   \
-    self->capacity *= 2;                                                                                            \
+static void Hashmap_##K##_##V##_relink(Hashmap_##K##_##V* self, struct HashmapEntry_##K##_##V* entry) {             \
+    uint64_t* occupied = __HASHMAP_OCCUPIED(self->entries, self->capacity);                                         \
+    while (entry != NULL) {                                                                                         \
+        int index = (int) (entry->hash & (self->capacity - 1));                                                     \
+        struct HashmapEntry_##K##_##V* next_entry = entry->next;                                                    \
+        entry->next = self->entries[index];                                                                         \
+        self->entries[index] = entry;                                                                               \
+        Hashmap_bitmap_set(occupied, index);                                                                        \
+        entry = next_entry;                                                                                         \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+__HASHMAP_DEFINE_INCREMENTAL(K, V)                                                                                  \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_rehash(Hashmap_##K##_##V* self, int capacity) {                                     \
+    if (HASHMAP_INCREMENTAL_RESIZE) {                                                                               \
+        Hashmap_##K##_##V##_migrate(self, __HASHMAP_OLD_CAPACITY(self));                                            \
+    }                                                                                                               \
     struct HashmapEntry_##K##_##V** old_entries = self->entries;                                                    \
-    self->entries =                                                                                                 \
-        (struct HashmapEntry_##K##_##V**) malloc(self->capacity * sizeof(struct HashmapEntry_##K##_##V*));          \
-    for (int i = 0; i < self->capacity; i++) {                                                                      \
-        self->entries[i] = NULL;                                                                                    \
+    int old_capacity = old_entries != NULL ? self->capacity : 0;                                                    \
+    uint64_t* old_occupied = __HASHMAP_OCCUPIED(old_entries, old_capacity);                                         \
+    struct HashmapEntry_##K##_##V* inline_chain = self->inline_head;                                                \
+    self->resizes += old_entries != NULL;                                                                           \
+    self->inline_head = NULL;                                                                                       \
+    self->capacity = capacity;                                                                                      \
+    self->entries = Hashmap_##K##_##V##_alloc_buckets(self->capacity);                                              \
+    for (int i = Hashmap_bitmap_next(old_occupied, old_capacity, 0); i < old_capacity;                              \
+         i = Hashmap_bitmap_next(old_occupied, old_capacity, i + 1)) {                                              \
+        Hashmap_##K##_##V##_relink(self, old_entries[i]);                                                           \
     }                                                                                                               \
-    for (int i = 0; i < self->capacity / 2; i++) {                                                                  \
-        struct HashmapEntry_##K##_##V* entry = old_entries[i];                                                      \
-        while (entry != NULL) {                                                                                     \
-            int index = entry->hash & (self->capacity - 1);                                                         \
-            struct HashmapEntry_##K##_##V* next_entry = entry->next;                                                \
-            entry->next = self->entries[index];                                                                     \
-            self->entries[index] = entry;                                                                           \
-            entry = next_entry;                                                                                     \
+    Hashmap_##K##_##V##_relink(self, inline_chain);                                                                 \
+    Hashmap_##K##_##V##_free_buckets(old_entries, old_capacity);                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_spill(Hashmap_##K##_##V* self, int n) {                                             \
+    int capacity = Hashmap_capacity_for(n, __HASHMAP_LOAD_FACTOR);                                                  \
+    Hashmap_##K##_##V##_rehash(self, capacity > self->capacity ? capacity : self->capacity);                        \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_resize(Hashmap_##K##_##V* self) {                                                   \
+    if (HASHMAP_INCREMENTAL_RESIZE) {                                                                               \
+        Hashmap_##K##_##V##_migrate(self, __HASHMAP_OLD_CAPACITY(self));                                            \
+        Hashmap_##K##_##V##_retire_buckets(self);                                                                   \
+        self->resizes++;                                                                                            \
+        self->capacity *= 2;                                                                                        \
+        self->entries = Hashmap_##K##_##V##_alloc_buckets(self->capacity);                                          \
+        return;                                                                                                     \
+    }                                                                                                               \
+    Hashmap_##K##_##V##_rehash(self, self->capacity * 2);                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapEntry_##K##_##V* Hashmap_##K##_##V##_find_old(Hashmap_##K##_##V* self, K key, uint64_t hash) { \
+    struct HashmapEntry_##K##_##V* entry = __HASHMAP_OLD_ENTRIES(self)[hash & (__HASHMAP_OLD_CAPACITY(self) - 1)];  \
+    while (entry != NULL) {                                                                                         \
+        __HASHMAP_COUNT(self, probes);                                                                              \
+        if (entry->hash == (uint32_t) hash && __HASHMAP_KEY_EQUALS(self, K, V, entry->key, key)) {                  \
+            return entry;                                                                                           \
         }                                                                                                           \
+        entry = entry->next;                                                                                        \
     }                                                                                                               \
-    free(old_entries);                                                                                              \
+    return NULL;                                                                                                    \
 }                                                                                                                   \
                                                                                                                     \
-static void Hashmap_##K##_##V##_put(Hashmap_##K##_##V* self, K key, V value) {                                      \
-    if (self->size >= self->capacity * __HASHMAP_LOAD_FACTOR) {                                                     \
+static V* Hashmap_##K##_##V##_get_or_insert_hashed(Hashmap_##K##_##V* self, K key, uint64_t hash, V value,          \
+                                                 bool* inserted) {                                                  \
+    if (HASHMAP_INCREMENTAL_RESIZE) {                                                                               \
+        Hashmap_##K##_##V##_migrate(self, HASHMAP_INCREMENTAL_RESIZE_STEP);                                         \
+    }                                                                                                               \
+    if (self->entries != NULL && self->size >= self->capacity * __HASHMAP_LOAD_FACTOR) {                            \
         Hashmap_##K##_##V##_resize(self);                                                                           \
     }                                                                                                               \
-    int hash = self->fns->hash(key);                                                                                \
-    int index = hash & (self->capacity - 1);                                                                        \
-    struct HashmapEntry_##K##_##V* entry = self->entries[index];                                                    \
-    struct HashmapEntry_##K##_##V* last_entry = self->entries[index];                                               \
+    struct HashmapEntry_##K##_##V** bucket = Hashmap_##K##_##V##_head(self, hash);                                  \
+    struct HashmapEntry_##K##_##V* entry = *bucket;                                                                 \
+    struct HashmapEntry_##K##_##V* last_entry = *bucket;                                                            \
+    __HASHMAP_COUNT(self, lookups);                                                                                 \
     while (entry != NULL) {                                                                                         \
-        if (entry->hash == hash && self->fns->equals(entry->key, key)) {                                            \
-            entry->value = value;                                                                                   \
-            return;                                                                                                 \
+        __HASHMAP_COUNT(self, probes);                                                                              \
+        if (entry->hash == (uint32_t) hash && __HASHMAP_KEY_EQUALS(self, K, V, entry->key, key)) {                  \
+            *inserted = false;                                                                                      \
+            return &entry->value;                                                                                   \
         }                                                                                                           \
         last_entry = entry;                                                                                         \
         entry = entry->next;                                                                                        \
     }                                                                                                               \
-    entry = (struct HashmapEntry_##K##_##V*) malloc(sizeof(struct HashmapEntry_##K##_##V));                         \
+    if (HASHMAP_INCREMENTAL_RESIZE && __HASHMAP_OLD_ENTRIES(self) != NULL) {                                        \
+        entry = Hashmap_##K##_##V##_find_old(self, key, hash);                                                      \
+        if (entry != NULL) {                                                                                        \
+            *inserted = false;                                                                                      \
+            return &entry->value;                                                                                   \
+        }                                                                                                           \
+    }                                                                                                               \
+    if (self->entries == NULL && self->size >= HASHMAP_INLINE_CAPACITY) {                                           \
+        Hashmap_##K##_##V##_spill(self, self->size + 1);                                                            \
+        return Hashmap_##K##_##V##_get_or_insert_hashed(self, key, hash, value, inserted);                          \
+    }                                                                                                               \
+    entry = Hashmap_##K##_##V##_alloc_entry(self);                                                                  \
     entry->key = key;                                                                                               \
     entry->value = value;                                                                                           \
     entry->next = NULL;                                                                                             \
-    entry->hash = hash;                                                                                             \
+    entry->hash = (uint32_t) hash;                                                                                  \
     if (last_entry == NULL) {                                                                                       \
-        self->entries[index] = entry;                                                                               \
+        *bucket = entry;                                                                                            \
+        if (self->entries != NULL) {                                                                                \
+            int index = (int) (hash & (self->capacity - 1));                                                        \
+            Hashmap_bitmap_set(__HASHMAP_OCCUPIED(self->entries, self->capacity), index);                           \
+        }                                                                                                           \
     } else {                                                                                                        \
         last_entry->next = entry;                                                                                   \
     }                                                                                                               \
     self->size++;                                                                                                   \
+    *inserted = true;                                                                                               \
+    return &entry->value;                                                                                           \
 }                                                                                                                   \
                                                                                                                     \
-static const V* Hashmap_##K##_##V##_get(Hashmap_##K##_##V* self, K key) {                                           \
-    int hash = self->fns->hash(key);                                                                                \
-    int index = hash & (self->capacity - 1);                                                                        \
-    struct HashmapEntry_##K##_##V* entry = self->entries[index];                                                    \
+static void Hashmap_##K##_##V##_put_hashed(Hashmap_##K##_##V* self, K key, uint64_t hash, V value) {                \
+    bool inserted;                                                                                                  \
+    V* slot = Hashmap_##K##_##V##_get_or_insert_hashed(self, key, hash, value, &inserted);                          \
+    if (!inserted) {                                                                                                \
+        *slot = value;                                                                                              \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static V* Hashmap_##K##_##V##_get_or_insert(Hashmap_##K##_##V* self, K key, V default_value, bool* inserted) {      \
+    bool was_inserted;                                                                                              \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    V* slot = Hashmap_##K##_##V##_get_or_insert_hashed(self, key, hash, default_value, &was_inserted);              \
+    if (inserted != NULL) {                                                                                         \
+        *inserted = was_inserted;                                                                                   \
+    }                                                                                                               \
+    return slot;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_put(Hashmap_##K##_##V* self, K key, V value) {                                      \
+    Hashmap_##K##_##V##_put_hashed(self, key, __HASHMAP_HASH(self, K, V, Seeded, key), value);                      \
+}                                                                                                                   \
+                                                                                                                    \
+static V* Hashmap_##K##_##V##_get_hashed(Hashmap_##K##_##V* self, struct HashmapEntry_##K##_##V* entry,             \
+                                         K key, uint64_t hash) {                                                    \
+    __HASHMAP_COUNT(self, lookups);                                                                                 \
     while (entry != NULL) {                                                                                         \
-        if (self->fns->equals(entry->key, key)) {                                                                   \
+        __HASHMAP_COUNT(self, probes);                                                                              \
+        if (entry->hash == (uint32_t) hash && __HASHMAP_KEY_EQUALS(self, K, V, entry->key, key)) {                  \
             return &entry->value;                                                                                   \
         }                                                                                                           \
         entry = entry->next;                                                                                        \
     }                                                                                                               \
+    if (HASHMAP_INCREMENTAL_RESIZE && __HASHMAP_OLD_ENTRIES(self) != NULL) {                                        \
+        entry = Hashmap_##K##_##V##_find_old(self, key, hash);                                                      \
+        return entry != NULL ? &entry->value : NULL;                                                                \
+    }                                                                                                               \
     return NULL;                                                                                                    \
 }                                                                                                                   \
                                                                                                                     \
-static bool Hashmap_##K##_##V##_remove(Hashmap_##K##_##V* self, K key) {                                            \
-    int hash = self->fns->hash(key);                                                                                \
-    int index = hash & (self->capacity - 1);                                                                        \
-    struct HashmapEntry_##K##_##V* entry = self->entries[index];                                                    \
+static V* Hashmap_##K##_##V##_get_mut(Hashmap_##K##_##V* self, K key) {                                             \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    return Hashmap_##K##_##V##_get_hashed(self, *Hashmap_##K##_##V##_head(self, hash), key, hash);                  \
+}                                                                                                                   \
+                                                                                                                    \
+static const V* Hashmap_##K##_##V##_get(Hashmap_##K##_##V* self, K key) {                                           \
+    return Hashmap_##K##_##V##_get_mut(self, key);                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_put_many(Hashmap_##K##_##V* self, const K* keys, const V* values, int n) {          \
+    uint64_t hashes[__HASHMAP_BATCH_SIZE];                                                                          \
+    for (int base = 0; base < n; base += __HASHMAP_BATCH_SIZE) {                                                    \
+        int count = n - base < __HASHMAP_BATCH_SIZE ? n - base : __HASHMAP_BATCH_SIZE;                              \
+        if (self->entries == NULL && self->size + count > HASHMAP_INLINE_CAPACITY) {                                \
+            Hashmap_##K##_##V##_spill(self, self->size + count);                                                    \
+        }                                                                                                           \
+        while (self->entries != NULL && self->size + count > self->capacity * __HASHMAP_LOAD_FACTOR) {              \
+            Hashmap_##K##_##V##_resize(self);                                                                       \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            hashes[i] = __HASHMAP_HASH(self, K, V, Seeded, keys[base + i]);                                         \
+            __builtin_prefetch(Hashmap_##K##_##V##_head(self, hashes[i]), 1);                                       \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            __builtin_prefetch(*Hashmap_##K##_##V##_head(self, hashes[i]), 1);                                      \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            Hashmap_##K##_##V##_put_hashed(self, keys[base + i], hashes[i], values[base + i]);                      \
+        }                                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static int Hashmap_##K##_##V##_get_many(Hashmap_##K##_##V* self, const K* keys, int n, const V** values) {          \
+    uint64_t hashes[__HASHMAP_BATCH_SIZE];                                                                          \
+    struct HashmapEntry_##K##_##V* heads[__HASHMAP_BATCH_SIZE];                                                     \
+    int found = 0;                                                                                                  \
+    for (int base = 0; base < n; base += __HASHMAP_BATCH_SIZE) {                                                    \
+        int count = n - base < __HASHMAP_BATCH_SIZE ? n - base : __HASHMAP_BATCH_SIZE;                              \
+        for (int i = 0; i < count; i++) {                                                                           \
+            hashes[i] = __HASHMAP_HASH(self, K, V, Seeded, keys[base + i]);                                         \
+            __builtin_prefetch(Hashmap_##K##_##V##_head(self, hashes[i]));                                          \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            heads[i] = *Hashmap_##K##_##V##_head(self, hashes[i]);                                                  \
+            __builtin_prefetch(heads[i]);                                                                           \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            values[base + i] = Hashmap_##K##_##V##_get_hashed(self, heads[i], keys[base + i], hashes[i]);           \
+            found += values[base + i] != NULL;                                                                      \
+        }                                                                                                           \
+    }                                                                                                               \
+    return found;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashmap_##K##_##V##_unlink(Hashmap_##K##_##V* self, struct HashmapEntry_##K##_##V** bucket,             \
+                                       K key, uint64_t hash) {                                                      \
+    struct HashmapEntry_##K##_##V* entry = *bucket;                                                                 \
     struct HashmapEntry_##K##_##V* prev = NULL;                                                                     \
     while (entry != NULL) {                                                                                         \
-        if (entry->hash == hash && self->fns->equals(entry->key, key)) {                                            \
+        __HASHMAP_COUNT(self, probes);                                                                              \
+        if (entry->hash == (uint32_t) hash && __HASHMAP_KEY_EQUALS(self, K, V, entry->key, key)) {                  \
             if (prev == NULL) {                                                                                     \
-                self->entries[index] = entry->next;                                                                 \
+                *bucket = entry->next;                                                                              \
             } else {                                                                                                \
                 prev->next = entry->next;                                                                           \
             }                                                                                                       \
-            free(entry);                                                                                            \
+            Hashmap_##K##_##V##_free_entry(self, entry);                                                            \
             self->size--;                                                                                           \
             return true;                                                                                            \
         }                                                                                                           \
@@ -318,23 +1732,75 @@ static bool Hashmap_##K##_##V##_remove(Hashmap_##K##_##V* self, K key) {
     return false;                                                                                                   \
 }                                                                                                                   \
                                                                                                                     \
+static bool Hashmap_##K##_##V##_remove(Hashmap_##K##_##V* self, K key) {                                            \
+    if (HASHMAP_INCREMENTAL_RESIZE) {                                                                               \
+        Hashmap_##K##_##V##_migrate(self, HASHMAP_INCREMENTAL_RESIZE_STEP);                                         \
+    }                                                                                                               \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    int index = (int) (hash & (self->capacity - 1));                                                                \
+    struct HashmapEntry_##K##_##V** bucket = Hashmap_##K##_##V##_head(self, hash);                                  \
+    __HASHMAP_COUNT(self, lookups);                                                                                 \
+    bool removed = Hashmap_##K##_##V##_unlink(self, bucket, key, hash);                                             \
+    if (removed && *bucket == NULL && self->entries != NULL) {                                                      \
+        Hashmap_bitmap_reset(__HASHMAP_OCCUPIED(self->entries, self->capacity), index);                             \
+    }                                                                                                               \
+    struct HashmapEntry_##K##_##V** old_entries = __HASHMAP_OLD_ENTRIES(self);                                      \
+    if (!removed && HASHMAP_INCREMENTAL_RESIZE && old_entries != NULL) {                                            \
+        index = (int) (hash & (__HASHMAP_OLD_CAPACITY(self) - 1));                                                  \
+        removed = Hashmap_##K##_##V##_unlink(self, &old_entries[index], key, hash);                                 \
+        if (removed && old_entries[index] == NULL) {                                                                \
+            Hashmap_bitmap_reset(__HASHMAP_OCCUPIED(old_entries, __HASHMAP_OLD_CAPACITY(self)), index);             \
+        }                                                                                                           \
+    }                                                                                                               \
+    if (HASHMAP_AUTO_SHRINK && removed && self->entries != NULL && __HASHMAP_OLD_ENTRIES(self) == NULL &&           \
+        self->capacity > 16 && self->size < self->capacity * __HASHMAP_LOAD_FACTOR / 4) {                           \
+        Hashmap_##K##_##V##_rehash(self, self->capacity / 2);                                                       \
+    }                                                                                                               \
+    return removed;                                                                                                 \
+}                                                                                                                   \
+                                                                                                                    \
 static bool Hashmap_##K##_##V##_contains(Hashmap_##K##_##V* self, K key) {                                          \
     return Hashmap_##K##_##V##_get(self, key) != NULL;                                                              \
 }                                                                                                                   \
                                                                                                                     \
 static void Hashmap_##K##_##V##_clear(Hashmap_##K##_##V* self) {                                                    \
-    for (int i = 0; i < self->capacity; i++) {                                                                      \
-        struct HashmapEntry_##K##_##V* entry = self->entries[i];                                                    \
-        while (entry != NULL) {                                                                                     \
-            struct HashmapEntry_##K##_##V* next = entry->next;                                                      \
-            free(entry);                                                                                            \
-            entry = next;                                                                                           \
+    uint64_t* occupied = __HASHMAP_OCCUPIED(self->entries, self->capacity);                                         \
+    for (int word = 0; self->entries != NULL && word < (self->capacity + 63) / 64; word++) {                        \
+        while (occupied[word] != 0) {                                                                               \
+            self->entries[word * 64 + __builtin_ctzll(occupied[word])] = NULL;                                      \
+            occupied[word] &= occupied[word] - 1;                                                                   \
         }                                                                                                           \
-        self->entries[i] = NULL;                                                                                    \
     }                                                                                                               \
+    Hashmap_##K##_##V##_free_buckets(__HASHMAP_OLD_ENTRIES(self), __HASHMAP_OLD_CAPACITY(self));                    \
+    Hashmap_##K##_##V##_reset_old(self);                                                                            \
+    Hashmap_##K##_##V##_release_slabs(self);                                                                        \
+    self->inline_head = NULL;                                                                                       \
     self->size = 0;                                                                                                 \
 }                                                                                                                   \
                                                                                                                     \
+static void Hashmap_##K##_##V##_reserve(Hashmap_##K##_##V* self, int n) {                                           \
+    int capacity = Hashmap_capacity_for(n, __HASHMAP_LOAD_FACTOR);                                                  \
+    if (self->entries == NULL ? n > HASHMAP_INLINE_CAPACITY : capacity > self->capacity) {                          \
+        Hashmap_##K##_##V##_spill(self, n);                                                                         \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_shrink_to_fit(Hashmap_##K##_##V* self) {                                            \
+    if (HASHMAP_INCREMENTAL_RESIZE) {                                                                               \
+        Hashmap_##K##_##V##_migrate(self, __HASHMAP_OLD_CAPACITY(self));                                            \
+    }                                                                                                               \
+    int capacity = Hashmap_capacity_for(self->size, __HASHMAP_LOAD_FACTOR);                                         \
+    if (self->size == 0) {                                                                                          \
+        Hashmap_##K##_##V##_free_buckets(self->entries, self->capacity);                                            \
+        self->entries = NULL;                                                                                       \
+        self->capacity = capacity;                                                                                  \
+        self->inline_head = NULL;                                                                                   \
+        Hashmap_##K##_##V##_release_slabs(self);                                                                    \
+    } else if (self->entries != NULL && capacity < self->capacity) {                                                \
+        Hashmap_##K##_##V##_rehash(self, capacity);                                                                 \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
 static struct HashmapIterator_##K##_##V Hashmap_##K##_##V##_get_iterator(Hashmap_##K##_##V* self) {                 \
     struct HashmapIterator_##K##_##V iter = {                                                                       \
         .map = self,                                                                                                \
@@ -349,12 +1815,11 @@ static bool Hashmap_##K##_##V##_iterator_next(struct HashmapIterator_##K##_##V*
         self->entry = self->entry->next;                                                                            \
         return true;                                                                                                \
     }                                                                                                               \
-    while (self->index < self->map->capacity) {                                                                     \
-        self->entry = self->map->entries[self->index];                                                              \
+    self->index = Hashmap_##K##_##V##_next_bucket(self->map, self->index);                                          \
+    if (self->index < Hashmap_##K##_##V##_bucket_count(self->map)) {                                                \
+        self->entry = Hashmap_##K##_##V##_bucket(self->map, self->index);                                           \
         self->index++;                                                                                              \
-        if (self->entry != NULL) {                                                                                  \
-            return true;                                                                                            \
-        }                                                                                                           \
+        return true;                                                                                                \
     }                                                                                                               \
     return false;                                                                                                   \
 }                                                                                                                   \
@@ -367,21 +1832,50 @@ static const V* Hashmap_##K##_##V##_iterator_current_value(struct HashmapIterato
     return &self->entry->value;                                                                                     \
 }                                                                                                                   \
                                                                                                                     \
-static void Hashmap_##K##_##V##_free(Hashmap_##K##_##V* self) {                                                     \
-    for (int i = 0; i < self->capacity; i++) {                                                                      \
-        struct HashmapEntry_##K##_##V* entry = self->entries[i];                                                    \
-        while (entry != NULL) {                                                                                     \
-            struct HashmapEntry_##K##_##V* next = entry->next;                                                      \
-            free(entry);                                                                                            \
-            entry = next;                                                                                           \
+static ContainerMemoryUsage Hashmap_##K##_##V##_memory_usage(Hashmap_##K##_##V* self) {                             \
+    ContainerMemoryUsage usage = {self->size * (sizeof(K) + sizeof(V)), 0, 0, 0};                                   \
+    ContainerMemory_add_block(&usage, self, sizeof(*self));                                                         \
+    ContainerMemory_add_block(&usage, self->entries, Hashmap_##K##_##V##_buckets_bytes(self->capacity));            \
+    ContainerMemory_add_block(&usage, __HASHMAP_OLD_ENTRIES(self),                                                  \
+                              Hashmap_##K##_##V##_buckets_bytes(__HASHMAP_OLD_CAPACITY(self)));                     \
+    for (struct HashmapSlab_##K##_##V* slab = self->slabs; slab != NULL; slab = slab->next) {                       \
+        ContainerMemory_add_block(&usage, slab, Hashmap_##K##_##V##_slab_bytes(slab->capacity));                    \
+    }                                                                                                               \
+    return usage;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_stats(Hashmap_##K##_##V* self, HashmapStats* stats) {                               \
+    memset(stats, 0, sizeof(*stats));                                                                               \
+    stats->size = self->size;                                                                                       \
+    stats->resize_count = self->resizes;                                                                            \
+    stats->counters = __HASHMAP_COUNTERS(self);                                                                     \
+    stats->total_bytes = Hashmap_##K##_##V##_memory_usage(self).requested_bytes;                                    \
+    for (int i = 0; i < Hashmap_##K##_##V##_bucket_count(self); i++) {                                              \
+        int length = 0;                                                                                             \
+        for (struct HashmapEntry_##K##_##V* entry = Hashmap_##K##_##V##_bucket(self, i); entry != NULL;             \
+             entry = entry->next) {                                                                                 \
+            length++;                                                                                               \
         }                                                                                                           \
+        Hashmap_stats_add_chain(stats, length);                                                                     \
     }                                                                                                               \
-    free(self->entries);                                                                                            \
+    stats->max_probe = stats->max_chain;                                                                            \
+    Hashmap_stats_finish(stats);                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_free(Hashmap_##K##_##V* self) {                                                     \
+    Hashmap_##K##_##V##_release_slabs(self);                                                                        \
+    Hashmap_##K##_##V##_free_buckets(__HASHMAP_OLD_ENTRIES(self), __HASHMAP_OLD_CAPACITY(self));                    \
+    Hashmap_##K##_##V##_free_buckets(self->entries, self->capacity);                                                \
+    Hashmap_##K##_##V##_track(-(long long) sizeof(*self), -1);                                                      \
     free(self);                                                                                                     \
 }                                                                                                                   \
                                                                                                                     \
+__HASHMAP_DEFINE_MERGE(K, V)                                                                                        \
+__HASHMAP_DEFINE_FROZEN(K, V, Seeded)                                                                               \
+                                                                                                                    \
 const static struct Hashmap_##K##_##V##_Functions HASHMAP_##K##V##FUNCTIONS = {                                     \
     .hash = HashFn,                                                                                                 \
+    .keyed_hash = KeyedHashFn,                                                                                      \
     .equals = EqualsFn,                                                                                             \
     .display_key = DisplayKeyFn,                                                                                    \
     .display_value = DisplayValueFn,                                                                                \
@@ -390,23 +1884,40 @@ const static struct Hashmap_##K##_##V##_Functions HASHMAP_##K##V##FUNCTIONS = {
     .remove = Hashmap_##K##_##V##_remove,                                                                           \
     .contains = Hashmap_##K##_##V##_contains,                                                                       \
     .clear = Hashmap_##K##_##V##_clear,                                                                             \
+    .reserve = Hashmap_##K##_##V##_reserve,                                                                         \
+    .shrink_to_fit = Hashmap_##K##_##V##_shrink_to_fit,                                                             \
     .get = Hashmap_##K##_##V##_get,                                                                                 \
+    .get_mut = Hashmap_##K##_##V##_get_mut,                                                                         \
+    .get_or_insert = Hashmap_##K##_##V##_get_or_insert,                                                             \
+    .put_many = Hashmap_##K##_##V##_put_many,                                                                       \
+    .get_many = Hashmap_##K##_##V##_get_many,                                                                       \
     .get_iterator = Hashmap_##K##_##V##_get_iterator,                                                               \
     .iterator_next = Hashmap_##K##_##V##_iterator_next,                                                             \
     .iterator_current_key = Hashmap_##K##_##V##_iterator_current_key,                                               \
     .iterator_current_value = Hashmap_##K##_##V##_iterator_current_value,                                           \
+    .freeze = Hashmap_##K##_##V##_freeze,                                                                           \
+    .save = Hashmap_##K##_##V##_save,                                                                               \
+    .merge_into = Hashmap_##K##_##V##_merge_into,                                                                   \
+    .stats = Hashmap_##K##_##V##_stats,                                                                             \
+    .memory_usage = Hashmap_##K##_##V##_memory_usage,                                                               \
     .free = Hashmap_##K##_##V##_free,                                                                               \
 };                                                                                                                  \
                                                                                                                     \
 static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {                                                   \
     Hashmap_##K##_##V* self = (Hashmap_##K##_##V*) malloc(sizeof(Hashmap_##K##_##V));                               \
     self->fns = &HASHMAP_##K##V##FUNCTIONS;                                                                         \
-    self->entries = (struct HashmapEntry_##K##_##V**) malloc(capacity * sizeof(struct HashmapEntry_##K##_##V*));    \
-    for (int i = 0; i < capacity; i++) {                                                                            \
-        self->entries[i] = NULL;                                                                                    \
-    }                                                                                                               \
+    self->entries = NULL;                                                                                           \
     self->size = 0;                                                                                                 \
     self->capacity = capacity;                                                                                      \
+    __HASHMAP_SEED_INIT(self, Seeded);                                                                              \
+    Hashmap_##K##_##V##_reset_old(self);                                                                            \
+    self->slabs = NULL;                                                                                             \
+    self->free_entries = NULL;                                                                                      \
+    self->inline_head = NULL;                                                                                       \
+    self->inline_used = 0;                                                                                          \
+    self->resizes = 0;                                                                                              \
+    __HASHMAP_COUNTERS_RESET(self);                                                                                 \
+    Hashmap_##K##_##V##_track(sizeof(*self), 1);                                                                    \
     return self;                                                                                                    \
 }                                                                                                                   \
 
@@ -461,7 +1972,7 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * hashmap_put(my_map, "学号-01", 101);
  * hashmap_put(roster_map, "Alice", (Student){101, 95.5f});
  */
-#define hashmap_put(map, key, ...) (map)->fns->put((map), (key), __VA_ARGS__)
+#define hashmap_put(map, key, ...) __HASHMAP_FNS(map)->put((map), (key), __VA_ARGS__)
 /**
  * @brief 检索与给定键关联的值。
  * @param map (hashmap(K,V)) 哈希表实例。
@@ -469,7 +1980,97 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @return (const V*) 如果找到键，则返回一个指向值的只读指针；否则返回 NULL。
  * @example const int* val = hashmap_get(my_map, "hello"); if (val) { printf("%d", *val); }
  */
-#define hashmap_get(map, key) (map)->fns->get((map), (key))
+#define hashmap_get(map, key) __HASHMAP_FNS(map)->get((map), (key))
+/**
+ * @brief 与 `hashmap_get` 相同，但返回可写指针，可以直接原地修改值。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @param key (K) 要查找的键。
+ * @return (V*) 如果找到键，则返回一个指向值的可写指针；否则返回 NULL。
+ * @example int* val = hashmap_get_mut(my_map, "hello"); if (val) { (*val)++; }
+ */
+#define hashmap_get_mut(map, key) __HASHMAP_FNS(map)->get_mut((map), (key))
+/**
+ * @brief 查找键，若不存在则以 `default_value` 插入，并返回指向值的可写指针。
+ * 整个过程只计算一次哈希，适合计数、聚合等"先查后改"的场景，避免 `hashmap_get` + `hashmap_put` 的两次查找。
+ * 返回的指针与 `hashmap_get` 的返回值具有相同的有效期。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @param key (K) 键。
+ * @param default_value (V) 键不存在时插入的值；键已存在时忽略。
+ * @param inserted (bool*) 若不为 NULL，则写入本次是否插入了新条目。
+ * @return (V*) 指向键所对应的值的可写指针，永不为 NULL。
+ * @example (*hashmap_get_or_insert(word_count, word, 0, NULL))++;
+ */
+#define hashmap_get_or_insert(map, key, default_value, inserted)                                                    \
+    __HASHMAP_FNS(map)->get_or_insert((map), (key), (default_value), (inserted))
+/**
+ * @brief 批量插入或更新 `n` 个键值对，效果等同于依次调用 `hashmap_put`。
+ * 每 32 个键为一组：先计算整组的哈希并预取对应的桶，再逐个插入，使多次缓存未命中可以重叠。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @param keys (const K*) 键数组。
+ * @param values (const V*) 与 `keys` 一一对应的值数组。
+ * @param n (int) 键值对的数量。
+ * @example hashmap_put_many(my_map, keys, values, 1000);
+ */
+#define hashmap_put_many(map, keys, values, n) __HASHMAP_FNS(map)->put_many((map), (keys), (values), (n))
+/**
+ * @brief 批量查找 `n` 个键，结果写入 `out[i]` (未找到时为 NULL)。
+ * 与 `hashmap_put_many` 一样按组预取，适合大表上的批量随机查找。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @param keys (const K*) 要查找的键数组。
+ * @param n (int) 键的数量。
+ * @param out (const V**) 长度至少为 `n` 的输出数组。
+ * @return (int) 找到的键的数量。
+ * @example const int* vals[64]; int found = hashmap_get_many(my_map, keys, 64, vals);
+ */
+#define hashmap_get_many(map, keys, n, out) __HASHMAP_FNS(map)->get_many((map), (keys), (n), (out))
+/**
+ * @brief 把 `src` 中的所有键值对合并到 `dst` 中，`src` 保持不变。
+ * 键只在 `src` 中存在时直接插入；两边都存在时调用 `combine_fn(&dst_value, src_value)` 合并，
+ * `combine_fn` 为 NULL 时以 `src` 的值覆盖。适合把各线程独立聚合的结果汇总到一起。
+ * @param dst (hashmap(K,V)) 目标哈希表。
+ * @param src (hashmap(K,V)) 源哈希表，必须与 `dst` 类型相同。
+ * @param combine_fn (void (*)(V* value, V other_value)) 合并函数，可以为 NULL。
+ * @example static void add(int* value, int other) { *value += other; }
+ *          hashmap_merge_into(total, partial, add);
+ */
+#define hashmap_merge_into(dst, src, combine_fn) __HASHMAP_FNS(dst)->merge_into((dst), (src), (combine_fn))
+/**
+ * @brief 用哈希表当前的全部内容构建一个只读的冻结哈希表，原哈希表保持不变。
+ * 冻结哈希表基于最小完美哈希 (PTHash 风格的 pilot 搜索)：键和值分别存放在两个紧凑数组中，
+ * 每个键恰好占据一个位置，额外开销约为每键 4 比特。查找只需一次探测和一次键比较。
+ * 构建耗时与元素数量成线性关系，适合启动时一次性加载、之后只读的大型字典。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @return (frozen_hashmap(K,V)) 新建的冻结哈希表；若存在 64 位哈希值完全相同的不同键
+ *         (只可能出现在质量很差的自定义哈希函数上) 则返回 NULL。
+ * @example frozen_hashmap(cstr, int) dict = hashmap_freeze(builder);
+ */
+#define hashmap_freeze(map) __HASHMAP_FNS(map)->freeze(map)
+/**
+ * @brief 把哈希表的当前内容保存为可直接映射的快照文件，原哈希表保持不变。
+ * 内部先执行 `hashmap_freeze`，再把冻结哈希表的各个数组原样写入文件，
+ * 布局见 `HashmapSnapshotHeader`。键和值必须是 POD 类型 (不含指针)，
+ * 唯一的例外是 `cstr` 键：字符串内容会被复制进文件的字符串区。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @param path (const char*) 目标文件路径，已存在时会被覆盖。
+ * @return (bool) 成功返回 `true`；冻结失败、值类型为字符串或写文件失败时返回 `false`。
+ * @example hashmap_save(dict, "dict.bin");
+ */
+#define hashmap_save(map, path) __HASHMAP_FNS(map)->save((map), (path))
+/**
+ * @brief 以只读方式映射 `hashmap_save` 写出的快照文件，得到一个冻结哈希表。
+ * 打开时只校验文件头与各段的边界 (常数时间)，截断或头部损坏的文件返回 NULL；
+ * remap 表的值与字符串键的偏移量在每次查找用到时才检查，越界的项按键不存在处理，
+ * `frozen_hashmap_key_at` 对这样的项返回空字符串。除此之外不解析、不复制数据，也不为键值分配内存：
+ * pilot、键、值数组都直接指向映射区，页面在首次访问时才由操作系统载入，
+ * 多个进程映射同一文件时共享同一份物理内存。文件在 `frozen_hashmap_free` 之前必须保持不变。
+ * 非 POSIX 平台上退化为一次性读入内存。
+ * @param K 键的类型，必须与保存时相同。
+ * @param V 值的类型，必须与保存时相同。
+ * @param path (const char*) 快照文件路径。
+ * @return (frozen_hashmap(K,V)) 只读的冻结哈希表；文件不存在、格式或类型不匹配时返回 NULL。
+ * @example frozen_hashmap(cstr, int) dict = hashmap_open_mmap(cstr, int, "dict.bin");
+ */
+#define hashmap_open_mmap(K, V, path) FrozenHashmap_##K##_##V##_open_mmap(path)
 /**
  * @brief 从哈希表中移除一个键值对。
  * @param map (hashmap(K,V)) 哈希表实例。
@@ -477,7 +2078,7 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @return (bool) 如果成功移除了一个元素，则返回 `true`；否则返回 `false`。
  * @example bool removed = hashmap_remove(my_map, "hello");
  */
-#define hashmap_remove(map, key) (map)->fns->remove((map), (key))
+#define hashmap_remove(map, key) __HASHMAP_FNS(map)->remove((map), (key))
 /**
  * @brief 检查哈希表是否包含指定的键。
  * @param map (hashmap(K,V)) 哈希表实例。
@@ -485,7 +2086,7 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @return (bool) 如果键存在，则返回 `true`；否则返回 `false`。
  * @example if (hashmap_contains(my_map, "world")) { ... }
  */
-#define hashmap_contains(map, key) (map)->fns->contains((map), (key))
+#define hashmap_contains(map, key) __HASHMAP_FNS(map)->contains((map), (key))
 // === 公共API: 工具与生命周期宏 ===
 /**
  * @brief 将哈希表的内容显示到给定的文件流。
@@ -493,7 +2094,7 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @param stream (FILE*) 输出流 (例如, stdout, stderr, 或一个文件指针)。
  * @example hashmap_display(my_map, stdout); // 输出: {"key1": val1, "key2": val2}
  */
-#define hashmap_display(map, stream) (map)->fns->display((map), (stream))
+#define hashmap_display(map, stream) __HASHMAP_FNS(map)->display((map), (stream))
 /**
  * @brief 返回哈希表中键值对的数量。
  * @param map (hashmap(K,V)) 哈希表实例。
@@ -507,7 +2108,44 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @param map (hashmap(K,V)) 哈希表实例。
  * @example hashmap_clear(my_map);
  */
-#define hashmap_clear(map) (map)->fns->clear(map)
+#define hashmap_clear(map) __HASHMAP_FNS(map)->clear(map)
+/**
+ * @brief 预留空间，使此后插入总计 `n` 个元素的过程中不再发生扩容。
+ * `n` 可以是任意非负数，内部会向上取整到合适的 2 的幂容量；已有容量足够时不做任何事。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @param n (int) 预计的元素总数 (包括已有元素)。
+ * @example hashmap_reserve(my_map, 1000000);
+ */
+#define hashmap_reserve(map, n) __HASHMAP_FNS(map)->reserve((map), (n))
+/**
+ * @brief 将容量收缩到恰好能容纳当前元素的大小 (不小于默认容量 16)，释放多余的内存。
+ * 对于链式哈希表，只重建桶数组，条目节点不会移动；元素数量为 0 时条目内存也会一并归还。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @example hashmap_shrink_to_fit(my_map);
+ */
+#define hashmap_shrink_to_fit(map) __HASHMAP_FNS(map)->shrink_to_fit(map)
+/**
+ * @brief 读取哈希表的统计信息：桶数量、负载因子、空桶比例、链长分布、最长链、扩容次数与总字节数。
+ * 开启 `HASHMAP_STATS_COUNTERS` 时还包括累计的查找、探测与 `equals` 调用次数。
+ * 需要遍历整个桶数组，耗时与容量成正比，适合周期性巡检而非热路径。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @param out (HashmapStats*) 接收统计结果的结构体。
+ * @example
+ * HashmapStats stats;
+ * hashmap_stats(my_map, &stats);
+ * printf("load=%.2f max_chain=%d\n", stats.load_factor, stats.max_chain);
+ */
+#define hashmap_stats(map, out) __HASHMAP_FNS(map)->stats((map), (out))
+/**
+ * @brief 返回哈希表的内存占用：键值对本身、向分配器申请的字节数 (表头、桶数组、条目节点)，
+ * 以及分配器实际给出的字节数。耗时与 slab 数量成正比，不遍历桶数组。
+ * @param map (hashmap(K,V)) 哈希表实例。
+ * @return (ContainerMemoryUsage) 内存占用统计。
+ * @example
+ * ContainerMemoryUsage usage = hashmap_memory_usage(my_map);
+ * printf("%zu / %zu bytes\n", usage.logical_bytes, usage.allocated_bytes);
+ */
+#define hashmap_memory_usage(map) __HASHMAP_FNS(map)->memory_usage(map)
 /**
  * @brief 释放与哈希表相关的所有内存。
  * 包括所有条目、内部条目数组以及哈希表结构体本身。
@@ -515,7 +2153,7 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @param map (hashmap(K,V)) 哈希表实例。
  * @example hashmap_free(my_map);
  */
-#define hashmap_free(map) (map)->fns->free(map)
+#define hashmap_free(map) __HASHMAP_FNS(map)->free(map)
 // === 公共API: 迭代器宏 ===
 /**
  * @brief 声明一个哈希表迭代器变量。
@@ -531,14 +2169,14 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @return (hashmap_iterator(K,V)) 一个用于该哈希表的迭代器。
  * @example hashmap_iterator(cstr, int) it = hashmap_get_iterator(my_map);
  */
-#define hashmap_get_iterator(map) (map)->fns->get_iterator(map)
+#define hashmap_get_iterator(map) __HASHMAP_FNS(map)->get_iterator(map)
 /**
  * @brief 将迭代器推进到哈希表中的下一个元素。
  * @param iter (hashmap_iterator(K,V)*) 指向迭代器的指针。
  * @return (bool) 如果迭代器成功指向一个有效元素，则返回 `true`；如果已到达末尾，则返回 `false`。
  * @example while (hashmap_iterator_next(&it)) { ... }
  */
-#define hashmap_iterator_next(iter) (iter).map->fns->iterator_next(&(iter))
+#define hashmap_iterator_next(iter) __HASHMAP_FNS((iter).map)->iterator_next(&(iter))
 /**
  * @brief 检索迭代器当前位置的键。
  * 只有在成功调用 `hashmap_iterator_next` 后才能调用此宏。
@@ -546,7 +2184,7 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @return (const K*) 指向当前键的只读指针。
  * @example const cstr* key = hashmap_iterator_current_key(&it);
  */
-#define hashmap_iterator_current_key(iter) (iter).map->fns->iterator_current_key(&(iter))
+#define hashmap_iterator_current_key(iter) __HASHMAP_FNS((iter).map)->iterator_current_key(&(iter))
 /**
  * @brief 检索迭代器当前位置的值。
  * 只有在成功调用 `hashmap_iterator_next` 后才能调用此宏。
@@ -554,6 +2192,68 @@ static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {
  * @return (const V*) 指向当前值的只读指针。
  * @example const int* val = hashmap_iterator_current_value(&it);
  */
-#define hashmap_iterator_current_value(iter) (iter).map->fns->iterator_current_value(&(iter))
+#define hashmap_iterator_current_value(iter) __HASHMAP_FNS((iter).map)->iterator_current_value(&(iter))
+// === 公共API: 冻结哈希表 ===
+/**
+ * @brief 声明一个指向特定冻结哈希表类型的指针，由 `hashmap_freeze` 创建。
+ * @param K 在 HASHMAP_DEFINE 中使用的键类型。
+ * @param V 在 HASHMAP_DEFINE 中使用的值类型。
+ * @example frozen_hashmap(cstr, int) dict;
+ */
+#define frozen_hashmap(K, V) FrozenHashmap_##K##_##V*
+/**
+ * @brief 在冻结哈希表中查找键。
+ * @param map (frozen_hashmap(K,V)) 冻结哈希表实例。
+ * @param key (K) 要查找的键。
+ * @return (const V*) 指向值的常量指针；未找到则返回 NULL。
+ * @example const int* id = frozen_hashmap_get(dict, "hello");
+ */
+#define frozen_hashmap_get(map, key) __FROZEN_HASHMAP_FNS(map)->get((map), (key))
+/**
+ * @brief 检查冻结哈希表是否包含指定的键。
+ * @param map (frozen_hashmap(K,V)) 冻结哈希表实例。
+ * @param key (K) 要检查的键。
+ * @return (bool) 如果键存在，则返回 `true`；否则返回 `false`。
+ */
+#define frozen_hashmap_contains(map, key) __FROZEN_HASHMAP_FNS(map)->contains((map), (key))
+/**
+ * @brief 返回冻结哈希表中键值对的数量。
+ * @param map (frozen_hashmap(K,V)) 冻结哈希表实例。
+ * @return (int) 键值对数量。
+ */
+#define frozen_hashmap_size(map) (map)->size
+/**
+ * @brief 返回第 `index` 个键。所有键值对紧凑地存放在 `[0, frozen_hashmap_size(map))` 中，可直接按下标遍历。
+ * @param map (frozen_hashmap(K,V)) 冻结哈希表实例。
+ * @param index (int) 下标。
+ * @return (K) 键。
+ * @example for (int i = 0; i < frozen_hashmap_size(dict); i++) { puts(frozen_hashmap_key_at(dict, i)); }
+ */
+#define frozen_hashmap_key_at(map, index) __FROZEN_HASHMAP_FNS(map)->key_at((map), (index))
+/**
+ * @brief 返回第 `index` 个值，与 `frozen_hashmap_key_at(map, index)` 对应。
+ * @param map (frozen_hashmap(K,V)) 冻结哈希表实例。
+ * @param index (int) 下标。
+ * @return (V) 值。
+ */
+#define frozen_hashmap_value_at(map, index) (map)->values[(index)]
+/**
+ * @brief 将冻结哈希表的内容显示到给定的文件流。
+ * @param map (frozen_hashmap(K,V)) 冻结哈希表实例。
+ * @param stream (FILE*) 输出流。
+ */
+#define frozen_hashmap_display(map, stream) __FROZEN_HASHMAP_FNS(map)->display((map), (stream))
+/**
+ * @brief 把冻结哈希表保存为快照文件，格式与 `hashmap_save` 相同。
+ * @param map (frozen_hashmap(K,V)) 冻结哈希表实例。
+ * @param path (const char*) 目标文件路径。
+ * @return (bool) 成功返回 `true`，否则返回 `false`。
+ */
+#define frozen_hashmap_save(map, path) __FROZEN_HASHMAP_FNS(map)->save((map), (path))
+/**
+ * @brief 释放冻结哈希表的全部内存。
+ * @param map (frozen_hashmap(K,V)) 冻结哈希表实例。
+ */
+#define frozen_hashmap_free(map) __FROZEN_HASHMAP_FNS(map)->free(map)
 
 #endif // HASHMAP_H
\ No newline at end of file
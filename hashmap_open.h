@@ -0,0 +1,522 @@
+#ifndef HASHMAP_OPEN_H
+#define HASHMAP_OPEN_H
+
+#include "hashmap.h"
+
+/**
+ * @file hashmap_open.h
+ * @brief 基于开放寻址 (Robin Hood 探测) 的哈希表后端 (C-OOP-Container)。
+ *
+ * 与 `hashmap.h` 中的链式哈希表不同，本后端将键、值以及缓存的哈希值
+ * 直接内联存放在一个连续的槽位数组中：插入时不再为每个条目单独 `malloc`，
+ * 查找时也不再沿 `next` 指针在堆上跳转。冲突采用 Robin Hood 探测解决，
+ * 删除采用反向移位 (backward-shift) 而非墓碑标记，因此探测序列始终保持紧凑。
+ * 每个槽位的 `distance` 字段记录其探测距离加一，0 表示空槽。
+ * 槽位数组在第一次插入时才分配，从未插入过元素的哈希表只占用表头。
+ *
+ * 生成的类型与链式后端同名 (`Hashmap_K_V`)，并提供同一张函数表，
+ * 因此 `hashmap(K, V)`、`hashmap_new`、`hashmap_put/get/remove`、
+ * 迭代器等全部公共宏均可直接使用。同一对 `K, V` 只能选择一种后端。
+ *
+ * @note `hashmap_get` 与迭代器返回的指针直接指向槽位数组，
+ *       在下一次 `hashmap_put` 或 `hashmap_remove` 之后即失效。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+// --- Internal Macros ---
+#define __HASHMAP_OPEN_LOAD_FACTOR 0.875f
+
+// === 公共API: 定义宏 ===
+
+/**
+ * @brief 为指定的键值对类型定义一个具有默认行为的开放寻址哈希表。
+ *
+ * 与 `HASHMAP_DEFINE` 相同，为基本类型自动生成哈希、比较和显示函数，
+ * 但使用 Robin Hood 开放寻址作为存储结构。
+ *
+ * @note **重要提示**: `K` 和 `V` 的类型名不能包含空格或星号 (`*`)。
+ *       请使用 `typedef` 创建一个单一名词的别名。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ *
+ * @example
+ * HASHMAP_DEFINE_OPEN(int, int)
+ * hashmap(int, int) map = hashmap_new(int, int);
+ */
+#define HASHMAP_DEFINE_OPEN(K, V)                                                                                   \
+__HASHMAP_DEFINE_DEFAULT_FUNCTIONS(Hashmap, K, V)                                                                   \
+HASHMAP_DEFINE_OPEN_CUSTOM(K, V,                                                                                    \
+    Hashmap_##K##_##V##_hash,                                                                                       \
+    Hashmap_##K##_##V##_equals,                                                                                     \
+    Hashmap_##K##_##V##_key_display,                                                                                \
+    Hashmap_##K##_##V##_value_display                                                                               \
+)                                                                                                                   \
+/**
+ * @brief 定义一个具有自定义行为函数的开放寻址哈希表。
+ *
+ * 参数约定与 `HASHMAP_DEFINE_CUSTOM` 完全一致。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ * @param HashFn 用于哈希键的函数指针，类型为 `uint64_t (*)(K key)`。
+ * @param EqualsFn 用于比较键的函数指针，类型为 `bool (*)(K key1, K key2)`。
+ * @param DisplayKeyFn 用于打印键的函数指针，类型为 `void (*)(FILE* stream, K key)`。
+ * @param DisplayValueFn 用于打印值的函数指针，类型为 `void (*)(FILE* stream, V value)`。
+ */
+#define HASHMAP_DEFINE_OPEN_CUSTOM(K, V, HashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)                            \
+__HASHMAP_DEFINE_OPEN(K, V, 0, HashFn, NULL, EqualsFn, DisplayKeyFn, DisplayValueFn)                                \
+/**
+ * @brief 为指定的键值对类型定义一个使用带密钥哈希的开放寻址哈希表。
+ *
+ * 与 `HASHMAP_DEFINE_SEEDED` 相同：每个实例在创建时获得随机种子，默认使用 SipHash-1-3。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ */
+#define HASHMAP_DEFINE_OPEN_SEEDED(K, V)                                                                            \
+__HASHMAP_DEFINE_DEFAULT_FUNCTIONS(Hashmap, K, V)                                                                   \
+__HASHMAP_DEFINE_DEFAULT_KEYED_HASH(K, V)                                                                           \
+__HASHMAP_DEFINE_OPEN(K, V, 1,                                                                                      \
+    Hashmap_##K##_##V##_hash,                                                                                       \
+    Hashmap_##K##_##V##_keyed_hash,                                                                                 \
+    Hashmap_##K##_##V##_equals,                                                                                     \
+    Hashmap_##K##_##V##_key_display,                                                                                \
+    Hashmap_##K##_##V##_value_display                                                                               \
+)                                                                                                                   \
+/**
+ * @brief 定义一个使用自定义带密钥哈希函数的开放寻址哈希表。
+ *
+ * 参数约定与 `HASHMAP_DEFINE_SEEDED_CUSTOM` 完全一致。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ * @param KeyedHashFn 带密钥的哈希函数，类型为 `uint64_t (*)(K key, const HashmapSeed* seed)`。
+ * @param EqualsFn 用于比较键的函数指针，类型为 `bool (*)(K key1, K key2)`。
+ * @param DisplayKeyFn 用于打印键的函数指针，类型为 `void (*)(FILE* stream, K key)`。
+ * @param DisplayValueFn 用于打印值的函数指针，类型为 `void (*)(FILE* stream, V value)`。
+ */
+#define HASHMAP_DEFINE_OPEN_SEEDED_CUSTOM(K, V, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)                \
+__HASHMAP_DEFINE_OPEN(K, V, 1, NULL, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)
+
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_OPEN(K, V, Seeded, HashFn, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)            \
+                                                                                                                    \
+typedef struct __Hashmap_##K##_##V Hashmap_##K##_##V;                                                               \
+typedef struct __FrozenHashmap_##K##_##V FrozenHashmap_##K##_##V;                                                   \
+                                                                                                                    \
+struct HashmapEntry_##K##_##V {                                                                                     \
+    K key;                                                                                                          \
+    V value;                                                                                                        \
+    uint64_t hash;                                                                                                  \
+    int distance;                                                                                                   \
+};                                                                                                                  \
+                                                                                                                    \
+struct HashmapIterator_##K##_##V {                                                                                  \
+    Hashmap_##K##_##V* map;                                                                                         \
+    int index;                                                                                                      \
+    struct HashmapEntry_##K##_##V* entry;                                                                           \
+};                                                                                                                  \
+                                                                                                                    \
+struct Hashmap_##K##_##V##_Functions {                                                                              \
+    uint64_t (*hash)(K key);                                                                                        \
+    uint64_t (*keyed_hash)(K key, const HashmapSeed* seed);                                                         \
+    bool (*equals)(K key1, K key2);                                                                                 \
+    void (*display_key)(FILE* stream, K key);                                                                       \
+    void (*display_value)(FILE* stream, V value);                                                                   \
+    void (*display)(Hashmap_##K##_##V* self, FILE* stream);                                                         \
+    void (*put)(Hashmap_##K##_##V* self, K key, V value);                                                           \
+    const V* (*get)(Hashmap_##K##_##V* self, K key);                                                                \
+    V* (*get_mut)(Hashmap_##K##_##V* self, K key);                                                                  \
+    V* (*get_or_insert)(Hashmap_##K##_##V* self, K key, V default_value, bool* inserted);                           \
+    void (*put_many)(Hashmap_##K##_##V* self, const K* keys, const V* values, int n);                               \
+    int (*get_many)(Hashmap_##K##_##V* self, const K* keys, int n, const V** values);                               \
+    bool (*remove)(Hashmap_##K##_##V* self, K key);                                                                 \
+    bool (*contains)(Hashmap_##K##_##V* self, K key);                                                               \
+    void (*clear)(Hashmap_##K##_##V* self);                                                                         \
+    void (*reserve)(Hashmap_##K##_##V* self, int n);                                                                \
+    void (*shrink_to_fit)(Hashmap_##K##_##V* self);                                                                 \
+    struct HashmapIterator_##K##_##V (*get_iterator)(Hashmap_##K##_##V* self);                                      \
+    bool (*iterator_next)(struct HashmapIterator_##K##_##V* self);                                                  \
+    const K* (*iterator_current_key)(struct HashmapIterator_##K##_##V* self);                                       \
+    const V* (*iterator_current_value)(struct HashmapIterator_##K##_##V* self);                                     \
+    FrozenHashmap_##K##_##V* (*freeze)(Hashmap_##K##_##V* self);                                                    \
+    bool (*save)(Hashmap_##K##_##V* self, const char* path);                                                        \
+    void (*merge_into)(Hashmap_##K##_##V* self, Hashmap_##K##_##V* other,                                           \
+                       void (*combine)(V* value, V other_value));                                                   \
+    void (*stats)(Hashmap_##K##_##V* self, HashmapStats* stats);                                                    \
+    ContainerMemoryUsage (*memory_usage)(Hashmap_##K##_##V* self);                                                  \
+    void (*free)(Hashmap_##K##_##V* self);                                                                          \
+};                                                                                                                  \
+                                                                                                                    \
+struct __Hashmap_##K##_##V {                                                                                        \
+    const struct Hashmap_##K##_##V##_Functions* fns;                                                                \
+    struct HashmapEntry_##K##_##V* entries;                                                                         \
+    int size;                                                                                                       \
+    int capacity;                                                                                                   \
+    __HASHMAP_SEED_FIELD(Seeded)                                                                                    \
+    int resizes;                                                                                                    \
+    __HASHMAP_COUNTERS_FIELD                                                                                        \
+};                                                                                                                  \
+                                                                                                                    \
+const static struct Hashmap_##K##_##V##_Functions HASHMAP_##K##V##FUNCTIONS;                                        \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_track(long long bytes, int blocks) {                                                \
+    __CONTAINER_MEMORY_TRACK("hashmap(" #K ", " #V ")", bytes, blocks);                                             \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_free_entries(struct HashmapEntry_##K##_##V* entries, int capacity) {                \
+    if (entries != NULL) {                                                                                          \
+        Hashmap_##K##_##V##_track(-(long long) (capacity * sizeof(struct HashmapEntry_##K##_##V)), -1);             \
+    }                                                                                                               \
+    free(entries);                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_display(Hashmap_##K##_##V* self, FILE* stream) {                                    \
+    fprintf(stream, "{");                                                                                           \
+    int count = 0;                                                                                                  \
+    for (int i = 0; count < self->size; i++) {                                                                      \
+        struct HashmapEntry_##K##_##V* entry = &self->entries[i];                                                   \
+        if (entry->distance == 0) {                                                                                 \
+            continue;                                                                                               \
+        }                                                                                                           \
+        __HASHMAP_VTABLE(self, K, V)->display_key(stream, entry->key);                                              \
+        fprintf(stream, ": ");                                                                                      \
+        __HASHMAP_VTABLE(self, K, V)->display_value(stream, entry->value);                                          \
+        if (count < self->size - 1) {                                                                               \
+            fprintf(stream, ", ");                                                                                  \
+        }                                                                                                           \
+        count++;                                                                                                    \
+    }                                                                                                               \
+    fprintf(stream, "}");                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapEntry_##K##_##V* Hashmap_##K##_##V##_place(struct HashmapEntry_##K##_##V* entries,             \
+                                                                 int capacity,                                      \
+                                                                 struct HashmapEntry_##K##_##V entry) {             \
+    struct HashmapEntry_##K##_##V* placed = NULL;                                                                   \
+    int index = (int) (entry.hash & (capacity - 1));                                                                \
+    entry.distance = 1;                                                                                             \
+    while (true) {                                                                                                  \
+        struct HashmapEntry_##K##_##V* slot = &entries[index];                                                      \
+        if (slot->distance == 0) {                                                                                  \
+            *slot = entry;                                                                                          \
+            return placed != NULL ? placed : slot;                                                                  \
+        }                                                                                                           \
+        if (slot->distance < entry.distance) {                                                                      \
+            struct HashmapEntry_##K##_##V displaced = *slot;                                                        \
+            *slot = entry;                                                                                          \
+            entry = displaced;                                                                                      \
+            if (placed == NULL) {                                                                                   \
+                placed = slot;                                                                                      \
+            }                                                                                                       \
+        }                                                                                                           \
+        index = (index + 1) & (capacity - 1);                                                                       \
+        entry.distance++;                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_rehash(Hashmap_##K##_##V* self, int capacity) {                                     \
+    struct HashmapEntry_##K##_##V* old_entries = self->entries;                                                     \
+    int old_capacity = old_entries != NULL ? self->capacity : 0;                                                    \
+    self->resizes += old_entries != NULL;                                                                           \
+    self->capacity = capacity;                                                                                      \
+    self->entries =                                                                                                 \
+        (struct HashmapEntry_##K##_##V*) calloc(self->capacity, sizeof(struct HashmapEntry_##K##_##V));             \
+    Hashmap_##K##_##V##_track(self->capacity * sizeof(struct HashmapEntry_##K##_##V), 1);                           \
+    for (int i = 0; i < old_capacity; i++) {                                                                        \
+        if (old_entries[i].distance != 0) {                                                                         \
+            Hashmap_##K##_##V##_place(self->entries, self->capacity, old_entries[i]);                               \
+        }                                                                                                           \
+    }                                                                                                               \
+    Hashmap_##K##_##V##_free_entries(old_entries, old_capacity);                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_resize(Hashmap_##K##_##V* self) {                                                   \
+    Hashmap_##K##_##V##_rehash(self, self->capacity * 2);                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapEntry_##K##_##V* Hashmap_##K##_##V##_find(Hashmap_##K##_##V* self, K key, uint64_t hash) {     \
+    __HASHMAP_COUNT(self, lookups);                                                                                 \
+    if (self->entries == NULL) {                                                                                    \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    int index = (int) (hash & (self->capacity - 1));                                                                \
+    int distance = 1;                                                                                               \
+    while (self->entries[index].distance >= distance) {                                                             \
+        struct HashmapEntry_##K##_##V* slot = &self->entries[index];                                                \
+        __HASHMAP_COUNT(self, probes);                                                                              \
+        if (slot->hash == hash && __HASHMAP_KEY_EQUALS(self, K, V, slot->key, key)) {                               \
+            return slot;                                                                                            \
+        }                                                                                                           \
+        index = (index + 1) & (self->capacity - 1);                                                                 \
+        distance++;                                                                                                 \
+    }                                                                                                               \
+    return NULL;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static V* Hashmap_##K##_##V##_get_or_insert_hashed(Hashmap_##K##_##V* self, K key, uint64_t hash, V value,          \
+                                                 bool* inserted) {                                                  \
+    struct HashmapEntry_##K##_##V* slot = Hashmap_##K##_##V##_find(self, key, hash);                                \
+    if (slot != NULL) {                                                                                             \
+        *inserted = false;                                                                                          \
+        return &slot->value;                                                                                        \
+    }                                                                                                               \
+    if (self->entries == NULL) {                                                                                    \
+        Hashmap_##K##_##V##_rehash(self, self->capacity);                                                           \
+    } else if (self->size + 1 > self->capacity * __HASHMAP_OPEN_LOAD_FACTOR) {                                      \
+        Hashmap_##K##_##V##_resize(self);                                                                           \
+    }                                                                                                               \
+    struct HashmapEntry_##K##_##V entry = {                                                                         \
+        .key = key,                                                                                                 \
+        .value = value,                                                                                             \
+        .hash = hash                                                                                                \
+    };                                                                                                              \
+    slot = Hashmap_##K##_##V##_place(self->entries, self->capacity, entry);                                         \
+    self->size++;                                                                                                   \
+    *inserted = true;                                                                                               \
+    return &slot->value;                                                                                            \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_put_hashed(Hashmap_##K##_##V* self, K key, uint64_t hash, V value) {                \
+    bool inserted;                                                                                                  \
+    V* slot = Hashmap_##K##_##V##_get_or_insert_hashed(self, key, hash, value, &inserted);                          \
+    if (!inserted) {                                                                                                \
+        *slot = value;                                                                                              \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static V* Hashmap_##K##_##V##_get_or_insert(Hashmap_##K##_##V* self, K key, V default_value, bool* inserted) {      \
+    bool was_inserted;                                                                                              \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    V* slot = Hashmap_##K##_##V##_get_or_insert_hashed(self, key, hash, default_value, &was_inserted);              \
+    if (inserted != NULL) {                                                                                         \
+        *inserted = was_inserted;                                                                                   \
+    }                                                                                                               \
+    return slot;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_put(Hashmap_##K##_##V* self, K key, V value) {                                      \
+    Hashmap_##K##_##V##_put_hashed(self, key, __HASHMAP_HASH(self, K, V, Seeded, key), value);                      \
+}                                                                                                                   \
+                                                                                                                    \
+static V* Hashmap_##K##_##V##_get_mut(Hashmap_##K##_##V* self, K key) {                                             \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    struct HashmapEntry_##K##_##V* slot = Hashmap_##K##_##V##_find(self, key, hash);                                \
+    return slot != NULL ? &slot->value : NULL;                                                                      \
+}                                                                                                                   \
+                                                                                                                    \
+static const V* Hashmap_##K##_##V##_get(Hashmap_##K##_##V* self, K key) {                                           \
+    return Hashmap_##K##_##V##_get_mut(self, key);                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_put_many(Hashmap_##K##_##V* self, const K* keys, const V* values, int n) {          \
+    uint64_t hashes[__HASHMAP_BATCH_SIZE];                                                                          \
+    for (int base = 0; base < n; base += __HASHMAP_BATCH_SIZE) {                                                    \
+        int count = n - base < __HASHMAP_BATCH_SIZE ? n - base : __HASHMAP_BATCH_SIZE;                              \
+        if (self->entries == NULL) {                                                                                \
+            Hashmap_##K##_##V##_rehash(self, self->capacity);                                                       \
+        }                                                                                                           \
+        while (self->size + count > self->capacity * __HASHMAP_OPEN_LOAD_FACTOR) {                                  \
+            Hashmap_##K##_##V##_resize(self);                                                                       \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            hashes[i] = __HASHMAP_HASH(self, K, V, Seeded, keys[base + i]);                                         \
+            __builtin_prefetch(&self->entries[hashes[i] & (self->capacity - 1)], 1);                                \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            Hashmap_##K##_##V##_put_hashed(self, keys[base + i], hashes[i], values[base + i]);                      \
+        }                                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static int Hashmap_##K##_##V##_get_many(Hashmap_##K##_##V* self, const K* keys, int n, const V** values) {          \
+    uint64_t hashes[__HASHMAP_BATCH_SIZE];                                                                          \
+    int found = 0;                                                                                                  \
+    if (self->entries == NULL) {                                                                                    \
+        memset(values, 0, n * sizeof(const V*));                                                                    \
+        return 0;                                                                                                   \
+    }                                                                                                               \
+    for (int base = 0; base < n; base += __HASHMAP_BATCH_SIZE) {                                                    \
+        int count = n - base < __HASHMAP_BATCH_SIZE ? n - base : __HASHMAP_BATCH_SIZE;                              \
+        for (int i = 0; i < count; i++) {                                                                           \
+            hashes[i] = __HASHMAP_HASH(self, K, V, Seeded, keys[base + i]);                                         \
+            __builtin_prefetch(&self->entries[hashes[i] & (self->capacity - 1)]);                                   \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            struct HashmapEntry_##K##_##V* slot = Hashmap_##K##_##V##_find(self, keys[base + i], hashes[i]);        \
+            values[base + i] = slot != NULL ? &slot->value : NULL;                                                  \
+            found += slot != NULL;                                                                                  \
+        }                                                                                                           \
+    }                                                                                                               \
+    return found;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashmap_##K##_##V##_remove(Hashmap_##K##_##V* self, K key) {                                            \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    struct HashmapEntry_##K##_##V* slot = Hashmap_##K##_##V##_find(self, key, hash);                                \
+    if (slot == NULL) {                                                                                             \
+        return false;                                                                                               \
+    }                                                                                                               \
+    int index = (int) (slot - self->entries);                                                                       \
+    int next = (index + 1) & (self->capacity - 1);                                                                  \
+    while (self->entries[next].distance > 1) {                                                                      \
+        self->entries[index] = self->entries[next];                                                                 \
+        self->entries[index].distance--;                                                                            \
+        index = next;                                                                                               \
+        next = (next + 1) & (self->capacity - 1);                                                                   \
+    }                                                                                                               \
+    self->entries[index].distance = 0;                                                                              \
+    self->size--;                                                                                                   \
+    if (HASHMAP_AUTO_SHRINK && self->capacity > 16 &&                                                               \
+        self->size < self->capacity * __HASHMAP_OPEN_LOAD_FACTOR / 4) {                                             \
+        Hashmap_##K##_##V##_rehash(self, self->capacity / 2);                                                       \
+    }                                                                                                               \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashmap_##K##_##V##_contains(Hashmap_##K##_##V* self, K key) {                                          \
+    return Hashmap_##K##_##V##_get(self, key) != NULL;                                                              \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_clear(Hashmap_##K##_##V* self) {                                                    \
+    for (int i = 0; self->entries != NULL && i < self->capacity; i++) {                                             \
+        self->entries[i].distance = 0;                                                                              \
+    }                                                                                                               \
+    self->size = 0;                                                                                                 \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_reserve(Hashmap_##K##_##V* self, int n) {                                           \
+    int capacity = Hashmap_capacity_for(n, __HASHMAP_OPEN_LOAD_FACTOR);                                             \
+    if (capacity > self->capacity) {                                                                                \
+        Hashmap_##K##_##V##_rehash(self, capacity);                                                                 \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_shrink_to_fit(Hashmap_##K##_##V* self) {                                            \
+    int capacity = Hashmap_capacity_for(self->size, __HASHMAP_OPEN_LOAD_FACTOR);                                    \
+    if (self->size == 0) {                                                                                          \
+        Hashmap_##K##_##V##_free_entries(self->entries, self->capacity);                                            \
+        self->entries = NULL;                                                                                       \
+        self->capacity = capacity;                                                                                  \
+    } else if (capacity < self->capacity) {                                                                         \
+        Hashmap_##K##_##V##_rehash(self, capacity);                                                                 \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapIterator_##K##_##V Hashmap_##K##_##V##_get_iterator(Hashmap_##K##_##V* self) {                 \
+    struct HashmapIterator_##K##_##V iter = {                                                                       \
+        .map = self,                                                                                                \
+        .index = self->entries != NULL ? 0 : self->capacity,                                                        \
+        .entry = NULL                                                                                               \
+    };                                                                                                              \
+    return iter;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashmap_##K##_##V##_iterator_next(struct HashmapIterator_##K##_##V* self) {                             \
+    while (self->index < self->map->capacity) {                                                                     \
+        self->entry = &self->map->entries[self->index];                                                             \
+        self->index++;                                                                                              \
+        if (self->entry->distance != 0) {                                                                           \
+            return true;                                                                                            \
+        }                                                                                                           \
+    }                                                                                                               \
+    return false;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static const K* Hashmap_##K##_##V##_iterator_current_key(struct HashmapIterator_##K##_##V* self) {                  \
+    return &self->entry->key;                                                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+static const V* Hashmap_##K##_##V##_iterator_current_value(struct HashmapIterator_##K##_##V* self) {                \
+    return &self->entry->value;                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+static ContainerMemoryUsage Hashmap_##K##_##V##_memory_usage(Hashmap_##K##_##V* self) {                             \
+    ContainerMemoryUsage usage = {self->size * (sizeof(K) + sizeof(V)), 0, 0, 0};                                   \
+    ContainerMemory_add_block(&usage, self, sizeof(*self));                                                         \
+    ContainerMemory_add_block(&usage, self->entries, self->capacity * sizeof(struct HashmapEntry_##K##_##V));       \
+    return usage;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_stats(Hashmap_##K##_##V* self, HashmapStats* stats) {                               \
+    memset(stats, 0, sizeof(*stats));                                                                               \
+    stats->size = self->size;                                                                                       \
+    stats->resize_count = self->resizes;                                                                            \
+    stats->counters = __HASHMAP_COUNTERS(self);                                                                     \
+    stats->total_bytes = Hashmap_##K##_##V##_memory_usage(self).requested_bytes;                                    \
+    if (self->entries == NULL) {                                                                                    \
+        return;                                                                                                     \
+    }                                                                                                               \
+    uint16_t* homes = (uint16_t*) calloc(self->capacity, sizeof(uint16_t));                                         \
+    for (int i = 0; i < self->capacity; i++) {                                                                      \
+        struct HashmapEntry_##K##_##V* entry = &self->entries[i];                                                   \
+        if (entry->distance == 0) {                                                                                 \
+            continue;                                                                                               \
+        }                                                                                                           \
+        int home = (int) (entry->hash & (self->capacity - 1));                                                      \
+        homes[home] += homes[home] < UINT16_MAX;                                                                    \
+        if (entry->distance > stats->max_probe) {                                                                   \
+            stats->max_probe = entry->distance;                                                                     \
+        }                                                                                                           \
+    }                                                                                                               \
+    Hashmap_stats_add_homes(stats, homes, self->capacity);                                                          \
+    free(homes);                                                                                                    \
+    Hashmap_stats_finish(stats);                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_free(Hashmap_##K##_##V* self) {                                                     \
+    Hashmap_##K##_##V##_free_entries(self->entries, self->capacity);                                                \
+    Hashmap_##K##_##V##_track(-(long long) sizeof(*self), -1);                                                      \
+    free(self);                                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+__HASHMAP_DEFINE_MERGE(K, V)                                                                                        \
+__HASHMAP_DEFINE_FROZEN(K, V, Seeded)                                                                               \
+                                                                                                                    \
+const static struct Hashmap_##K##_##V##_Functions HASHMAP_##K##V##FUNCTIONS = {                                     \
+    .hash = HashFn,                                                                                                 \
+    .keyed_hash = KeyedHashFn,                                                                                      \
+    .equals = EqualsFn,                                                                                             \
+    .display_key = DisplayKeyFn,                                                                                    \
+    .display_value = DisplayValueFn,                                                                                \
+    .display = Hashmap_##K##_##V##_display,                                                                         \
+    .put = Hashmap_##K##_##V##_put,                                                                                 \
+    .remove = Hashmap_##K##_##V##_remove,                                                                           \
+    .contains = Hashmap_##K##_##V##_contains,                                                                       \
+    .clear = Hashmap_##K##_##V##_clear,                                                                             \
+    .reserve = Hashmap_##K##_##V##_reserve,                                                                         \
+    .shrink_to_fit = Hashmap_##K##_##V##_shrink_to_fit,                                                             \
+    .get = Hashmap_##K##_##V##_get,                                                                                 \
+    .get_mut = Hashmap_##K##_##V##_get_mut,                                                                         \
+    .get_or_insert = Hashmap_##K##_##V##_get_or_insert,                                                             \
+    .put_many = Hashmap_##K##_##V##_put_many,                                                                       \
+    .get_many = Hashmap_##K##_##V##_get_many,                                                                       \
+    .get_iterator = Hashmap_##K##_##V##_get_iterator,                                                               \
+    .iterator_next = Hashmap_##K##_##V##_iterator_next,                                                             \
+    .iterator_current_key = Hashmap_##K##_##V##_iterator_current_key,                                               \
+    .iterator_current_value = Hashmap_##K##_##V##_iterator_current_value,                                           \
+    .freeze = Hashmap_##K##_##V##_freeze,                                                                           \
+    .save = Hashmap_##K##_##V##_save,                                                                               \
+    .merge_into = Hashmap_##K##_##V##_merge_into,                                                                   \
+    .stats = Hashmap_##K##_##V##_stats,                                                                             \
+    .memory_usage = Hashmap_##K##_##V##_memory_usage,                                                               \
+    .free = Hashmap_##K##_##V##_free,                                                                               \
+};                                                                                                                  \
+                                                                                                                    \
+static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {                                                   \
+    Hashmap_##K##_##V* self = (Hashmap_##K##_##V*) malloc(sizeof(Hashmap_##K##_##V));                               \
+    self->fns = &HASHMAP_##K##V##FUNCTIONS;                                                                         \
+    __HASHMAP_SEED_INIT(self, Seeded);                                                                              \
+    self->entries = NULL;                                                                                           \
+    self->size = 0;                                                                                                 \
+    self->capacity = capacity;                                                                                      \
+    self->resizes = 0;                                                                                              \
+    __HASHMAP_COUNTERS_RESET(self);                                                                                 \
+    Hashmap_##K##_##V##_track(sizeof(*self), 1);                                                                    \
+    return self;                                                                                                    \
+}                                                                                                                   \
+
+#endif // HASHMAP_OPEN_H
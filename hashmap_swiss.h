@@ -0,0 +1,598 @@
+#ifndef HASHMAP_SWISS_H
+#define HASHMAP_SWISS_H
+
+#include "hashmap.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @file hashmap_swiss.h
+ * @brief 基于分组探测 (Swiss Table 风格) 的哈希表后端 (C-OOP-Container)。
+ *
+ * 本后端为每个槽位额外维护一个 1 字节的控制字节：空槽、已删除槽，
+ * 或由哈希值低 7 位构成的标签 (tag)。查找时一次比较 16 个控制字节
+ * (有 SSE2 时使用 `_mm_cmpeq_epi8`，否则退化为逐字节的标量实现)，
+ * 只有标签命中且缓存的哈希值相同时才会调用 `equals`，
+ * 因此对 `cstr` 等比较代价高的键，绝大多数 `strcmp` 调用都被省去。
+ * 控制字节与槽位数组在第一次插入时才分配，从未插入过元素的哈希表只占用表头。
+ *
+ * 生成的类型与链式后端同名 (`Hashmap_K_V`)，并提供同一张函数表，
+ * 因此全部 `hashmap_*` 公共宏均可直接使用。同一对 `K, V` 只能选择一种后端。
+ *
+ * @note `hashmap_get` 与迭代器返回的指针直接指向槽位数组，
+ *       在下一次 `hashmap_put` 或 `hashmap_remove` 之后即失效。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+// --- Internal Macros ---
+#define __HASHMAP_SWISS_GROUP_WIDTH 16
+// --- Internal Macros ---
+#define __HASHMAP_SWISS_EMPTY ((signed char) -128)
+// --- Internal Macros ---
+#define __HASHMAP_SWISS_DELETED ((signed char) -2)
+// --- Internal Macros ---
+#define __HASHMAP_SWISS_LOAD_FACTOR 0.875f
+
+// --- Internal Helper Functions ---
+static inline unsigned Hashmap_group_match(const signed char* ctrl, signed char tag) {
+#if defined(__SSE2__)
+    __m128i group = _mm_loadu_si128((const __m128i*) ctrl);
+    return (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(tag)));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < __HASHMAP_SWISS_GROUP_WIDTH; i++) {
+        mask |= (unsigned) (ctrl[i] == tag) << i;
+    }
+    return mask;
+#endif
+}
+// --- Internal Helper Functions ---
+static inline unsigned Hashmap_group_match_free(const signed char* ctrl) {
+#if defined(__SSE2__)
+    return (unsigned) _mm_movemask_epi8(_mm_loadu_si128((const __m128i*) ctrl));
+#else
+    unsigned mask = 0;
+    for (int i = 0; i < __HASHMAP_SWISS_GROUP_WIDTH; i++) {
+        mask |= (unsigned) (ctrl[i] < 0) << i;
+    }
+    return mask;
+#endif
+}
+
+// === 公共API: 定义宏 ===
+
+/**
+ * @brief 为指定的键值对类型定义一个具有默认行为的分组探测哈希表。
+ *
+ * 与 `HASHMAP_DEFINE` 相同，为基本类型自动生成哈希、比较和显示函数，
+ * 但使用 Swiss Table 风格的控制字节数组与分组探测作为存储结构。
+ *
+ * @note **重要提示**: `K` 和 `V` 的类型名不能包含空格或星号 (`*`)。
+ *       请使用 `typedef` 创建一个单一名词的别名。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ *
+ * @example
+ * typedef const char* cstr;
+ * HASHMAP_DEFINE_SWISS(cstr, int)
+ * hashmap(cstr, int) map = hashmap_new(cstr, int);
+ */
+#define HASHMAP_DEFINE_SWISS(K, V)                                                                                  \
+__HASHMAP_DEFINE_DEFAULT_FUNCTIONS(Hashmap, K, V)                                                                   \
+HASHMAP_DEFINE_SWISS_CUSTOM(K, V,                                                                                   \
+    Hashmap_##K##_##V##_hash,                                                                                       \
+    Hashmap_##K##_##V##_equals,                                                                                     \
+    Hashmap_##K##_##V##_key_display,                                                                                \
+    Hashmap_##K##_##V##_value_display                                                                               \
+)                                                                                                                   \
+/**
+ * @brief 定义一个具有自定义行为函数的分组探测哈希表。
+ *
+ * 参数约定与 `HASHMAP_DEFINE_CUSTOM` 完全一致。实际容量至少为一个分组 (16)。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ * @param HashFn 用于哈希键的函数指针，类型为 `uint64_t (*)(K key)`。
+ * @param EqualsFn 用于比较键的函数指针，类型为 `bool (*)(K key1, K key2)`。
+ * @param DisplayKeyFn 用于打印键的函数指针，类型为 `void (*)(FILE* stream, K key)`。
+ * @param DisplayValueFn 用于打印值的函数指针，类型为 `void (*)(FILE* stream, V value)`。
+ */
+#define HASHMAP_DEFINE_SWISS_CUSTOM(K, V, HashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)                           \
+__HASHMAP_DEFINE_SWISS(K, V, 0, HashFn, NULL, EqualsFn, DisplayKeyFn, DisplayValueFn)                               \
+/**
+ * @brief 为指定的键值对类型定义一个使用带密钥哈希的分组探测哈希表。
+ *
+ * 与 `HASHMAP_DEFINE_SEEDED` 相同：每个实例在创建时获得随机种子，默认使用 SipHash-1-3。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ */
+#define HASHMAP_DEFINE_SWISS_SEEDED(K, V)                                                                           \
+__HASHMAP_DEFINE_DEFAULT_FUNCTIONS(Hashmap, K, V)                                                                   \
+__HASHMAP_DEFINE_DEFAULT_KEYED_HASH(K, V)                                                                           \
+__HASHMAP_DEFINE_SWISS(K, V, 1,                                                                                     \
+    Hashmap_##K##_##V##_hash,                                                                                       \
+    Hashmap_##K##_##V##_keyed_hash,                                                                                 \
+    Hashmap_##K##_##V##_equals,                                                                                     \
+    Hashmap_##K##_##V##_key_display,                                                                                \
+    Hashmap_##K##_##V##_value_display                                                                               \
+)                                                                                                                   \
+/**
+ * @brief 定义一个使用自定义带密钥哈希函数的分组探测哈希表。
+ *
+ * 参数约定与 `HASHMAP_DEFINE_SEEDED_CUSTOM` 完全一致。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ * @param KeyedHashFn 带密钥的哈希函数，类型为 `uint64_t (*)(K key, const HashmapSeed* seed)`。
+ * @param EqualsFn 用于比较键的函数指针，类型为 `bool (*)(K key1, K key2)`。
+ * @param DisplayKeyFn 用于打印键的函数指针，类型为 `void (*)(FILE* stream, K key)`。
+ * @param DisplayValueFn 用于打印值的函数指针，类型为 `void (*)(FILE* stream, V value)`。
+ */
+#define HASHMAP_DEFINE_SWISS_SEEDED_CUSTOM(K, V, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)               \
+__HASHMAP_DEFINE_SWISS(K, V, 1, NULL, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)
+
+// --- Internal Macros ---
+#define __HASHMAP_DEFINE_SWISS(K, V, Seeded, HashFn, KeyedHashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)           \
+                                                                                                                    \
+typedef struct __Hashmap_##K##_##V Hashmap_##K##_##V;                                                               \
+typedef struct __FrozenHashmap_##K##_##V FrozenHashmap_##K##_##V;                                                   \
+                                                                                                                    \
+struct HashmapEntry_##K##_##V {                                                                                     \
+    K key;                                                                                                          \
+    V value;                                                                                                        \
+    uint64_t hash;                                                                                                  \
+};                                                                                                                  \
+                                                                                                                    \
+struct HashmapIterator_##K##_##V {                                                                                  \
+    Hashmap_##K##_##V* map;                                                                                         \
+    int index;                                                                                                      \
+    struct HashmapEntry_##K##_##V* entry;                                                                           \
+};                                                                                                                  \
+                                                                                                                    \
+struct Hashmap_##K##_##V##_Functions {                                                                              \
+    uint64_t (*hash)(K key);                                                                                        \
+    uint64_t (*keyed_hash)(K key, const HashmapSeed* seed);                                                         \
+    bool (*equals)(K key1, K key2);                                                                                 \
+    void (*display_key)(FILE* stream, K key);                                                                       \
+    void (*display_value)(FILE* stream, V value);                                                                   \
+    void (*display)(Hashmap_##K##_##V* self, FILE* stream);                                                         \
+    void (*put)(Hashmap_##K##_##V* self, K key, V value);                                                           \
+    const V* (*get)(Hashmap_##K##_##V* self, K key);                                                                \
+    V* (*get_mut)(Hashmap_##K##_##V* self, K key);                                                                  \
+    V* (*get_or_insert)(Hashmap_##K##_##V* self, K key, V default_value, bool* inserted);                           \
+    void (*put_many)(Hashmap_##K##_##V* self, const K* keys, const V* values, int n);                               \
+    int (*get_many)(Hashmap_##K##_##V* self, const K* keys, int n, const V** values);                               \
+    bool (*remove)(Hashmap_##K##_##V* self, K key);                                                                 \
+    bool (*contains)(Hashmap_##K##_##V* self, K key);                                                               \
+    void (*clear)(Hashmap_##K##_##V* self);                                                                         \
+    void (*reserve)(Hashmap_##K##_##V* self, int n);                                                                \
+    void (*shrink_to_fit)(Hashmap_##K##_##V* self);                                                                 \
+    struct HashmapIterator_##K##_##V (*get_iterator)(Hashmap_##K##_##V* self);                                      \
+    bool (*iterator_next)(struct HashmapIterator_##K##_##V* self);                                                  \
+    const K* (*iterator_current_key)(struct HashmapIterator_##K##_##V* self);                                       \
+    const V* (*iterator_current_value)(struct HashmapIterator_##K##_##V* self);                                     \
+    FrozenHashmap_##K##_##V* (*freeze)(Hashmap_##K##_##V* self);                                                    \
+    bool (*save)(Hashmap_##K##_##V* self, const char* path);                                                        \
+    void (*merge_into)(Hashmap_##K##_##V* self, Hashmap_##K##_##V* other,                                           \
+                       void (*combine)(V* value, V other_value));                                                   \
+    void (*stats)(Hashmap_##K##_##V* self, HashmapStats* stats);                                                    \
+    ContainerMemoryUsage (*memory_usage)(Hashmap_##K##_##V* self);                                                  \
+    void (*free)(Hashmap_##K##_##V* self);                                                                          \
+};                                                                                                                  \
+                                                                                                                    \
+struct __Hashmap_##K##_##V {                                                                                        \
+    const struct Hashmap_##K##_##V##_Functions* fns;                                                                \
+    signed char* ctrl;                                                                                              \
+    struct HashmapEntry_##K##_##V* entries;                                                                         \
+    int size;                                                                                                       \
+    int capacity;                                                                                                   \
+    __HASHMAP_SEED_FIELD(Seeded)                                                                                    \
+    int deleted;                                                                                                    \
+    int resizes;                                                                                                    \
+    __HASHMAP_COUNTERS_FIELD                                                                                        \
+};                                                                                                                  \
+                                                                                                                    \
+const static struct Hashmap_##K##_##V##_Functions HASHMAP_##K##V##FUNCTIONS;                                        \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_track(long long bytes, int blocks) {                                                \
+    __CONTAINER_MEMORY_TRACK("hashmap(" #K ", " #V ")", bytes, blocks);                                             \
+}                                                                                                                   \
+                                                                                                                    \
+static size_t Hashmap_##K##_##V##_slots_bytes(int capacity) {                                                       \
+    return capacity + __HASHMAP_SWISS_GROUP_WIDTH - 1 + capacity * sizeof(struct HashmapEntry_##K##_##V);           \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_display(Hashmap_##K##_##V* self, FILE* stream) {                                    \
+    fprintf(stream, "{");                                                                                           \
+    int count = 0;                                                                                                  \
+    for (int i = 0; count < self->size; i++) {                                                                      \
+        if (self->ctrl[i] < 0) {                                                                                    \
+            continue;                                                                                               \
+        }                                                                                                           \
+        __HASHMAP_VTABLE(self, K, V)->display_key(stream, self->entries[i].key);                                    \
+        fprintf(stream, ": ");                                                                                      \
+        __HASHMAP_VTABLE(self, K, V)->display_value(stream, self->entries[i].value);                                \
+        if (count < self->size - 1) {                                                                               \
+            fprintf(stream, ", ");                                                                                  \
+        }                                                                                                           \
+        count++;                                                                                                    \
+    }                                                                                                               \
+    fprintf(stream, "}");                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_set_ctrl(Hashmap_##K##_##V* self, int index, signed char tag) {                     \
+    self->ctrl[index] = tag;                                                                                        \
+    if (index < __HASHMAP_SWISS_GROUP_WIDTH - 1) {                                                                  \
+        self->ctrl[self->capacity + index] = tag;                                                                   \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_alloc(Hashmap_##K##_##V* self, int capacity) {                                      \
+    self->capacity = capacity;                                                                                      \
+    self->ctrl = (signed char*) malloc(capacity + __HASHMAP_SWISS_GROUP_WIDTH - 1);                                 \
+    memset(self->ctrl, __HASHMAP_SWISS_EMPTY, capacity + __HASHMAP_SWISS_GROUP_WIDTH - 1);                          \
+    self->entries = (struct HashmapEntry_##K##_##V*) malloc(capacity * sizeof(struct HashmapEntry_##K##_##V));      \
+    self->deleted = 0;                                                                                              \
+    Hashmap_##K##_##V##_track(Hashmap_##K##_##V##_slots_bytes(capacity), 2);                                        \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_release(signed char* ctrl, struct HashmapEntry_##K##_##V* entries, int capacity) {  \
+    if (ctrl != NULL) {                                                                                             \
+        Hashmap_##K##_##V##_track(-(long long) Hashmap_##K##_##V##_slots_bytes(capacity), -2);                      \
+    }                                                                                                               \
+    free(ctrl);                                                                                                     \
+    free(entries);                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static int Hashmap_##K##_##V##_find_free(Hashmap_##K##_##V* self, uint64_t hash) {                                  \
+    int mask = self->capacity - 1;                                                                                  \
+    int pos = (int) ((hash >> 7) & mask);                                                                           \
+    int step = 0;                                                                                                   \
+    while (true) {                                                                                                  \
+        unsigned free_slots = Hashmap_group_match_free(self->ctrl + pos);                                           \
+        if (free_slots != 0) {                                                                                      \
+            return (pos + __builtin_ctz(free_slots)) & mask;                                                        \
+        }                                                                                                           \
+        step += __HASHMAP_SWISS_GROUP_WIDTH;                                                                        \
+        pos = (pos + step) & mask;                                                                                  \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_rehash(Hashmap_##K##_##V* self, int capacity) {                                     \
+    signed char* old_ctrl = self->ctrl;                                                                             \
+    struct HashmapEntry_##K##_##V* old_entries = self->entries;                                                     \
+    int old_capacity = old_ctrl != NULL ? self->capacity : 0;                                                       \
+    self->resizes += old_ctrl != NULL;                                                                              \
+    Hashmap_##K##_##V##_alloc(self, capacity);                                                                      \
+    for (int i = 0; i < old_capacity; i++) {                                                                        \
+        if (old_ctrl[i] < 0) {                                                                                      \
+            continue;                                                                                               \
+        }                                                                                                           \
+        int index = Hashmap_##K##_##V##_find_free(self, old_entries[i].hash);                                       \
+        Hashmap_##K##_##V##_set_ctrl(self, index, (signed char) (old_entries[i].hash & 0x7F));                      \
+        self->entries[index] = old_entries[i];                                                                      \
+    }                                                                                                               \
+    Hashmap_##K##_##V##_release(old_ctrl, old_entries, old_capacity);                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapEntry_##K##_##V* Hashmap_##K##_##V##_find(Hashmap_##K##_##V* self, K key, uint64_t hash) {     \
+    __HASHMAP_COUNT(self, lookups);                                                                                 \
+    if (self->ctrl == NULL) {                                                                                       \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    int mask = self->capacity - 1;                                                                                  \
+    int pos = (int) ((hash >> 7) & mask);                                                                           \
+    int step = 0;                                                                                                   \
+    signed char tag = (signed char) (hash & 0x7F);                                                                  \
+    while (true) {                                                                                                  \
+        const signed char* group = self->ctrl + pos;                                                                \
+        __HASHMAP_COUNT(self, probes);                                                                              \
+        for (unsigned hits = Hashmap_group_match(group, tag); hits != 0; hits &= hits - 1) {                        \
+            struct HashmapEntry_##K##_##V* entry = &self->entries[(pos + __builtin_ctz(hits)) & mask];              \
+            if (entry->hash == hash && __HASHMAP_KEY_EQUALS(self, K, V, entry->key, key)) {                         \
+                return entry;                                                                                       \
+            }                                                                                                       \
+        }                                                                                                           \
+        if (Hashmap_group_match(group, __HASHMAP_SWISS_EMPTY) != 0) {                                               \
+            return NULL;                                                                                            \
+        }                                                                                                           \
+        step += __HASHMAP_SWISS_GROUP_WIDTH;                                                                        \
+        pos = (pos + step) & mask;                                                                                  \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_prefetch(Hashmap_##K##_##V* self, uint64_t hash) {                                  \
+    int pos = (int) ((hash >> 7) & (self->capacity - 1));                                                           \
+    __builtin_prefetch(self->ctrl + pos);                                                                           \
+    __builtin_prefetch(&self->entries[pos]);                                                                        \
+}                                                                                                                   \
+                                                                                                                    \
+static V* Hashmap_##K##_##V##_get_or_insert_hashed(Hashmap_##K##_##V* self, K key, uint64_t hash, V value,          \
+                                                 bool* inserted) {                                                  \
+    struct HashmapEntry_##K##_##V* entry = Hashmap_##K##_##V##_find(self, key, hash);                               \
+    if (entry != NULL) {                                                                                            \
+        *inserted = false;                                                                                          \
+        return &entry->value;                                                                                       \
+    }                                                                                                               \
+    if (self->ctrl == NULL) {                                                                                       \
+        Hashmap_##K##_##V##_alloc(self, self->capacity);                                                            \
+    } else if (self->size + self->deleted + 1 > self->capacity * __HASHMAP_SWISS_LOAD_FACTOR) {                     \
+        bool grow = self->size + 1 > self->capacity * __HASHMAP_SWISS_LOAD_FACTOR / 2;                              \
+        Hashmap_##K##_##V##_rehash(self, grow ? self->capacity * 2 : self->capacity);                               \
+    }                                                                                                               \
+    int index = Hashmap_##K##_##V##_find_free(self, hash);                                                          \
+    if (self->ctrl[index] == __HASHMAP_SWISS_DELETED) {                                                             \
+        self->deleted--;                                                                                            \
+    }                                                                                                               \
+    Hashmap_##K##_##V##_set_ctrl(self, index, (signed char) (hash & 0x7F));                                         \
+    self->entries[index].key = key;                                                                                 \
+    self->entries[index].value = value;                                                                             \
+    self->entries[index].hash = hash;                                                                               \
+    self->size++;                                                                                                   \
+    *inserted = true;                                                                                               \
+    return &self->entries[index].value;                                                                             \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_put_hashed(Hashmap_##K##_##V* self, K key, uint64_t hash, V value) {                \
+    bool inserted;                                                                                                  \
+    V* slot = Hashmap_##K##_##V##_get_or_insert_hashed(self, key, hash, value, &inserted);                          \
+    if (!inserted) {                                                                                                \
+        *slot = value;                                                                                              \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static V* Hashmap_##K##_##V##_get_or_insert(Hashmap_##K##_##V* self, K key, V default_value, bool* inserted) {      \
+    bool was_inserted;                                                                                              \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    V* slot = Hashmap_##K##_##V##_get_or_insert_hashed(self, key, hash, default_value, &was_inserted);              \
+    if (inserted != NULL) {                                                                                         \
+        *inserted = was_inserted;                                                                                   \
+    }                                                                                                               \
+    return slot;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_put(Hashmap_##K##_##V* self, K key, V value) {                                      \
+    Hashmap_##K##_##V##_put_hashed(self, key, __HASHMAP_HASH(self, K, V, Seeded, key), value);                      \
+}                                                                                                                   \
+                                                                                                                    \
+static V* Hashmap_##K##_##V##_get_mut(Hashmap_##K##_##V* self, K key) {                                             \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    struct HashmapEntry_##K##_##V* entry = Hashmap_##K##_##V##_find(self, key, hash);                               \
+    return entry != NULL ? &entry->value : NULL;                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static const V* Hashmap_##K##_##V##_get(Hashmap_##K##_##V* self, K key) {                                           \
+    return Hashmap_##K##_##V##_get_mut(self, key);                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_put_many(Hashmap_##K##_##V* self, const K* keys, const V* values, int n) {          \
+    uint64_t hashes[__HASHMAP_BATCH_SIZE];                                                                          \
+    for (int base = 0; base < n; base += __HASHMAP_BATCH_SIZE) {                                                    \
+        int count = n - base < __HASHMAP_BATCH_SIZE ? n - base : __HASHMAP_BATCH_SIZE;                              \
+        if (self->ctrl == NULL) {                                                                                   \
+            Hashmap_##K##_##V##_alloc(self, self->capacity);                                                        \
+        }                                                                                                           \
+        while (self->size + self->deleted + count > self->capacity * __HASHMAP_SWISS_LOAD_FACTOR) {                 \
+            bool grow = self->size + count > self->capacity * __HASHMAP_SWISS_LOAD_FACTOR / 2;                      \
+            Hashmap_##K##_##V##_rehash(self, grow ? self->capacity * 2 : self->capacity);                           \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            hashes[i] = __HASHMAP_HASH(self, K, V, Seeded, keys[base + i]);                                         \
+            Hashmap_##K##_##V##_prefetch(self, hashes[i]);                                                          \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            Hashmap_##K##_##V##_put_hashed(self, keys[base + i], hashes[i], values[base + i]);                      \
+        }                                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static int Hashmap_##K##_##V##_get_many(Hashmap_##K##_##V* self, const K* keys, int n, const V** values) {          \
+    uint64_t hashes[__HASHMAP_BATCH_SIZE];                                                                          \
+    int found = 0;                                                                                                  \
+    if (self->ctrl == NULL) {                                                                                       \
+        memset(values, 0, n * sizeof(const V*));                                                                    \
+        return 0;                                                                                                   \
+    }                                                                                                               \
+    for (int base = 0; base < n; base += __HASHMAP_BATCH_SIZE) {                                                    \
+        int count = n - base < __HASHMAP_BATCH_SIZE ? n - base : __HASHMAP_BATCH_SIZE;                              \
+        for (int i = 0; i < count; i++) {                                                                           \
+            hashes[i] = __HASHMAP_HASH(self, K, V, Seeded, keys[base + i]);                                         \
+            Hashmap_##K##_##V##_prefetch(self, hashes[i]);                                                          \
+        }                                                                                                           \
+        for (int i = 0; i < count; i++) {                                                                           \
+            struct HashmapEntry_##K##_##V* entry = Hashmap_##K##_##V##_find(self, keys[base + i], hashes[i]);       \
+            values[base + i] = entry != NULL ? &entry->value : NULL;                                                \
+            found += entry != NULL;                                                                                 \
+        }                                                                                                           \
+    }                                                                                                               \
+    return found;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashmap_##K##_##V##_remove(Hashmap_##K##_##V* self, K key) {                                            \
+    uint64_t hash = __HASHMAP_HASH(self, K, V, Seeded, key);                                                        \
+    struct HashmapEntry_##K##_##V* entry = Hashmap_##K##_##V##_find(self, key, hash);                               \
+    if (entry == NULL) {                                                                                            \
+        return false;                                                                                               \
+    }                                                                                                               \
+    int mask = self->capacity - 1;                                                                                  \
+    int index = (int) (entry - self->entries);                                                                      \
+    unsigned empty_after = Hashmap_group_match(self->ctrl + index, __HASHMAP_SWISS_EMPTY);                          \
+    unsigned empty_before = Hashmap_group_match(                                                                    \
+        self->ctrl + ((index - __HASHMAP_SWISS_GROUP_WIDTH) & mask), __HASHMAP_SWISS_EMPTY);                        \
+    bool was_never_full = empty_after != 0 && empty_before != 0 &&                                                  \
+        __builtin_ctz(empty_after) + __builtin_clz(empty_before << 16) < __HASHMAP_SWISS_GROUP_WIDTH;               \
+    if (was_never_full) {                                                                                           \
+        Hashmap_##K##_##V##_set_ctrl(self, index, __HASHMAP_SWISS_EMPTY);                                           \
+    } else {                                                                                                        \
+        Hashmap_##K##_##V##_set_ctrl(self, index, __HASHMAP_SWISS_DELETED);                                         \
+        self->deleted++;                                                                                            \
+    }                                                                                                               \
+    self->size--;                                                                                                   \
+    if (HASHMAP_AUTO_SHRINK && self->capacity > 16 &&                                                               \
+        self->size < self->capacity * __HASHMAP_SWISS_LOAD_FACTOR / 4) {                                            \
+        Hashmap_##K##_##V##_rehash(self, self->capacity / 2);                                                       \
+    }                                                                                                               \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashmap_##K##_##V##_contains(Hashmap_##K##_##V* self, K key) {                                          \
+    return Hashmap_##K##_##V##_get(self, key) != NULL;                                                              \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_clear(Hashmap_##K##_##V* self) {                                                    \
+    if (self->ctrl != NULL) {                                                                                       \
+        memset(self->ctrl, __HASHMAP_SWISS_EMPTY, self->capacity + __HASHMAP_SWISS_GROUP_WIDTH - 1);                \
+    }                                                                                                               \
+    self->size = 0;                                                                                                 \
+    self->deleted = 0;                                                                                              \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_reserve(Hashmap_##K##_##V* self, int n) {                                           \
+    int capacity = Hashmap_capacity_for(n, __HASHMAP_SWISS_LOAD_FACTOR);                                            \
+    if (capacity > self->capacity) {                                                                                \
+        Hashmap_##K##_##V##_rehash(self, capacity);                                                                 \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_shrink_to_fit(Hashmap_##K##_##V* self) {                                            \
+    int capacity = Hashmap_capacity_for(self->size, __HASHMAP_SWISS_LOAD_FACTOR);                                   \
+    if (self->size == 0) {                                                                                          \
+        Hashmap_##K##_##V##_release(self->ctrl, self->entries, self->capacity);                                     \
+        self->ctrl = NULL;                                                                                          \
+        self->entries = NULL;                                                                                       \
+        self->capacity = capacity;                                                                                  \
+        self->deleted = 0;                                                                                          \
+    } else if (capacity < self->capacity || self->deleted > 0) {                                                    \
+        Hashmap_##K##_##V##_rehash(self, capacity < self->capacity ? capacity : self->capacity);                    \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashmapIterator_##K##_##V Hashmap_##K##_##V##_get_iterator(Hashmap_##K##_##V* self) {                 \
+    struct HashmapIterator_##K##_##V iter = {                                                                       \
+        .map = self,                                                                                                \
+        .index = self->ctrl != NULL ? 0 : self->capacity,                                                           \
+        .entry = NULL                                                                                               \
+    };                                                                                                              \
+    return iter;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashmap_##K##_##V##_iterator_next(struct HashmapIterator_##K##_##V* self) {                             \
+    while (self->index < self->map->capacity) {                                                                     \
+        int index = self->index++;                                                                                  \
+        if (self->map->ctrl[index] >= 0) {                                                                          \
+            self->entry = &self->map->entries[index];                                                               \
+            return true;                                                                                            \
+        }                                                                                                           \
+    }                                                                                                               \
+    return false;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static const K* Hashmap_##K##_##V##_iterator_current_key(struct HashmapIterator_##K##_##V* self) {                  \
+    return &self->entry->key;                                                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+static const V* Hashmap_##K##_##V##_iterator_current_value(struct HashmapIterator_##K##_##V* self) {                \
+    return &self->entry->value;                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+static ContainerMemoryUsage Hashmap_##K##_##V##_memory_usage(Hashmap_##K##_##V* self) {                             \
+    ContainerMemoryUsage usage = {self->size * (sizeof(K) + sizeof(V)), 0, 0, 0};                                   \
+    ContainerMemory_add_block(&usage, self, sizeof(*self));                                                         \
+    ContainerMemory_add_block(&usage, self->ctrl, self->capacity + __HASHMAP_SWISS_GROUP_WIDTH - 1);                \
+    ContainerMemory_add_block(&usage, self->entries, self->capacity * sizeof(struct HashmapEntry_##K##_##V));       \
+    return usage;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_stats(Hashmap_##K##_##V* self, HashmapStats* stats) {                               \
+    memset(stats, 0, sizeof(*stats));                                                                               \
+    stats->size = self->size;                                                                                       \
+    stats->resize_count = self->resizes;                                                                            \
+    stats->counters = __HASHMAP_COUNTERS(self);                                                                     \
+    stats->total_bytes = Hashmap_##K##_##V##_memory_usage(self).requested_bytes;                                    \
+    if (self->ctrl == NULL) {                                                                                       \
+        return;                                                                                                     \
+    }                                                                                                               \
+    int mask = self->capacity - 1;                                                                                  \
+    uint16_t* homes = (uint16_t*) calloc(self->capacity, sizeof(uint16_t));                                         \
+    for (int i = 0; i < self->capacity; i++) {                                                                      \
+        if (self->ctrl[i] < 0) {                                                                                    \
+            continue;                                                                                               \
+        }                                                                                                           \
+        int pos = (int) ((self->entries[i].hash >> 7) & mask);                                                      \
+        homes[pos] += homes[pos] < UINT16_MAX;                                                                      \
+        int groups = 1;                                                                                             \
+        for (int step = __HASHMAP_SWISS_GROUP_WIDTH; ((i - pos) & mask) >= __HASHMAP_SWISS_GROUP_WIDTH;             \
+             step += __HASHMAP_SWISS_GROUP_WIDTH) {                                                                 \
+            pos = (pos + step) & mask;                                                                              \
+            groups++;                                                                                               \
+        }                                                                                                           \
+        if (groups > stats->max_probe) {                                                                            \
+            stats->max_probe = groups;                                                                              \
+        }                                                                                                           \
+    }                                                                                                               \
+    Hashmap_stats_add_homes(stats, homes, self->capacity);                                                          \
+    free(homes);                                                                                                    \
+    Hashmap_stats_finish(stats);                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashmap_##K##_##V##_free(Hashmap_##K##_##V* self) {                                                     \
+    Hashmap_##K##_##V##_release(self->ctrl, self->entries, self->capacity);                                         \
+    Hashmap_##K##_##V##_track(-(long long) sizeof(*self), -1);                                                      \
+    free(self);                                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+__HASHMAP_DEFINE_MERGE(K, V)                                                                                        \
+__HASHMAP_DEFINE_FROZEN(K, V, Seeded)                                                                               \
+                                                                                                                    \
+const static struct Hashmap_##K##_##V##_Functions HASHMAP_##K##V##FUNCTIONS = {                                     \
+    .hash = HashFn,                                                                                                 \
+    .keyed_hash = KeyedHashFn,                                                                                      \
+    .equals = EqualsFn,                                                                                             \
+    .display_key = DisplayKeyFn,                                                                                    \
+    .display_value = DisplayValueFn,                                                                                \
+    .display = Hashmap_##K##_##V##_display,                                                                         \
+    .put = Hashmap_##K##_##V##_put,                                                                                 \
+    .remove = Hashmap_##K##_##V##_remove,                                                                           \
+    .contains = Hashmap_##K##_##V##_contains,                                                                       \
+    .clear = Hashmap_##K##_##V##_clear,                                                                             \
+    .reserve = Hashmap_##K##_##V##_reserve,                                                                         \
+    .shrink_to_fit = Hashmap_##K##_##V##_shrink_to_fit,                                                             \
+    .get = Hashmap_##K##_##V##_get,                                                                                 \
+    .get_mut = Hashmap_##K##_##V##_get_mut,                                                                         \
+    .get_or_insert = Hashmap_##K##_##V##_get_or_insert,                                                             \
+    .put_many = Hashmap_##K##_##V##_put_many,                                                                       \
+    .get_many = Hashmap_##K##_##V##_get_many,                                                                       \
+    .get_iterator = Hashmap_##K##_##V##_get_iterator,                                                               \
+    .iterator_next = Hashmap_##K##_##V##_iterator_next,                                                             \
+    .iterator_current_key = Hashmap_##K##_##V##_iterator_current_key,                                               \
+    .iterator_current_value = Hashmap_##K##_##V##_iterator_current_value,                                           \
+    .freeze = Hashmap_##K##_##V##_freeze,                                                                           \
+    .save = Hashmap_##K##_##V##_save,                                                                               \
+    .merge_into = Hashmap_##K##_##V##_merge_into,                                                                   \
+    .stats = Hashmap_##K##_##V##_stats,                                                                             \
+    .memory_usage = Hashmap_##K##_##V##_memory_usage,                                                               \
+    .free = Hashmap_##K##_##V##_free,                                                                               \
+};                                                                                                                  \
+                                                                                                                    \
+static Hashmap_##K##_##V* Hashmap_##K##_##V##_new(int capacity) {                                                   \
+    Hashmap_##K##_##V* self = (Hashmap_##K##_##V*) malloc(sizeof(Hashmap_##K##_##V));                               \
+    self->fns = &HASHMAP_##K##V##FUNCTIONS;                                                                         \
+    __HASHMAP_SEED_INIT(self, Seeded);                                                                              \
+    self->ctrl = NULL;                                                                                              \
+    self->entries = NULL;                                                                                           \
+    self->size = 0;                                                                                                 \
+    self->capacity = capacity < __HASHMAP_SWISS_GROUP_WIDTH ? __HASHMAP_SWISS_GROUP_WIDTH : capacity;               \
+    self->deleted = 0;                                                                                              \
+    self->resizes = 0;                                                                                              \
+    __HASHMAP_COUNTERS_RESET(self);                                                                                 \
+    Hashmap_##K##_##V##_track(sizeof(*self), 1);                                                                    \
+    return self;                                                                                                    \
+}                                                                                                                   \
+
+#endif // HASHMAP_SWISS_H
@@ -0,0 +1,559 @@
+#ifndef HASHSET_H
+#define HASHSET_H
+
+#include "hashmap.h"
+
+/**
+ * @file hashset.h
+ * @brief 一个只存储键、不存储值的泛型哈希集合 (C-OOP-Container)。
+ *
+ * 用 `hashmap(K, bool)` 表示集合时，每个成员都要为用不到的 `V value` 字段
+ * 以及链式条目的 `next` 指针、64 位哈希值付出内存。哈希集合把成员直接内联存放在
+ * 一个连续的槽位数组中，每个槽位只有键本身、32 位哈希值与探测距离
+ * (对 `int` 键为 12 字节)，冲突采用与 `hashmap_open.h` 相同的 Robin Hood 探测，
+ * 删除采用反向移位。槽位数组的容量不超过 2^30，32 位哈希值足以确定槽位，
+ * 扩容与集合运算因此都不需要重新计算哈希。槽位数组在第一次插入时才分配。
+ *
+ * 哈希、相等性与显示函数的约定与 `HASHMAP_DEFINE_CUSTOM` 完全一致，
+ * `HASHSET_DEFINE` 为基本类型生成的默认函数也与 `HASHMAP_DEFINE` 相同。
+ *
+ * 并集、交集与差集总是遍历两个集合中较小的一个，在较大的一个中查找，
+ * 运算代价与较小集合的大小成正比。
+ *
+ * @note 迭代器返回的指针直接指向槽位数组，在下一次 `hashset_insert` 或
+ *       `hashset_remove` 之后即失效。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+// === 公共API: 编译期配置 ===
+
+/**
+ * @brief 静态分派模式下需要直接绑定的哈希集合类型列表，用法与 `COOP_HASHMAP_TYPES` 相同，
+ *        但每一项只有一个参数，例如 `#define COOP_HASHSET_TYPES(X) X(int) X(cstr)`。
+ */
+#ifndef COOP_HASHSET_TYPES
+#define COOP_HASHSET_TYPES(X)
+#endif
+
+// --- Internal Macros ---
+#define __HASHSET_LOAD_FACTOR 0.875f
+#ifdef COOP_STATIC_DISPATCH
+// --- Internal Macros ---
+#define __HASHSET_VTABLE(self, K) (&HASHSET_##K##FUNCTIONS)
+// --- Internal Macros ---
+#define __HASHSET_FNS_CASE(K) Hashset_##K*: &HASHSET_##K##FUNCTIONS,
+// --- Internal Macros ---
+#define __HASHSET_FNS(set) _Generic((set), COOP_HASHSET_TYPES(__HASHSET_FNS_CASE) default: (set)->fns)
+#else
+// --- Internal Macros ---
+#define __HASHSET_VTABLE(self, K) ((self)->fns)
+// --- Internal Macros ---
+#define __HASHSET_FNS(set) (set)->fns
+#endif
+
+// === 公共API: 定义宏 ===
+
+/**
+ * @brief 为指定的元素类型定义一个具有默认行为的哈希集合。
+ *
+ * 与 `HASHMAP_DEFINE` 相同，为基本类型（整型、浮点型、指针、const char*）
+ * 自动生成哈希、比较和显示函数。
+ *
+ * @note **重要提示**: `K` 的类型名不能包含空格或星号 (`*`)。
+ *       请使用 `typedef` 创建一个单一名词的别名。
+ *
+ * @param K 元素的类型（必须是单个词）。
+ *
+ * @example
+ * typedef const char* cstr;
+ * HASHSET_DEFINE(cstr)
+ * hashset(cstr) seen = hashset_new(cstr);
+ */
+#define HASHSET_DEFINE(K)                                                                                           \
+__HASHMAP_DEFINE_DEFAULT_KEY_FUNCTIONS(Hashset_##K, K)                                                              \
+HASHSET_DEFINE_CUSTOM(K,                                                                                            \
+    Hashset_##K##_hash,                                                                                             \
+    Hashset_##K##_equals,                                                                                           \
+    Hashset_##K##_key_display                                                                                       \
+)                                                                                                                   \
+/**
+ * @brief 定义一个具有自定义行为函数的哈希集合。
+ *
+ * @note **重要提示**: `K` 的类型名不能包含空格或星号 (`*`)。
+ *       请使用 `typedef` 创建一个单一名词的别名。
+ *
+ * @param K 元素的类型（必须是单个词）。
+ * @param HashFn 用于哈希元素的函数指针，类型为 `uint64_t (*)(K key)`。
+ * @param EqualsFn 用于比较元素的函数指针，类型为 `bool (*)(K key1, K key2)`。
+ * @param DisplayFn 用于打印元素的函数指针，类型为 `void (*)(FILE* stream, K key)`。
+ */
+#define HASHSET_DEFINE_CUSTOM(K, HashFn, EqualsFn, DisplayFn)                                                       \
+                                                                                                                    \
+typedef struct __Hashset_##K Hashset_##K;                                                                           \
+                                                                                                                    \
+struct HashsetEntry_##K {                                                                                           \
+    K key;                                                                                                          \
+    uint32_t hash;                                                                                                  \
+    int distance;                                                                                                   \
+};                                                                                                                  \
+                                                                                                                    \
+struct HashsetIterator_##K {                                                                                        \
+    Hashset_##K* set;                                                                                               \
+    int index;                                                                                                      \
+    struct HashsetEntry_##K* entry;                                                                                 \
+};                                                                                                                  \
+                                                                                                                    \
+struct Hashset_##K##_Functions {                                                                                    \
+    uint64_t (*hash)(K key);                                                                                        \
+    bool (*equals)(K key1, K key2);                                                                                 \
+    void (*display_key)(FILE* stream, K key);                                                                       \
+    void (*display)(Hashset_##K* self, FILE* stream);                                                               \
+    bool (*insert)(Hashset_##K* self, K key);                                                                       \
+    bool (*remove)(Hashset_##K* self, K key);                                                                       \
+    bool (*contains)(Hashset_##K* self, K key);                                                                     \
+    void (*clear)(Hashset_##K* self);                                                                               \
+    void (*reserve)(Hashset_##K* self, int n);                                                                      \
+    void (*shrink_to_fit)(Hashset_##K* self);                                                                       \
+    Hashset_##K* (*clone)(Hashset_##K* self);                                                                       \
+    Hashset_##K* (*set_union)(Hashset_##K* self, Hashset_##K* other);                                               \
+    Hashset_##K* (*set_intersection)(Hashset_##K* self, Hashset_##K* other);                                        \
+    Hashset_##K* (*set_difference)(Hashset_##K* self, Hashset_##K* other);                                          \
+    struct HashsetIterator_##K (*get_iterator)(Hashset_##K* self);                                                  \
+    bool (*iterator_next)(struct HashsetIterator_##K* self);                                                        \
+    const K* (*iterator_current)(struct HashsetIterator_##K* self);                                                 \
+    void (*free)(Hashset_##K* self);                                                                                \
+};                                                                                                                  \
+                                                                                                                    \
+struct __Hashset_##K {                                                                                              \
+    const struct Hashset_##K##_Functions* fns;                                                                      \
+    struct HashsetEntry_##K* entries;                                                                               \
+    int size;                                                                                                       \
+    int capacity;                                                                                                   \
+};                                                                                                                  \
+                                                                                                                    \
+const static struct Hashset_##K##_Functions HASHSET_##K##FUNCTIONS;                                                 \
+                                                                                                                    \
+static void Hashset_##K##_display(Hashset_##K* self, FILE* stream) {                                                \
+    fprintf(stream, "{");                                                                                           \
+    int count = 0;                                                                                                  \
+    for (int i = 0; count < self->size; i++) {                                                                      \
+        struct HashsetEntry_##K* entry = &self->entries[i];                                                         \
+        if (entry->distance == 0) {                                                                                 \
+            continue;                                                                                               \
+        }                                                                                                           \
+        __HASHSET_VTABLE(self, K)->display_key(stream, entry->key);                                                 \
+        if (count < self->size - 1) {                                                                               \
+            fprintf(stream, ", ");                                                                                  \
+        }                                                                                                           \
+        count++;                                                                                                    \
+    }                                                                                                               \
+    fprintf(stream, "}");                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashset_##K##_place(struct HashsetEntry_##K* entries, int capacity, struct HashsetEntry_##K entry) {    \
+    int index = (int) (entry.hash & (capacity - 1));                                                                \
+    entry.distance = 1;                                                                                             \
+    while (true) {                                                                                                  \
+        struct HashsetEntry_##K* slot = &entries[index];                                                            \
+        if (slot->distance == 0) {                                                                                  \
+            *slot = entry;                                                                                          \
+            return;                                                                                                 \
+        }                                                                                                           \
+        if (slot->distance < entry.distance) {                                                                      \
+            struct HashsetEntry_##K displaced = *slot;                                                              \
+            *slot = entry;                                                                                          \
+            entry = displaced;                                                                                      \
+        }                                                                                                           \
+        index = (index + 1) & (capacity - 1);                                                                       \
+        entry.distance++;                                                                                           \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashset_##K##_rehash(Hashset_##K* self, int capacity) {                                                 \
+    struct HashsetEntry_##K* old_entries = self->entries;                                                           \
+    int old_capacity = old_entries != NULL ? self->capacity : 0;                                                    \
+    self->capacity = capacity;                                                                                      \
+    self->entries = (struct HashsetEntry_##K*) calloc(self->capacity, sizeof(struct HashsetEntry_##K));             \
+    for (int i = 0; i < old_capacity; i++) {                                                                        \
+        if (old_entries[i].distance != 0) {                                                                         \
+            Hashset_##K##_place(self->entries, self->capacity, old_entries[i]);                                     \
+        }                                                                                                           \
+    }                                                                                                               \
+    free(old_entries);                                                                                              \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashsetEntry_##K* Hashset_##K##_find(Hashset_##K* self, K key, uint32_t hash) {                       \
+    if (self->entries == NULL) {                                                                                    \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    int index = (int) (hash & (self->capacity - 1));                                                                \
+    int distance = 1;                                                                                               \
+    while (self->entries[index].distance >= distance) {                                                             \
+        struct HashsetEntry_##K* slot = &self->entries[index];                                                      \
+        if (slot->hash == hash && __HASHSET_VTABLE(self, K)->equals(slot->key, key)) {                              \
+            return slot;                                                                                            \
+        }                                                                                                           \
+        index = (index + 1) & (self->capacity - 1);                                                                 \
+        distance++;                                                                                                 \
+    }                                                                                                               \
+    return NULL;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashset_##K##_insert_hashed(Hashset_##K* self, K key, uint32_t hash) {                                  \
+    if (Hashset_##K##_find(self, key, hash) != NULL) {                                                              \
+        return false;                                                                                               \
+    }                                                                                                               \
+    if (self->entries == NULL) {                                                                                    \
+        Hashset_##K##_rehash(self, self->capacity);                                                                 \
+    } else if (self->size + 1 > self->capacity * __HASHSET_LOAD_FACTOR) {                                           \
+        Hashset_##K##_rehash(self, self->capacity * 2);                                                             \
+    }                                                                                                               \
+    struct HashsetEntry_##K entry = {                                                                               \
+        .key = key,                                                                                                 \
+        .hash = hash                                                                                                \
+    };                                                                                                              \
+    Hashset_##K##_place(self->entries, self->capacity, entry);                                                      \
+    self->size++;                                                                                                   \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashset_##K##_remove_slot(Hashset_##K* self, struct HashsetEntry_##K* slot) {                           \
+    int index = (int) (slot - self->entries);                                                                       \
+    int next = (index + 1) & (self->capacity - 1);                                                                  \
+    while (self->entries[next].distance > 1) {                                                                      \
+        self->entries[index] = self->entries[next];                                                                 \
+        self->entries[index].distance--;                                                                            \
+        index = next;                                                                                               \
+        next = (next + 1) & (self->capacity - 1);                                                                   \
+    }                                                                                                               \
+    self->entries[index].distance = 0;                                                                              \
+    self->size--;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashset_##K##_insert(Hashset_##K* self, K key) {                                                        \
+    return Hashset_##K##_insert_hashed(self, key, (uint32_t) __HASHSET_VTABLE(self, K)->hash(key));                 \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashset_##K##_contains(Hashset_##K* self, K key) {                                                      \
+    return Hashset_##K##_find(self, key, (uint32_t) __HASHSET_VTABLE(self, K)->hash(key)) != NULL;                  \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashset_##K##_remove(Hashset_##K* self, K key) {                                                        \
+    struct HashsetEntry_##K* slot =                                                                                 \
+        Hashset_##K##_find(self, key, (uint32_t) __HASHSET_VTABLE(self, K)->hash(key));                             \
+    if (slot == NULL) {                                                                                             \
+        return false;                                                                                               \
+    }                                                                                                               \
+    Hashset_##K##_remove_slot(self, slot);                                                                          \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashset_##K##_clear(Hashset_##K* self) {                                                                \
+    if (self->entries != NULL) {                                                                                    \
+        memset(self->entries, 0, self->capacity * sizeof(struct HashsetEntry_##K));                                 \
+    }                                                                                                               \
+    self->size = 0;                                                                                                 \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashset_##K##_reserve(Hashset_##K* self, int n) {                                                       \
+    int capacity = Hashmap_capacity_for(n, __HASHSET_LOAD_FACTOR);                                                  \
+    if (capacity > self->capacity) {                                                                                \
+        Hashset_##K##_rehash(self, capacity);                                                                       \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashset_##K##_shrink_to_fit(Hashset_##K* self) {                                                        \
+    int capacity = Hashmap_capacity_for(self->size, __HASHSET_LOAD_FACTOR);                                         \
+    if (self->size == 0) {                                                                                          \
+        free(self->entries);                                                                                        \
+        self->entries = NULL;                                                                                       \
+        self->capacity = capacity;                                                                                  \
+    } else if (capacity < self->capacity) {                                                                         \
+        Hashset_##K##_rehash(self, capacity);                                                                       \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static struct HashsetIterator_##K Hashset_##K##_get_iterator(Hashset_##K* self) {                                   \
+    struct HashsetIterator_##K iter = {                                                                             \
+        .set = self,                                                                                                \
+        .index = self->entries != NULL ? 0 : self->capacity,                                                        \
+        .entry = NULL                                                                                               \
+    };                                                                                                              \
+    return iter;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool Hashset_##K##_iterator_next(struct HashsetIterator_##K* self) {                                         \
+    while (self->index < self->set->capacity) {                                                                     \
+        self->entry = &self->set->entries[self->index];                                                             \
+        self->index++;                                                                                              \
+        if (self->entry->distance != 0) {                                                                           \
+            return true;                                                                                            \
+        }                                                                                                           \
+    }                                                                                                               \
+    return false;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static const K* Hashset_##K##_iterator_current(struct HashsetIterator_##K* self) {                                  \
+    return &self->entry->key;                                                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+static void Hashset_##K##_free(Hashset_##K* self) {                                                                 \
+    free(self->entries);                                                                                            \
+    free(self);                                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+static Hashset_##K* Hashset_##K##_new(int capacity);                                                                \
+                                                                                                                    \
+static Hashset_##K* Hashset_##K##_clone(Hashset_##K* self) {                                                        \
+    Hashset_##K* copy = Hashset_##K##_new(self->capacity);                                                          \
+    if (self->entries != NULL) {                                                                                    \
+        copy->entries = (struct HashsetEntry_##K*) malloc(self->capacity * sizeof(struct HashsetEntry_##K));        \
+        memcpy(copy->entries, self->entries, self->capacity * sizeof(struct HashsetEntry_##K));                     \
+        copy->size = self->size;                                                                                    \
+    }                                                                                                               \
+    return copy;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static Hashset_##K* Hashset_##K##_union(Hashset_##K* self, Hashset_##K* other) {                                    \
+    Hashset_##K* larger = self->size >= other->size ? self : other;                                                 \
+    Hashset_##K* smaller = larger == self ? other : self;                                                           \
+    Hashset_##K* result = Hashset_##K##_clone(larger);                                                              \
+    for (int i = 0, seen = 0; seen < smaller->size; i++) {                                                          \
+        struct HashsetEntry_##K* entry = &smaller->entries[i];                                                      \
+        if (entry->distance != 0) {                                                                                 \
+            Hashset_##K##_insert_hashed(result, entry->key, entry->hash);                                           \
+            seen++;                                                                                                 \
+        }                                                                                                           \
+    }                                                                                                               \
+    return result;                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static Hashset_##K* Hashset_##K##_intersection(Hashset_##K* self, Hashset_##K* other) {                             \
+    Hashset_##K* larger = self->size >= other->size ? self : other;                                                 \
+    Hashset_##K* smaller = larger == self ? other : self;                                                           \
+    Hashset_##K* result = Hashset_##K##_new(Hashmap_capacity_for(smaller->size, __HASHSET_LOAD_FACTOR));            \
+    for (int i = 0, seen = 0; seen < smaller->size; i++) {                                                          \
+        struct HashsetEntry_##K* entry = &smaller->entries[i];                                                      \
+        if (entry->distance == 0) {                                                                                 \
+            continue;                                                                                               \
+        }                                                                                                           \
+        if (Hashset_##K##_find(larger, entry->key, entry->hash) != NULL) {                                          \
+            Hashset_##K##_insert_hashed(result, entry->key, entry->hash);                                           \
+        }                                                                                                           \
+        seen++;                                                                                                     \
+    }                                                                                                               \
+    return result;                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+static Hashset_##K* Hashset_##K##_difference(Hashset_##K* self, Hashset_##K* other) {                               \
+    if (self->size <= other->size) {                                                                                \
+        Hashset_##K* result = Hashset_##K##_new(Hashmap_capacity_for(self->size, __HASHSET_LOAD_FACTOR));           \
+        for (int i = 0, seen = 0; seen < self->size; i++) {                                                         \
+            struct HashsetEntry_##K* entry = &self->entries[i];                                                     \
+            if (entry->distance == 0) {                                                                             \
+                continue;                                                                                           \
+            }                                                                                                       \
+            if (Hashset_##K##_find(other, entry->key, entry->hash) == NULL) {                                       \
+                Hashset_##K##_insert_hashed(result, entry->key, entry->hash);                                       \
+            }                                                                                                       \
+            seen++;                                                                                                 \
+        }                                                                                                           \
+        return result;                                                                                              \
+    }                                                                                                               \
+    Hashset_##K* result = Hashset_##K##_clone(self);                                                                \
+    for (int i = 0, seen = 0; seen < other->size; i++) {                                                            \
+        struct HashsetEntry_##K* entry = &other->entries[i];                                                        \
+        if (entry->distance == 0) {                                                                                 \
+            continue;                                                                                               \
+        }                                                                                                           \
+        struct HashsetEntry_##K* slot = Hashset_##K##_find(result, entry->key, entry->hash);                        \
+        if (slot != NULL) {                                                                                         \
+            Hashset_##K##_remove_slot(result, slot);                                                                \
+        }                                                                                                           \
+        seen++;                                                                                                     \
+    }                                                                                                               \
+    return result;                                                                                                  \
+}                                                                                                                   \
+                                                                                                                    \
+const static struct Hashset_##K##_Functions HASHSET_##K##FUNCTIONS = {                                              \
+    .hash = HashFn,                                                                                                 \
+    .equals = EqualsFn,                                                                                             \
+    .display_key = DisplayFn,                                                                                       \
+    .display = Hashset_##K##_display,                                                                               \
+    .insert = Hashset_##K##_insert,                                                                                 \
+    .remove = Hashset_##K##_remove,                                                                                 \
+    .contains = Hashset_##K##_contains,                                                                             \
+    .clear = Hashset_##K##_clear,                                                                                   \
+    .reserve = Hashset_##K##_reserve,                                                                               \
+    .shrink_to_fit = Hashset_##K##_shrink_to_fit,                                                                   \
+    .clone = Hashset_##K##_clone,                                                                                   \
+    .set_union = Hashset_##K##_union,                                                                               \
+    .set_intersection = Hashset_##K##_intersection,                                                                 \
+    .set_difference = Hashset_##K##_difference,                                                                     \
+    .get_iterator = Hashset_##K##_get_iterator,                                                                     \
+    .iterator_next = Hashset_##K##_iterator_next,                                                                   \
+    .iterator_current = Hashset_##K##_iterator_current,                                                             \
+    .free = Hashset_##K##_free,                                                                                     \
+};                                                                                                                  \
+                                                                                                                    \
+static Hashset_##K* Hashset_##K##_new(int capacity) {                                                               \
+    Hashset_##K* self = (Hashset_##K*) malloc(sizeof(Hashset_##K));                                                 \
+    self->fns = &HASHSET_##K##FUNCTIONS;                                                                            \
+    self->entries = NULL;                                                                                           \
+    self->size = 0;                                                                                                 \
+    self->capacity = capacity;                                                                                      \
+    return self;                                                                                                    \
+}                                                                                                                   \
+
+// === 公共API: 类型与构造函数宏 ===
+/**
+ * @brief 声明一个指向特定哈希集合类型的指针。
+ * @param K 在 HASHSET_DEFINE 中使用的元素类型。
+ * @example hashset(int) my_set;
+ */
+#define hashset(K) Hashset_##K*
+/**
+ * @brief 创建一个具有默认初始容量 (16 个槽位) 的新哈希集合。
+ * @param K 元素的类型。
+ * @return 指向新创建的哈希集合的指针。
+ * @example my_set = hashset_new(int);
+ */
+#define hashset_new(K) Hashset_##K##_new(16)
+/**
+ * @brief 创建一个新的哈希集合，并预留足以容纳 `n` 个元素而不扩容的槽位。
+ * @param K 元素的类型。
+ * @param n (int) 预计的元素数量。
+ * @return 指向新创建的哈希集合的指针。
+ * @example my_set = hashset_new_with_capacity(int, 1 << 20);
+ */
+#define hashset_new_with_capacity(K, n) Hashset_##K##_new(Hashmap_capacity_for((n), __HASHSET_LOAD_FACTOR))
+// === 公共API: 核心操作宏 ===
+/**
+ * @brief 向哈希集合中插入一个元素。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @param key (K) 要插入的元素。
+ * @return (bool) 如果元素原先不存在并被插入，则返回 `true`；已存在时返回 `false`。
+ * @example if (hashset_insert(seen, word)) { printf("first time: %s\n", word); }
+ */
+#define hashset_insert(set, key) __HASHSET_FNS(set)->insert((set), (key))
+/**
+ * @brief 检查哈希集合是否包含指定的元素。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @param key (K) 要检查的元素。
+ * @return (bool) 如果元素存在，则返回 `true`；否则返回 `false`。
+ * @example if (hashset_contains(my_set, 42)) { ... }
+ */
+#define hashset_contains(set, key) __HASHSET_FNS(set)->contains((set), (key))
+/**
+ * @brief 从哈希集合中移除一个元素。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @param key (K) 要移除的元素。
+ * @return (bool) 如果成功移除了一个元素，则返回 `true`；否则返回 `false`。
+ * @example bool removed = hashset_remove(my_set, 42);
+ */
+#define hashset_remove(set, key) __HASHSET_FNS(set)->remove((set), (key))
+// === 公共API: 集合运算宏 ===
+/**
+ * @brief 返回两个集合的并集。复制较大的集合，再把较小集合的元素插入其中。
+ * @param a (hashset(K)) 第一个集合。
+ * @param b (hashset(K)) 第二个集合。
+ * @return (hashset(K)) 新创建的集合，由调用者负责释放。
+ * @example hashset(int) all = hashset_union(a, b);
+ */
+#define hashset_union(a, b) __HASHSET_FNS(a)->set_union((a), (b))
+/**
+ * @brief 返回两个集合的交集。遍历较小的集合，在较大的集合中查找。
+ * @param a (hashset(K)) 第一个集合。
+ * @param b (hashset(K)) 第二个集合。
+ * @return (hashset(K)) 新创建的集合，由调用者负责释放。
+ * @example hashset(int) both = hashset_intersection(a, b);
+ */
+#define hashset_intersection(a, b) __HASHSET_FNS(a)->set_intersection((a), (b))
+/**
+ * @brief 返回属于 `a` 但不属于 `b` 的元素构成的集合。
+ * `a` 较小时遍历 `a` 并在 `b` 中查找；否则复制 `a`，遍历 `b` 并从副本中删除。
+ * @param a (hashset(K)) 被减集合。
+ * @param b (hashset(K)) 减去的集合。
+ * @return (hashset(K)) 新创建的集合，由调用者负责释放。
+ * @example hashset(int) only_a = hashset_difference(a, b);
+ */
+#define hashset_difference(a, b) __HASHSET_FNS(a)->set_difference((a), (b))
+// === 公共API: 工具与生命周期宏 ===
+/**
+ * @brief 将哈希集合的内容显示到给定的文件流，格式为 `{e1, e2, ...}`。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @param stream (FILE*) 输出流。
+ * @example hashset_display(my_set, stdout);
+ */
+#define hashset_display(set, stream) __HASHSET_FNS(set)->display((set), (stream))
+/**
+ * @brief 返回哈希集合中元素的数量。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @return (int) 当前大小。
+ * @example int count = hashset_size(my_set);
+ */
+#define hashset_size(set) (set)->size
+/**
+ * @brief 创建哈希集合的一个副本。槽位数组按字节复制，不重新计算哈希。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @return (hashset(K)) 新创建的集合，由调用者负责释放。
+ * @example hashset(int) copy = hashset_clone(my_set);
+ */
+#define hashset_clone(set) __HASHSET_FNS(set)->clone(set)
+/**
+ * @brief 移除所有元素，保留已分配的槽位数组。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @example hashset_clear(my_set);
+ */
+#define hashset_clear(set) __HASHSET_FNS(set)->clear(set)
+/**
+ * @brief 预留足以容纳 `n` 个元素而不扩容的槽位。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @param n (int) 预计的元素数量。
+ * @example hashset_reserve(my_set, 1 << 20);
+ */
+#define hashset_reserve(set, n) __HASHSET_FNS(set)->reserve((set), (n))
+/**
+ * @brief 将槽位数组收缩到恰好容纳当前元素所需的大小。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @example hashset_shrink_to_fit(my_set);
+ */
+#define hashset_shrink_to_fit(set) __HASHSET_FNS(set)->shrink_to_fit(set)
+/**
+ * @brief 释放与哈希集合相关的所有内存。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @example hashset_free(my_set);
+ */
+#define hashset_free(set) __HASHSET_FNS(set)->free(set)
+// === 公共API: 迭代器宏 ===
+/**
+ * @brief 声明一个特定类型的哈希集合迭代器。
+ * @param K 元素的类型。
+ * @example hashset_iterator(int) it;
+ */
+#define hashset_iterator(K) struct HashsetIterator_##K
+/**
+ * @brief 获取一个指向哈希集合起始位置的迭代器。
+ * @param set (hashset(K)) 哈希集合实例。
+ * @return (hashset_iterator(K)) 一个新的迭代器。
+ * @example hashset_iterator(int) it = hashset_get_iterator(my_set);
+ */
+#define hashset_get_iterator(set) __HASHSET_FNS(set)->get_iterator(set)
+/**
+ * @brief 将迭代器移动到下一个元素。
+ * @param iter (hashset_iterator(K)) 迭代器实例。
+ * @return (bool) 如果成功移动到下一个元素，则返回 `true`；如果已到达末尾，则返回 `false`。
+ * @example while (hashset_iterator_next(it)) { ... }
+ */
+#define hashset_iterator_next(iter) __HASHSET_FNS((iter).set)->iterator_next(&(iter))
+/**
+ * @brief 获取迭代器当前指向的元素。
+ * @param iter (hashset_iterator(K)) 迭代器实例。
+ * @return (const K*) 指向当前元素的常量指针。
+ * @example const int* value = hashset_iterator_current(it);
+ */
+#define hashset_iterator_current(iter) __HASHSET_FNS((iter).set)->iterator_current(&(iter))
+
+#endif // HASHSET_H
@@ -0,0 +1,807 @@
+#ifndef PERSISTENT_HASHMAP_H
+#define PERSISTENT_HASHMAP_H
+
+#include <errno.h>
+#include <pthread.h>
+#include "hashmap.h"
+
+/**
+ * @file persistent_hashmap.h
+ * @brief 以追加写日志 (write-ahead log) 持久化的泛型哈希表 (C-OOP-Container)。
+ *
+ * 数据全部保存在内存中的 `hashmap(K,V)` 里，每次 `put`/`remove` 同时编码为一条紧凑的
+ * 二进制记录追加到日志缓冲区：
+ * - 组提交：缓冲区积累到 `PERSISTENT_HASHMAP_GROUP_COMMIT_BYTES` 字节，或显式调用
+ *   `persistent_hashmap_sync` 时，整批记录作为一帧以一次 `write` 加一次 `fdatasync` 落盘。
+ *   每帧带有长度与校验和，崩溃时写了一半的尾帧在恢复时被识别并截掉。
+ *   写入吞吐量因此取决于顺序写带宽，而不是每次操作一次系统调用。
+ * - 恢复：打开时先载入快照，再按顺序重放日志，重建内存中的哈希表。
+ * - 压缩：日志超过快照的 `PERSISTENT_HASHMAP_COMPACT_RATIO` 倍 (且至少
+ *   `PERSISTENT_HASHMAP_COMPACT_MIN_BYTES` 字节) 时，当前内容被序列化到内存，
+ *   日志切换到新的一代，后台线程把序列化结果写成新快照并删除旧日志。
+ *
+ * 给定路径 `path` 时使用以下文件：`path.snapshot`、`path.log`，压缩期间还有
+ * `path.log.old` 与 `path.snapshot.tmp`。任何时刻崩溃，重新打开都能恢复到最后一次
+ * 组提交时的状态：快照与每个日志都记录了自己的代数，只有不旧于快照的日志才会被重放，
+ * 而重放已包含在快照中的记录不会改变结果。
+ *
+ * 键和值必须是 POD 类型，唯一的例外是 `cstr` 键：其内容以带长度前缀的形式写入日志，
+ * 内存中的副本由持久化哈希表自己保管。与 `hashmap(K,V)` 一样，本容器不是线程安全的。
+ *
+ * @note 依赖 POSIX 文件接口与线程，编译时需要 `-pthread`。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+// === 公共API: 编译期配置 ===
+
+/**
+ * @brief 组提交阈值：日志缓冲区达到该字节数时自动落盘 (默认 1 MiB)。
+ */
+#ifndef PERSISTENT_HASHMAP_GROUP_COMMIT_BYTES
+#define PERSISTENT_HASHMAP_GROUP_COMMIT_BYTES (1 << 20)
+#endif
+/**
+ * @brief 触发后台压缩的最小日志大小 (默认 64 MiB)。
+ */
+#ifndef PERSISTENT_HASHMAP_COMPACT_MIN_BYTES
+#define PERSISTENT_HASHMAP_COMPACT_MIN_BYTES (64 << 20)
+#endif
+/**
+ * @brief 日志大小超过快照大小的多少倍时触发后台压缩 (默认 2)。
+ */
+#ifndef PERSISTENT_HASHMAP_COMPACT_RATIO
+#define PERSISTENT_HASHMAP_COMPACT_RATIO 2
+#endif
+/**
+ * @brief 静态分派模式下需要直接绑定的持久化哈希表类型列表，用法与 `COOP_HASHMAP_TYPES` 相同。
+ */
+#ifndef COOP_PERSISTENT_HASHMAP_TYPES
+#define COOP_PERSISTENT_HASHMAP_TYPES(X)
+#endif
+
+#ifdef COOP_STATIC_DISPATCH
+// --- Internal Macros ---
+#define __PERSISTENT_HASHMAP_FNS_CASE(K, V) PersistentHashmap_##K##_##V*: &PERSISTENT_HASHMAP_##K##V##FUNCTIONS,
+// --- Internal Macros ---
+#define __PERSISTENT_HASHMAP_FNS(map)                                                                               \
+    _Generic((map), COOP_PERSISTENT_HASHMAP_TYPES(__PERSISTENT_HASHMAP_FNS_CASE) default: (map)->fns)
+#else
+// --- Internal Macros ---
+#define __PERSISTENT_HASHMAP_FNS(map) (map)->fns
+#endif
+
+// --- Internal Macros ---
+#define __HASHMAP_WAL_VERSION 1u
+// --- Internal Macros ---
+#define __HASHMAP_WAL_LOG_MAGIC "COOPWLOG"
+// --- Internal Macros ---
+#define __HASHMAP_WAL_SNAPSHOT_MAGIC "COOPWSNP"
+// --- Internal Macros ---
+#define __HASHMAP_WAL_PUT 1
+// --- Internal Macros ---
+#define __HASHMAP_WAL_REMOVE 2
+// --- Internal Macros ---
+#define __HASHMAP_WAL_FRAME_HEADER 16u
+// --- Internal Macros ---
+#define __HASHMAP_WAL_CHUNK_SIZE 65536u
+
+/**
+ * @brief 日志与快照文件共用的文件头。
+ *
+ * 文件头之后是若干帧，每帧为 `[uint64 长度][uint64 校验和][记录...]`。
+ * 每条记录为 `[uint8 操作][键][值]`：POD 键按原始字节存放，`cstr` 键按
+ * `[uint32 长度][字节][\0]` 存放；删除记录没有值。所有整数按本机字节序存储。
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t key_size;
+    uint32_t value_size;
+    uint32_t flags;
+    uint64_t generation;
+} HashmapWalHeader;
+
+/**
+ * @brief 可增长的字节缓冲区，用于积累日志帧与序列化快照。
+ */
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+} HashmapWalBuffer;
+
+/**
+ * @brief 保管 `cstr` 键副本的内存块链表，在压缩时整体重建。
+ */
+typedef struct HashmapWalChunk {
+    struct HashmapWalChunk* next;
+    size_t used;
+    size_t capacity;
+    char data[];
+} HashmapWalChunk;
+
+/**
+ * @brief 一次后台压缩任务：把已序列化的快照写入文件，然后删除旧日志。
+ */
+typedef struct {
+    const char* snapshot_path;
+    const char* temp_path;
+    const char* old_log_path;
+    const char* directory;
+    HashmapWalBuffer buffer;
+    pthread_t thread;
+    bool joinable;
+    bool ok;
+    int done;
+} HashmapWalCompaction;
+
+// --- Internal Helper Functions ---
+static inline void Hashmap_wal_append(HashmapWalBuffer* buffer, const void* data, size_t size) {
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : 4096;
+        while (capacity < buffer->size + size) {
+            capacity *= 2;
+        }
+        char* grown = (char*) realloc(buffer->data, capacity);
+        if (grown == NULL) {
+            fprintf(stderr, "Error: Out of memory while growing a hashmap log buffer.\n");
+            _Exit(EXIT_FAILURE);
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_wal_begin_frame(HashmapWalBuffer* buffer) {
+    static const char empty[__HASHMAP_WAL_FRAME_HEADER];
+    Hashmap_wal_append(buffer, empty, sizeof(empty));
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_wal_end_frame(HashmapWalBuffer* buffer, size_t start) {
+    uint64_t length = buffer->size - start - __HASHMAP_WAL_FRAME_HEADER;
+    uint64_t checksum = Hashmap_hash_bytes(buffer->data + start + __HASHMAP_WAL_FRAME_HEADER, length, 0);
+    memcpy(buffer->data + start, &length, sizeof(length));
+    memcpy(buffer->data + start + sizeof(length), &checksum, sizeof(checksum));
+}
+// --- Internal Helper Functions ---
+static inline HashmapWalHeader Hashmap_wal_header(const char* magic, uint32_t key_size, uint32_t value_size,
+                                                  uint32_t flags, uint64_t generation) {
+    HashmapWalHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = __HASHMAP_WAL_VERSION;
+    header.key_size = key_size;
+    header.value_size = value_size;
+    header.flags = flags;
+    header.generation = generation;
+    return header;
+}
+// --- Internal Helper Functions ---
+static inline bool Hashmap_wal_header_valid(const HashmapWalHeader* header, const HashmapWalHeader* expected) {
+    return memcmp(header->magic, expected->magic, sizeof(header->magic)) == 0
+        && header->version == expected->version && header->key_size == expected->key_size
+        && header->value_size == expected->value_size && header->flags == expected->flags;
+}
+// --- Internal Helper Functions ---
+static inline const char* Hashmap_wal_arena_copy(HashmapWalChunk** arena, const char* string, size_t length) {
+    HashmapWalChunk* chunk = *arena;
+    if (chunk == NULL || chunk->capacity - chunk->used < length + 1) {
+        size_t capacity = length + 1 > __HASHMAP_WAL_CHUNK_SIZE ? length + 1 : __HASHMAP_WAL_CHUNK_SIZE;
+        chunk = (HashmapWalChunk*) malloc(sizeof(HashmapWalChunk) + capacity);
+        if (chunk == NULL) {
+            fprintf(stderr, "Error: Out of memory while copying a hashmap key.\n");
+            _Exit(EXIT_FAILURE);
+        }
+        chunk->next = *arena;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        *arena = chunk;
+    }
+    char* copy = chunk->data + chunk->used;
+    memcpy(copy, string, length);
+    copy[length] = '\0';
+    chunk->used += length + 1;
+    return copy;
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_wal_arena_free(HashmapWalChunk* arena) {
+    while (arena != NULL) {
+        HashmapWalChunk* next = arena->next;
+        free(arena);
+        arena = next;
+    }
+}
+// --- Internal Helper Functions ---
+static inline char* Hashmap_wal_path(const char* path, const char* suffix) {
+    size_t length = strlen(path);
+    char* result = (char*) malloc(length + strlen(suffix) + 1);
+    memcpy(result, path, length);
+    strcpy(result + length, suffix);
+    return result;
+}
+// --- Internal Helper Functions ---
+static inline char* Hashmap_wal_directory(const char* path) {
+    const char* slash = strrchr(path, '/');
+    if (slash == NULL) {
+        return Hashmap_wal_path(".", "");
+    }
+    size_t length = slash == path ? 1 : (size_t) (slash - path);
+    char* directory = (char*) malloc(length + 1);
+    memcpy(directory, path, length);
+    directory[length] = '\0';
+    return directory;
+}
+// --- Internal Helper Functions ---
+static inline bool Hashmap_wal_sync_directory(const char* directory) {
+    int fd = open(directory, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+// --- Internal Helper Functions ---
+static inline bool Hashmap_wal_write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= (size_t) written;
+    }
+    return true;
+}
+// --- Internal Helper Functions ---
+static inline int Hashmap_wal_create(const char* path, const HashmapWalHeader* header) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd >= 0 && (!Hashmap_wal_write_all(fd, (const char*) header, sizeof(*header)) || fdatasync(fd) != 0)) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+// --- Internal Helper Functions ---
+static inline bool Hashmap_wal_write_snapshot(HashmapWalCompaction* job) {
+    int fd = open(job->temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = Hashmap_wal_write_all(fd, job->buffer.data, job->buffer.size) && fdatasync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    ok = ok && rename(job->temp_path, job->snapshot_path) == 0 && Hashmap_wal_sync_directory(job->directory);
+    ok = ok && (unlink(job->old_log_path) == 0 || errno == ENOENT) && Hashmap_wal_sync_directory(job->directory);
+    return ok;
+}
+// --- Internal Helper Functions ---
+static inline void* Hashmap_wal_compaction_thread(void* arg) {
+    HashmapWalCompaction* job = (HashmapWalCompaction*) arg;
+    job->ok = Hashmap_wal_write_snapshot(job);
+    __atomic_store_n(&job->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// === 公共API: 定义宏 ===
+
+/**
+ * @brief 为已经定义过的 `hashmap(K,V)` 类型定义对应的持久化哈希表。
+ *
+ * 必须先用 `HASHMAP_DEFINE` (或任一后端的同名宏) 定义 `hashmap(K,V)`，
+ * 哈希、比较与显示行为全部沿用该定义。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词，POD 类型）。
+ *
+ * @example
+ * HASHMAP_DEFINE(cstr, int)
+ * PERSISTENT_HASHMAP_DEFINE(cstr, int)
+ * persistent_hashmap(cstr, int) sessions = persistent_hashmap_open(cstr, int, "data/sessions");
+ */
+#define PERSISTENT_HASHMAP_DEFINE(K, V)                                                                             \
+                                                                                                                    \
+typedef struct __PersistentHashmap_##K##_##V PersistentHashmap_##K##_##V;                                           \
+                                                                                                                    \
+struct PersistentHashmap_##K##_##V##_Functions {                                                                    \
+    void (*display)(PersistentHashmap_##K##_##V* self, FILE* stream);                                               \
+    void (*put)(PersistentHashmap_##K##_##V* self, K key, V value);                                                 \
+    const V* (*get)(PersistentHashmap_##K##_##V* self, K key);                                                      \
+    bool (*remove)(PersistentHashmap_##K##_##V* self, K key);                                                       \
+    bool (*contains)(PersistentHashmap_##K##_##V* self, K key);                                                     \
+    bool (*sync)(PersistentHashmap_##K##_##V* self);                                                                \
+    bool (*compact)(PersistentHashmap_##K##_##V* self);                                                             \
+    bool (*free)(PersistentHashmap_##K##_##V* self);                                                                \
+};                                                                                                                  \
+                                                                                                                    \
+struct __PersistentHashmap_##K##_##V {                                                                              \
+    const struct PersistentHashmap_##K##_##V##_Functions* fns;                                                      \
+    Hashmap_##K##_##V* table;                                                                                       \
+    HashmapWalChunk* arena;                                                                                         \
+    char* log_path;                                                                                                 \
+    char* old_log_path;                                                                                             \
+    char* snapshot_path;                                                                                            \
+    char* temp_path;                                                                                                \
+    char* directory;                                                                                                \
+    int fd;                                                                                                         \
+    uint64_t generation;                                                                                            \
+    uint64_t log_bytes;                                                                                             \
+    uint64_t snapshot_bytes;                                                                                        \
+    HashmapWalBuffer pending;                                                                                       \
+    HashmapWalCompaction* compaction;                                                                               \
+    bool failed;                                                                                                    \
+};                                                                                                                  \
+                                                                                                                    \
+const static struct PersistentHashmap_##K##_##V##_Functions PERSISTENT_HASHMAP_##K##V##FUNCTIONS;                   \
+                                                                                                                    \
+static K PersistentHashmap_##K##_##V##_own(PersistentHashmap_##K##_##V* self, K key) {                              \
+    if (!__HASHMAP_IS_STRING(K)) {                                                                                  \
+        return key;                                                                                                 \
+    }                                                                                                               \
+    const char* string = __HASHMAP_STRING_OF(key);                                                                  \
+    union { K key; const char* string; } owned;                                                                     \
+    owned.string = Hashmap_wal_arena_copy(&self->arena, string, strlen(string));                                    \
+    return owned.key;                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void PersistentHashmap_##K##_##V##_store(PersistentHashmap_##K##_##V* self, K key, V value) {                \
+    V* slot = hashmap_get_mut(self->table, key);                                                                    \
+    if (slot != NULL) {                                                                                             \
+        *slot = value;                                                                                              \
+    } else {                                                                                                        \
+        hashmap_put(self->table, PersistentHashmap_##K##_##V##_own(self, key), value);                              \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static void PersistentHashmap_##K##_##V##_encode(HashmapWalBuffer* buffer, uint8_t op, K key, const V* value) {     \
+    Hashmap_wal_append(buffer, &op, sizeof(op));                                                                    \
+    if (__HASHMAP_IS_STRING(K)) {                                                                                   \
+        const char* string = __HASHMAP_STRING_OF(key);                                                              \
+        uint32_t length = (uint32_t) strlen(string);                                                                \
+        Hashmap_wal_append(buffer, &length, sizeof(length));                                                        \
+        Hashmap_wal_append(buffer, string, length + 1);                                                             \
+    } else {                                                                                                        \
+        Hashmap_wal_append(buffer, &key, sizeof(K));                                                                \
+    }                                                                                                               \
+    if (value != NULL) {                                                                                            \
+        Hashmap_wal_append(buffer, value, sizeof(V));                                                               \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_replay_frame(                                                             \
+    PersistentHashmap_##K##_##V* self, const char* records, uint64_t length) {                                      \
+    uint64_t position = 0;                                                                                          \
+    while (position < length) {                                                                                     \
+        uint8_t op = (uint8_t) records[position++];                                                                 \
+        K key;                                                                                                      \
+        if (__HASHMAP_IS_STRING(K)) {                                                                               \
+            uint32_t key_length;                                                                                    \
+            if (length - position < sizeof(key_length)) {                                                           \
+                return false;                                                                                       \
+            }                                                                                                       \
+            memcpy(&key_length, records + position, sizeof(key_length));                                            \
+            position += sizeof(key_length);                                                                         \
+            if (length - position <= key_length || records[position + key_length] != '\0') {                        \
+                return false;                                                                                       \
+            }                                                                                                       \
+            union { K key; const char* string; } view;                                                              \
+            view.string = records + position;                                                                       \
+            key = view.key;                                                                                         \
+            position += key_length + 1;                                                                             \
+        } else {                                                                                                    \
+            if (length - position < sizeof(K)) {                                                                    \
+                return false;                                                                                       \
+            }                                                                                                       \
+            memcpy(&key, records + position, sizeof(K));                                                            \
+            position += sizeof(K);                                                                                  \
+        }                                                                                                           \
+        if (op == __HASHMAP_WAL_PUT && length - position >= sizeof(V)) {                                            \
+            V value;                                                                                                \
+            memcpy(&value, records + position, sizeof(V));                                                          \
+            position += sizeof(V);                                                                                  \
+            PersistentHashmap_##K##_##V##_store(self, key, value);                                                  \
+        } else if (op == __HASHMAP_WAL_REMOVE) {                                                                    \
+            hashmap_remove(self->table, key);                                                                       \
+        } else {                                                                                                    \
+            return false;                                                                                           \
+        }                                                                                                           \
+    }                                                                                                               \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static uint64_t PersistentHashmap_##K##_##V##_replay(                                                               \
+    PersistentHashmap_##K##_##V* self, const char* data, uint64_t size) {                                           \
+    uint64_t position = 0;                                                                                          \
+    while (size - position >= __HASHMAP_WAL_FRAME_HEADER) {                                                         \
+        uint64_t length, checksum;                                                                                  \
+        memcpy(&length, data + position, sizeof(length));                                                           \
+        memcpy(&checksum, data + position + sizeof(length), sizeof(checksum));                                      \
+        const char* records = data + position + __HASHMAP_WAL_FRAME_HEADER;                                         \
+        if (length > size - position - __HASHMAP_WAL_FRAME_HEADER                                                   \
+            || Hashmap_hash_bytes(records, length, 0) != checksum                                                   \
+            || !PersistentHashmap_##K##_##V##_replay_frame(self, records, length)) {                                \
+            break;                                                                                                  \
+        }                                                                                                           \
+        position += __HASHMAP_WAL_FRAME_HEADER + length;                                                            \
+    }                                                                                                               \
+    return position;                                                                                                \
+}                                                                                                                   \
+                                                                                                                    \
+static HashmapWalHeader PersistentHashmap_##K##_##V##_header(const char* magic, uint64_t generation) {              \
+    uint32_t flags = __HASHMAP_IS_STRING(K) ? __HASHMAP_SNAPSHOT_STRING_KEYS : 0u;                                  \
+    return Hashmap_wal_header(magic, sizeof(K), sizeof(V), flags, generation);                                      \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_flush(PersistentHashmap_##K##_##V* self) {                                \
+    if (self->failed || self->pending.size == __HASHMAP_WAL_FRAME_HEADER) {                                         \
+        return !self->failed;                                                                                       \
+    }                                                                                                               \
+    Hashmap_wal_end_frame(&self->pending, 0);                                                                       \
+    if (!Hashmap_wal_write_all(self->fd, self->pending.data, self->pending.size) || fdatasync(self->fd) != 0) {     \
+        self->failed = true;                                                                                        \
+        return false;                                                                                               \
+    }                                                                                                               \
+    self->log_bytes += self->pending.size;                                                                          \
+    self->pending.size = 0;                                                                                         \
+    Hashmap_wal_begin_frame(&self->pending);                                                                        \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_reap(PersistentHashmap_##K##_##V* self, bool wait) {                      \
+    HashmapWalCompaction* job = self->compaction;                                                                   \
+    if (job == NULL) {                                                                                              \
+        return true;                                                                                                \
+    }                                                                                                               \
+    if (!wait && !__atomic_load_n(&job->done, __ATOMIC_ACQUIRE)) {                                                  \
+        return false;                                                                                               \
+    }                                                                                                               \
+    if (job->joinable) {                                                                                            \
+        pthread_join(job->thread, NULL);                                                                            \
+    }                                                                                                               \
+    self->failed = self->failed || !job->ok;                                                                        \
+    free(job->buffer.data);                                                                                         \
+    free(job);                                                                                                      \
+    self->compaction = NULL;                                                                                        \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void PersistentHashmap_##K##_##V##_serialize(                                                                \
+    PersistentHashmap_##K##_##V* self, HashmapWalBuffer* buffer, uint64_t generation) {                             \
+    HashmapWalHeader header = PersistentHashmap_##K##_##V##_header(__HASHMAP_WAL_SNAPSHOT_MAGIC, generation);       \
+    Hashmap_wal_append(buffer, &header, sizeof(header));                                                            \
+    Hashmap_wal_begin_frame(buffer);                                                                                \
+    Hashmap_##K##_##V* map = self->table;                                                                           \
+    HashmapWalChunk* arena = self->arena;                                                                           \
+    if (__HASHMAP_IS_STRING(K)) {                                                                                   \
+        self->table = hashmap_new(K, V);                                                                            \
+        self->arena = NULL;                                                                                         \
+        hashmap_reserve(self->table, hashmap_size(map));                                                            \
+    }                                                                                                               \
+    struct HashmapIterator_##K##_##V iter = hashmap_get_iterator(map);                                              \
+    while (hashmap_iterator_next(iter)) {                                                                           \
+        K key = *hashmap_iterator_current_key(iter);                                                                \
+        const V* value = hashmap_iterator_current_value(iter);                                                      \
+        PersistentHashmap_##K##_##V##_encode(buffer, __HASHMAP_WAL_PUT, key, value);                                \
+        if (__HASHMAP_IS_STRING(K)) {                                                                               \
+            hashmap_put(self->table, PersistentHashmap_##K##_##V##_own(self, key), *value);                         \
+        }                                                                                                           \
+    }                                                                                                               \
+    Hashmap_wal_end_frame(buffer, sizeof(header));                                                                  \
+    if (__HASHMAP_IS_STRING(K)) {                                                                                   \
+        hashmap_free(map);                                                                                          \
+        Hashmap_wal_arena_free(arena);                                                                              \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_start_compaction(PersistentHashmap_##K##_##V* self) {                     \
+    if (!PersistentHashmap_##K##_##V##_flush(self)) {                                                               \
+        return false;                                                                                               \
+    }                                                                                                               \
+    HashmapWalCompaction* job = (HashmapWalCompaction*) calloc(1, sizeof(HashmapWalCompaction));                    \
+    job->snapshot_path = self->snapshot_path;                                                                       \
+    job->temp_path = self->temp_path;                                                                               \
+    job->old_log_path = self->old_log_path;                                                                         \
+    job->directory = self->directory;                                                                               \
+    PersistentHashmap_##K##_##V##_serialize(self, &job->buffer, self->generation + 1);                              \
+    HashmapWalHeader header = PersistentHashmap_##K##_##V##_header(__HASHMAP_WAL_LOG_MAGIC, self->generation + 1);  \
+    if (rename(self->log_path, self->old_log_path) != 0) {                                                          \
+        free(job->buffer.data);                                                                                     \
+        free(job);                                                                                                  \
+        self->failed = true;                                                                                        \
+        return false;                                                                                               \
+    }                                                                                                               \
+    close(self->fd);                                                                                                \
+    self->fd = Hashmap_wal_create(self->log_path, &header);                                                         \
+    if (self->fd < 0 || !Hashmap_wal_sync_directory(self->directory)) {                                             \
+        free(job->buffer.data);                                                                                     \
+        free(job);                                                                                                  \
+        self->failed = true;                                                                                        \
+        return false;                                                                                               \
+    }                                                                                                               \
+    self->generation++;                                                                                             \
+    self->log_bytes = sizeof(header);                                                                               \
+    self->snapshot_bytes = job->buffer.size;                                                                        \
+    job->joinable = pthread_create(&job->thread, NULL, Hashmap_wal_compaction_thread, job) == 0;                    \
+    if (!job->joinable) {                                                                                           \
+        Hashmap_wal_compaction_thread(job);                                                                         \
+    }                                                                                                               \
+    self->compaction = job;                                                                                         \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_sync(PersistentHashmap_##K##_##V* self) {                                 \
+    if (!PersistentHashmap_##K##_##V##_flush(self)) {                                                               \
+        return false;                                                                                               \
+    }                                                                                                               \
+    uint64_t threshold = PERSISTENT_HASHMAP_COMPACT_RATIO * self->snapshot_bytes;                                   \
+    if (self->log_bytes >= threshold && self->log_bytes >= (uint64_t) PERSISTENT_HASHMAP_COMPACT_MIN_BYTES          \
+        && PersistentHashmap_##K##_##V##_reap(self, false) && !self->failed) {                                      \
+        return PersistentHashmap_##K##_##V##_start_compaction(self);                                                \
+    }                                                                                                               \
+    return !self->failed;                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_compact(PersistentHashmap_##K##_##V* self) {                              \
+    PersistentHashmap_##K##_##V##_reap(self, true);                                                                 \
+    if (self->failed || !PersistentHashmap_##K##_##V##_start_compaction(self)) {                                    \
+        return false;                                                                                               \
+    }                                                                                                               \
+    PersistentHashmap_##K##_##V##_reap(self, true);                                                                 \
+    return !self->failed;                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static void PersistentHashmap_##K##_##V##_display(PersistentHashmap_##K##_##V* self, FILE* stream) {                \
+    hashmap_display(self->table, stream);                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static void PersistentHashmap_##K##_##V##_put(PersistentHashmap_##K##_##V* self, K key, V value) {                  \
+    PersistentHashmap_##K##_##V##_store(self, key, value);                                                          \
+    PersistentHashmap_##K##_##V##_encode(&self->pending, __HASHMAP_WAL_PUT, key, &value);                           \
+    if (self->pending.size >= PERSISTENT_HASHMAP_GROUP_COMMIT_BYTES) {                                              \
+        PersistentHashmap_##K##_##V##_sync(self);                                                                   \
+    }                                                                                                               \
+}                                                                                                                   \
+                                                                                                                    \
+static const V* PersistentHashmap_##K##_##V##_get(PersistentHashmap_##K##_##V* self, K key) {                       \
+    return hashmap_get(self->table, key);                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_remove(PersistentHashmap_##K##_##V* self, K key) {                        \
+    if (!hashmap_remove(self->table, key)) {                                                                        \
+        return false;                                                                                               \
+    }                                                                                                               \
+    PersistentHashmap_##K##_##V##_encode(&self->pending, __HASHMAP_WAL_REMOVE, key, NULL);                          \
+    if (self->pending.size >= PERSISTENT_HASHMAP_GROUP_COMMIT_BYTES) {                                              \
+        PersistentHashmap_##K##_##V##_sync(self);                                                                   \
+    }                                                                                                               \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_contains(PersistentHashmap_##K##_##V* self, K key) {                      \
+    return hashmap_contains(self->table, key);                                                                      \
+}                                                                                                                   \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_free(PersistentHashmap_##K##_##V* self) {                                 \
+    bool ok = PersistentHashmap_##K##_##V##_flush(self);                                                            \
+    PersistentHashmap_##K##_##V##_reap(self, true);                                                                 \
+    ok = ok && !self->failed;                                                                                       \
+    if (self->fd >= 0) {                                                                                            \
+        close(self->fd);                                                                                            \
+    }                                                                                                               \
+    hashmap_free(self->table);                                                                                      \
+    Hashmap_wal_arena_free(self->arena);                                                                            \
+    free(self->pending.data);                                                                                       \
+    free(self->log_path);                                                                                           \
+    free(self->old_log_path);                                                                                       \
+    free(self->snapshot_path);                                                                                      \
+    free(self->temp_path);                                                                                          \
+    free(self->directory);                                                                                          \
+    free(self);                                                                                                     \
+    return ok;                                                                                                      \
+}                                                                                                                   \
+                                                                                                                    \
+const static struct PersistentHashmap_##K##_##V##_Functions PERSISTENT_HASHMAP_##K##V##FUNCTIONS = {                \
+    .display = PersistentHashmap_##K##_##V##_display,                                                               \
+    .put = PersistentHashmap_##K##_##V##_put,                                                                       \
+    .get = PersistentHashmap_##K##_##V##_get,                                                                       \
+    .remove = PersistentHashmap_##K##_##V##_remove,                                                                 \
+    .contains = PersistentHashmap_##K##_##V##_contains,                                                             \
+    .sync = PersistentHashmap_##K##_##V##_sync,                                                                     \
+    .compact = PersistentHashmap_##K##_##V##_compact,                                                               \
+    .free = PersistentHashmap_##K##_##V##_free,                                                                     \
+};                                                                                                                  \
+                                                                                                                    \
+static bool PersistentHashmap_##K##_##V##_load(PersistentHashmap_##K##_##V* self) {                                 \
+    uint64_t snapshot_generation = 0;                                                                               \
+    size_t size = 0;                                                                                                \
+    const char* data = Hashmap_snapshot_map(self->snapshot_path, &size);                                            \
+    if (data == NULL && access(self->snapshot_path, F_OK) == 0) {                                                   \
+        return false;                                                                                               \
+    }                                                                                                               \
+    if (data != NULL) {                                                                                             \
+        const HashmapWalHeader* header = (const HashmapWalHeader*) data;                                            \
+        HashmapWalHeader expected = PersistentHashmap_##K##_##V##_header(__HASHMAP_WAL_SNAPSHOT_MAGIC, 0);          \
+        uint64_t body = size - sizeof(HashmapWalHeader);                                                            \
+        bool valid = size >= sizeof(HashmapWalHeader) && Hashmap_wal_header_valid(header, &expected)                \
+                     && PersistentHashmap_##K##_##V##_replay(self, data + sizeof(HashmapWalHeader), body) == body;  \
+        snapshot_generation = valid ? header->generation : 0;                                                       \
+        self->snapshot_bytes = size;                                                                                \
+        Hashmap_snapshot_unmap(data, size);                                                                         \
+        if (!valid) {                                                                                               \
+            return false;                                                                                           \
+        }                                                                                                           \
+    }                                                                                                               \
+    const char* paths[2] = {self->old_log_path, self->log_path};                                                    \
+    uint64_t good = 0;                                                                                              \
+    bool folded = false;                                                                                            \
+    self->generation = snapshot_generation;                                                                         \
+    for (int i = 0; i < 2; i++) {                                                                                   \
+        data = Hashmap_snapshot_map(paths[i], &size);                                                               \
+        if (data == NULL) {                                                                                         \
+            continue;                                                                                               \
+        }                                                                                                           \
+        const HashmapWalHeader* header = (const HashmapWalHeader*) data;                                            \
+        HashmapWalHeader expected = PersistentHashmap_##K##_##V##_header(__HASHMAP_WAL_LOG_MAGIC, 0);               \
+        bool valid = size >= sizeof(HashmapWalHeader) && Hashmap_wal_header_valid(header, &expected);               \
+        if (size >= sizeof(HashmapWalHeader) && !valid) {                                                           \
+            Hashmap_snapshot_unmap(data, size);                                                                     \
+            return false;                                                                                           \
+        }                                                                                                           \
+        if (valid && header->generation >= snapshot_generation) {                                                   \
+            uint64_t body = size - sizeof(HashmapWalHeader);                                                        \
+            uint64_t replayed = PersistentHashmap_##K##_##V##_replay(self, data + sizeof(HashmapWalHeader), body);  \
+            good = i == 1 ? sizeof(HashmapWalHeader) + replayed : 0;                                                \
+            self->generation = header->generation;                                                                  \
+        }                                                                                                           \
+        folded = folded || i == 0;                                                                                  \
+        Hashmap_snapshot_unmap(data, size);                                                                         \
+    }                                                                                                               \
+    if (good > 0) {                                                                                                 \
+        self->fd = open(self->log_path, O_WRONLY | O_APPEND);                                                       \
+        if (self->fd >= 0 && (ftruncate(self->fd, (off_t) good) != 0 || fdatasync(self->fd) != 0)) {                \
+            return false;                                                                                           \
+        }                                                                                                           \
+    } else {                                                                                                        \
+        HashmapWalHeader header = PersistentHashmap_##K##_##V##_header(__HASHMAP_WAL_LOG_MAGIC, self->generation);  \
+        self->fd = Hashmap_wal_create(self->log_path, &header);                                                     \
+        good = sizeof(header);                                                                                      \
+    }                                                                                                               \
+    if (self->fd < 0 || !Hashmap_wal_sync_directory(self->directory)) {                                             \
+        return false;                                                                                               \
+    }                                                                                                               \
+    self->log_bytes = good;                                                                                         \
+    if (folded) {                                                                                                   \
+        HashmapWalCompaction job;                                                                                   \
+        memset(&job, 0, sizeof(job));                                                                               \
+        job.snapshot_path = self->snapshot_path;                                                                    \
+        job.temp_path = self->temp_path;                                                                            \
+        job.old_log_path = self->old_log_path;                                                                      \
+        job.directory = self->directory;                                                                            \
+        PersistentHashmap_##K##_##V##_serialize(self, &job.buffer, self->generation);                               \
+        bool ok = Hashmap_wal_write_snapshot(&job);                                                                 \
+        self->snapshot_bytes = job.buffer.size;                                                                     \
+        free(job.buffer.data);                                                                                      \
+        return ok;                                                                                                  \
+    }                                                                                                               \
+    return true;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static PersistentHashmap_##K##_##V* PersistentHashmap_##K##_##V##_open(const char* path) {                          \
+    if (__HASHMAP_IS_STRING(V)) {                                                                                   \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    PersistentHashmap_##K##_##V* self =                                                                             \
+        (PersistentHashmap_##K##_##V*) calloc(1, sizeof(PersistentHashmap_##K##_##V));                              \
+    self->fns = &PERSISTENT_HASHMAP_##K##V##FUNCTIONS;                                                              \
+    self->table = hashmap_new(K, V);                                                                                \
+    self->log_path = Hashmap_wal_path(path, ".log");                                                                \
+    self->old_log_path = Hashmap_wal_path(path, ".log.old");                                                        \
+    self->snapshot_path = Hashmap_wal_path(path, ".snapshot");                                                      \
+    self->temp_path = Hashmap_wal_path(path, ".snapshot.tmp");                                                      \
+    self->directory = Hashmap_wal_directory(path);                                                                  \
+    self->fd = -1;                                                                                                  \
+    Hashmap_wal_begin_frame(&self->pending);                                                                        \
+    if (!PersistentHashmap_##K##_##V##_load(self)) {                                                                \
+        self->failed = true;                                                                                        \
+        PersistentHashmap_##K##_##V##_free(self);                                                                   \
+        return NULL;                                                                                                \
+    }                                                                                                               \
+    return self;                                                                                                    \
+}                                                                                                                   \
+
+// === 公共API: 类型与构造函数宏 ===
+/**
+ * @brief 声明一个指向特定持久化哈希表类型的指针。
+ * @param K 在 PERSISTENT_HASHMAP_DEFINE 中使用的键类型。
+ * @param V 在 PERSISTENT_HASHMAP_DEFINE 中使用的值类型。
+ * @example persistent_hashmap(cstr, int) sessions;
+ */
+#define persistent_hashmap(K, V) PersistentHashmap_##K##_##V*
+/**
+ * @brief 打开 (或新建) 以 `path` 为前缀的持久化哈希表，载入快照并重放日志。
+ * 日志末尾不完整或校验失败的帧会被截掉；快照损坏、文件头与 `K`/`V` 不匹配时打开失败。
+ * @param K 键的类型。
+ * @param V 值的类型，不能是字符串。
+ * @param path (const char*) 文件前缀，实际使用 `path.snapshot` 与 `path.log`。
+ * @return 指向持久化哈希表的指针；失败时返回 NULL。
+ * @example sessions = persistent_hashmap_open(cstr, int, "data/sessions");
+ */
+#define persistent_hashmap_open(K, V, path) PersistentHashmap_##K##_##V##_open(path)
+// === 公共API: 核心操作宏 ===
+/**
+ * @brief 插入或更新一个键值对，并把该操作追加到日志缓冲区。
+ * 缓冲区达到组提交阈值时自动落盘；在此之前该操作尚未持久化。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @param key (K) 键；`cstr` 键会被复制。
+ * @param value (V) 值。
+ */
+#define persistent_hashmap_put(map, key, ...) __PERSISTENT_HASHMAP_FNS(map)->put((map), (key), __VA_ARGS__)
+/**
+ * @brief 根据键查找值。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @param key (K) 要查找的键。
+ * @return (const V*) 指向值的常量指针，下一次修改前有效；未找到则返回 NULL。
+ */
+#define persistent_hashmap_get(map, key) __PERSISTENT_HASHMAP_FNS(map)->get((map), (key))
+/**
+ * @brief 移除一个键值对，并把该操作追加到日志缓冲区。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @param key (K) 要移除的键。
+ * @return (bool) 键存在并被移除时返回 `true`。
+ */
+#define persistent_hashmap_remove(map, key) __PERSISTENT_HASHMAP_FNS(map)->remove((map), (key))
+/**
+ * @brief 检查是否包含指定的键。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @param key (K) 要检查的键。
+ * @return (bool) 如果键存在，则返回 `true`；否则返回 `false`。
+ */
+#define persistent_hashmap_contains(map, key) __PERSISTENT_HASHMAP_FNS(map)->contains((map), (key))
+/**
+ * @brief 组提交：把缓冲区中的全部记录作为一帧写入日志并 `fdatasync`。
+ * 返回 `true` 后，此前的所有修改在崩溃后都能恢复。必要时会在后台启动一次压缩。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @return (bool) 成功返回 `true`；任何一次写盘或压缩失败后都返回 `false`。
+ * @example persistent_hashmap_sync(sessions);   // 例如每个请求批次结束时调用一次
+ */
+#define persistent_hashmap_sync(map) __PERSISTENT_HASHMAP_FNS(map)->sync(map)
+/**
+ * @brief 立即压缩：重写快照、切换到新日志，并等待快照写完。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @return (bool) 成功返回 `true`，否则返回 `false`。
+ */
+#define persistent_hashmap_compact(map) __PERSISTENT_HASHMAP_FNS(map)->compact(map)
+// === 公共API: 工具与生命周期宏 ===
+/**
+ * @brief 返回键值对的数量。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @return (int) 键值对数量。
+ */
+#define persistent_hashmap_size(map) hashmap_size((map)->table)
+/**
+ * @brief 返回内存中的哈希表，可用 `hashmap_get_iterator` 等只读操作访问；
+ * 直接修改它不会被记录到日志中。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @return (hashmap(K,V)) 内存中的哈希表。
+ */
+#define persistent_hashmap_view(map) (map)->table
+/**
+ * @brief 将持久化哈希表的内容显示到给定的文件流。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @param stream (FILE*) 输出流。
+ */
+#define persistent_hashmap_display(map, stream) __PERSISTENT_HASHMAP_FNS(map)->display((map), (stream))
+/**
+ * @brief 提交缓冲区中剩余的记录，等待后台压缩结束，然后关闭文件并释放全部内存。
+ * @param map (persistent_hashmap(K,V)) 持久化哈希表实例。
+ * @return (bool) 所有数据都已持久化时返回 `true`。
+ */
+#define persistent_hashmap_free(map) __PERSISTENT_HASHMAP_FNS(map)->free(map)
+
+#endif // PERSISTENT_HASHMAP_H
@@ -0,0 +1,531 @@
+#ifndef READ_MOSTLY_HASHMAP_H
+#define READ_MOSTLY_HASHMAP_H
+
+#include <pthread.h>
+#include "hashmap.h"
+
+/**
+ * @file read_mostly_hashmap.h
+ * @brief 一个读操作完全无锁的、面向"读多写少"场景的泛型哈希表 (C-OOP-Container)。
+ *
+ * 适用于配置表、路由表这类每秒被读取数百万次、却很少更新的哈希表。
+ * - 读操作不加锁，也不执行任何原子读-改-写指令：只以 acquire 语义沿桶数组和
+ *   `next` 指针遍历链表，因此读吞吐量随核心数线性增长。
+ * - 写操作 (`put`/`remove`/`clear`) 之间由一把互斥锁串行化。已发布的条目从不被
+ *   原地修改：更新值时发布一个新节点替换旧节点，扩容时把所有条目复制到新的桶数组
+ *   后整体替换，读者看到的要么是旧版本，要么是新版本。
+ * - 被替换下来的节点与桶数组采用基于纪元的回收 (epoch-based reclamation)：
+ *   每个读线程在读取期间公布自己所处的纪元，只有当所有活跃读者都已离开某个纪元
+ *   两代之后，该纪元中退休的内存才会被释放。
+ *
+ * 与 `concurrent_hashmap.h` 一样，本容器不返回指向内部的指针：
+ * `read_mostly_hashmap_get` 把值复制到调用者提供的变量中。
+ *
+ * @note 依赖 POSIX 线程，编译时需要 `-pthread`。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+/**
+ * @brief 每个读线程在纪元回收中使用的登记记录，独占一个缓存行。
+ * `epoch` 为 0 表示该线程当前不在读取临界区内。
+ */
+typedef struct HashmapEbrRecord {
+    uint64_t epoch;
+    int in_use;
+    struct HashmapEbrRecord* next;
+} __attribute__((aligned(64))) HashmapEbrRecord;
+
+/**
+ * @brief 一块已退休、等待宽限期结束后释放的内存。
+ */
+typedef struct HashmapEbrRetired {
+    void* ptr;
+    void (*free_fn)(void* ptr);
+    uint64_t epoch;
+    struct HashmapEbrRetired* next;
+} HashmapEbrRetired;
+
+/**
+ * @brief 纪元回收的全局状态：全局纪元、读线程登记记录链表以及线程退出时归还记录用的线程键。
+ *
+ * 与每个线程当前持有的记录 (`hashmap_ebr_local`) 一样以弱符号定义，同一程序中的所有翻译单元
+ * 共享同一个回收域：无论读者和写者位于哪个翻译单元 (包括静态分派模式下直接调用的实现)，
+ * 写者推进纪元时都能看到所有读者。
+ */
+typedef struct {
+    uint64_t epoch;
+    HashmapEbrRecord* records;
+    pthread_key_t key;
+    pthread_once_t once;
+} HashmapEbrDomain;
+
+__attribute__((weak)) HashmapEbrDomain hashmap_ebr_domain = {1, NULL, 0, PTHREAD_ONCE_INIT};
+__attribute__((weak)) __thread HashmapEbrRecord* hashmap_ebr_local;
+
+// --- Internal Helper Functions ---
+static inline uint64_t* Hashmap_ebr_global_epoch(void) {
+    return &hashmap_ebr_domain.epoch;
+}
+// --- Internal Helper Functions ---
+static inline HashmapEbrRecord** Hashmap_ebr_records(void) {
+    return &hashmap_ebr_domain.records;
+}
+// --- Internal Helper Functions ---
+static inline pthread_key_t* Hashmap_ebr_key(void) {
+    return &hashmap_ebr_domain.key;
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_ebr_release_record(void* record) {
+    __atomic_store_n(&((HashmapEbrRecord*) record)->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&((HashmapEbrRecord*) record)->in_use, 0, __ATOMIC_RELEASE);
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_ebr_create_key(void) {
+    pthread_key_create(Hashmap_ebr_key(), Hashmap_ebr_release_record);
+}
+// --- Internal Helper Functions ---
+static inline HashmapEbrRecord* Hashmap_ebr_record(void) {
+    HashmapEbrRecord* local = hashmap_ebr_local;
+    if (local != NULL) {
+        return local;
+    }
+    pthread_once(&hashmap_ebr_domain.once, Hashmap_ebr_create_key);
+    HashmapEbrRecord** records = Hashmap_ebr_records();
+    for (HashmapEbrRecord* record = __atomic_load_n(records, __ATOMIC_ACQUIRE); record != NULL; record = record->next) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&record->in_use, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            local = record;
+            break;
+        }
+    }
+    if (local == NULL) {
+        local = (HashmapEbrRecord*) aligned_alloc(__alignof__(HashmapEbrRecord), sizeof(HashmapEbrRecord));
+        local->epoch = 0;
+        local->in_use = 1;
+        local->next = __atomic_load_n(records, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(records, &local->next, local, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+    }
+    pthread_setspecific(*Hashmap_ebr_key(), local);
+    hashmap_ebr_local = local;
+    return local;
+}
+// --- Internal Helper Functions ---
+static inline HashmapEbrRecord* Hashmap_ebr_enter(void) {
+    HashmapEbrRecord* record = Hashmap_ebr_record();
+    __atomic_store_n(&record->epoch, __atomic_load_n(Hashmap_ebr_global_epoch(), __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return record;
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_ebr_exit(HashmapEbrRecord* record) {
+    __atomic_store_n(&record->epoch, 0, __ATOMIC_RELEASE);
+}
+// --- Internal Helper Functions ---
+static inline uint64_t Hashmap_ebr_try_advance(void) {
+    uint64_t* global = Hashmap_ebr_global_epoch();
+    uint64_t epoch = __atomic_load_n(global, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (HashmapEbrRecord* record = __atomic_load_n(Hashmap_ebr_records(), __ATOMIC_ACQUIRE); record != NULL;
+         record = record->next) {
+        uint64_t active = __atomic_load_n(&record->epoch, __ATOMIC_ACQUIRE);
+        if (active != 0 && active != epoch) {
+            return epoch;
+        }
+    }
+    __atomic_compare_exchange_n(global, &epoch, epoch + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+    return __atomic_load_n(global, __ATOMIC_ACQUIRE);
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_ebr_retire(HashmapEbrRetired** retired, void* ptr, void (*free_fn)(void* ptr)) {
+    HashmapEbrRetired* node = (HashmapEbrRetired*) malloc(sizeof(HashmapEbrRetired));
+    node->ptr = ptr;
+    node->free_fn = free_fn;
+    node->epoch = __atomic_load_n(Hashmap_ebr_global_epoch(), __ATOMIC_ACQUIRE);
+    node->next = *retired;
+    *retired = node;
+}
+// --- Internal Helper Functions ---
+static inline void Hashmap_ebr_reclaim(HashmapEbrRetired** retired, bool all) {
+    uint64_t epoch = all ? UINT64_MAX : Hashmap_ebr_try_advance();
+    while (*retired != NULL) {
+        HashmapEbrRetired* node = *retired;
+        if (all || node->epoch + 2 <= epoch) {
+            *retired = node->next;
+            node->free_fn(node->ptr);
+            free(node);
+        } else {
+            retired = &node->next;
+        }
+    }
+}
+
+// === 公共API: 编译期配置 ===
+
+/**
+ * @brief 静态分派模式下需要直接绑定的读多写少哈希表类型列表，用法与 `COOP_HASHMAP_TYPES` 相同。
+ */
+#ifndef COOP_READ_MOSTLY_HASHMAP_TYPES
+#define COOP_READ_MOSTLY_HASHMAP_TYPES(X)
+#endif
+
+#ifdef COOP_STATIC_DISPATCH
+// --- Internal Macros ---
+#define __READ_MOSTLY_HASHMAP_VTABLE(self, K, V) (&READ_MOSTLY_HASHMAP_##K##V##FUNCTIONS)
+// --- Internal Macros ---
+#define __READ_MOSTLY_HASHMAP_FNS_CASE(K, V) ReadMostlyHashmap_##K##_##V*: &READ_MOSTLY_HASHMAP_##K##V##FUNCTIONS,
+// --- Internal Macros ---
+#define __READ_MOSTLY_HASHMAP_FNS(map)                                                                              \
+    _Generic((map), COOP_READ_MOSTLY_HASHMAP_TYPES(__READ_MOSTLY_HASHMAP_FNS_CASE) default: (map)->fns)
+#else
+// --- Internal Macros ---
+#define __READ_MOSTLY_HASHMAP_VTABLE(self, K, V) ((self)->fns)
+// --- Internal Macros ---
+#define __READ_MOSTLY_HASHMAP_FNS(map) (map)->fns
+#endif
+
+// === 公共API: 定义宏 ===
+
+/**
+ * @brief 为指定的键值对类型定义一个具有默认行为的读多写少哈希表。
+ *
+ * 与 `HASHMAP_DEFINE` 相同，为基本类型自动生成哈希、比较和显示函数。
+ *
+ * @note **重要提示**: `K` 和 `V` 的类型名不能包含空格或星号 (`*`)。
+ *       请使用 `typedef` 创建一个单一名词的别名。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ *
+ * @example
+ * READ_MOSTLY_HASHMAP_DEFINE(cstr, int)
+ * read_mostly_hashmap(cstr, int) routes = read_mostly_hashmap_new(cstr, int);
+ */
+#define READ_MOSTLY_HASHMAP_DEFINE(K, V)                                                                            \
+__HASHMAP_DEFINE_DEFAULT_FUNCTIONS(ReadMostlyHashmap, K, V)                                                         \
+READ_MOSTLY_HASHMAP_DEFINE_CUSTOM(K, V,                                                                             \
+    ReadMostlyHashmap_##K##_##V##_hash,                                                                             \
+    ReadMostlyHashmap_##K##_##V##_equals,                                                                           \
+    ReadMostlyHashmap_##K##_##V##_key_display,                                                                      \
+    ReadMostlyHashmap_##K##_##V##_value_display                                                                     \
+)                                                                                                                   \
+/**
+ * @brief 定义一个具有自定义行为函数的读多写少哈希表。
+ *
+ * 参数约定与 `HASHMAP_DEFINE_CUSTOM` 完全一致。`HashFn` 与 `EqualsFn` 会被无锁的
+ * 读操作与写操作并发调用，因此必须是无副作用的纯函数。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ * @param HashFn 用于哈希键的函数指针，类型为 `uint64_t (*)(K key)`。
+ * @param EqualsFn 用于比较键的函数指针，类型为 `bool (*)(K key1, K key2)`。
+ * @param DisplayKeyFn 用于打印键的函数指针，类型为 `void (*)(FILE* stream, K key)`。
+ * @param DisplayValueFn 用于打印值的函数指针，类型为 `void (*)(FILE* stream, V value)`。
+ */
+#define READ_MOSTLY_HASHMAP_DEFINE_CUSTOM(K, V, HashFn, EqualsFn, DisplayKeyFn, DisplayValueFn)                     \
+                                                                                                                    \
+typedef struct __ReadMostlyHashmap_##K##_##V ReadMostlyHashmap_##K##_##V;                                           \
+                                                                                                                    \
+struct ReadMostlyHashmapEntry_##K##_##V {                                                                           \
+    K key;                                                                                                          \
+    V value;                                                                                                        \
+    uint64_t hash;                                                                                                  \
+    struct ReadMostlyHashmapEntry_##K##_##V* next;                                                                  \
+};                                                                                                                  \
+                                                                                                                    \
+struct ReadMostlyHashmapTable_##K##_##V {                                                                           \
+    int capacity;                                                                                                   \
+    struct ReadMostlyHashmapEntry_##K##_##V* buckets[];                                                             \
+};                                                                                                                  \
+                                                                                                                    \
+struct ReadMostlyHashmap_##K##_##V##_Functions {                                                                    \
+    uint64_t (*hash)(K key);                                                                                        \
+    bool (*equals)(K key1, K key2);                                                                                 \
+    void (*display_key)(FILE* stream, K key);                                                                       \
+    void (*display_value)(FILE* stream, V value);                                                                   \
+    void (*display)(ReadMostlyHashmap_##K##_##V* self, FILE* stream);                                               \
+    void (*put)(ReadMostlyHashmap_##K##_##V* self, K key, V value);                                                 \
+    bool (*get)(ReadMostlyHashmap_##K##_##V* self, K key, V* value);                                                \
+    bool (*remove)(ReadMostlyHashmap_##K##_##V* self, K key);                                                       \
+    bool (*contains)(ReadMostlyHashmap_##K##_##V* self, K key);                                                     \
+    void (*clear)(ReadMostlyHashmap_##K##_##V* self);                                                               \
+    void (*free)(ReadMostlyHashmap_##K##_##V* self);                                                                \
+};                                                                                                                  \
+                                                                                                                    \
+struct __ReadMostlyHashmap_##K##_##V {                                                                              \
+    const struct ReadMostlyHashmap_##K##_##V##_Functions* fns;                                                      \
+    struct ReadMostlyHashmapTable_##K##_##V* table;                                                                 \
+    int size;                                                                                                       \
+    pthread_mutex_t write_lock;                                                                                     \
+    HashmapEbrRetired* retired;                                                                                     \
+};                                                                                                                  \
+                                                                                                                    \
+const static struct ReadMostlyHashmap_##K##_##V##_Functions READ_MOSTLY_HASHMAP_##K##V##FUNCTIONS;                  \
+                                                                                                                    \
+static struct ReadMostlyHashmapTable_##K##_##V* ReadMostlyHashmap_##K##_##V##_table_new(int capacity) {             \
+    size_t size = sizeof(struct ReadMostlyHashmapTable_##K##_##V) +                                                 \
+                  capacity * sizeof(struct ReadMostlyHashmapEntry_##K##_##V*);                                      \
+    struct ReadMostlyHashmapTable_##K##_##V* table = (struct ReadMostlyHashmapTable_##K##_##V*) calloc(1, size);    \
+    table->capacity = capacity;                                                                                     \
+    return table;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static void ReadMostlyHashmap_##K##_##V##_table_free(void* ptr) {                                                   \
+    struct ReadMostlyHashmapTable_##K##_##V* table = (struct ReadMostlyHashmapTable_##K##_##V*) ptr;                \
+    for (int i = 0; i < table->capacity; i++) {                                                                     \
+        struct ReadMostlyHashmapEntry_##K##_##V* entry = table->buckets[i];                                         \
+        while (entry != NULL) {                                                                                     \
+            struct ReadMostlyHashmapEntry_##K##_##V* next_entry = entry->next;                                      \
+            free(entry);                                                                                            \
+            entry = next_entry;                                                                                     \
+        }                                                                                                           \
+    }                                                                                                               \
+    free(table);                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static struct ReadMostlyHashmapEntry_##K##_##V* ReadMostlyHashmap_##K##_##V##_entry_new(                            \
+    K key, V value, uint64_t hash, struct ReadMostlyHashmapEntry_##K##_##V* next) {                                 \
+    struct ReadMostlyHashmapEntry_##K##_##V* entry =                                                                \
+        (struct ReadMostlyHashmapEntry_##K##_##V*) malloc(sizeof(struct ReadMostlyHashmapEntry_##K##_##V));         \
+    entry->key = key;                                                                                               \
+    entry->value = value;                                                                                           \
+    entry->hash = hash;                                                                                             \
+    entry->next = next;                                                                                             \
+    return entry;                                                                                                   \
+}                                                                                                                   \
+                                                                                                                    \
+static void ReadMostlyHashmap_##K##_##V##_resize(ReadMostlyHashmap_##K##_##V* self) {                               \
+    struct ReadMostlyHashmapTable_##K##_##V* old_table = self->table;                                               \
+    struct ReadMostlyHashmapTable_##K##_##V* table =                                                                \
+        ReadMostlyHashmap_##K##_##V##_table_new(old_table->capacity * 2);                                           \
+    for (int i = 0; i < old_table->capacity; i++) {                                                                 \
+        for (struct ReadMostlyHashmapEntry_##K##_##V* entry = old_table->buckets[i]; entry != NULL;                 \
+             entry = entry->next) {                                                                                 \
+            struct ReadMostlyHashmapEntry_##K##_##V** bucket =                                                      \
+                &table->buckets[entry->hash & (table->capacity - 1)];                                               \
+            *bucket = ReadMostlyHashmap_##K##_##V##_entry_new(entry->key, entry->value, entry->hash, *bucket);      \
+        }                                                                                                           \
+    }                                                                                                               \
+    __atomic_store_n(&self->table, table, __ATOMIC_RELEASE);                                                        \
+    Hashmap_ebr_retire(&self->retired, old_table, ReadMostlyHashmap_##K##_##V##_table_free);                        \
+}                                                                                                                   \
+                                                                                                                    \
+static struct ReadMostlyHashmapEntry_##K##_##V** ReadMostlyHashmap_##K##_##V##_find_link(                           \
+    ReadMostlyHashmap_##K##_##V* self, K key, uint64_t hash) {                                                      \
+    struct ReadMostlyHashmapEntry_##K##_##V** link = &self->table->buckets[hash & (self->table->capacity - 1)];     \
+    while (*link != NULL) {                                                                                         \
+        if ((*link)->hash == hash && __READ_MOSTLY_HASHMAP_VTABLE(self, K, V)->equals((*link)->key, key)) {         \
+            return link;                                                                                            \
+        }                                                                                                           \
+        link = &(*link)->next;                                                                                      \
+    }                                                                                                               \
+    return link;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void ReadMostlyHashmap_##K##_##V##_display(ReadMostlyHashmap_##K##_##V* self, FILE* stream) {                \
+    HashmapEbrRecord* record = Hashmap_ebr_enter();                                                                 \
+    struct ReadMostlyHashmapTable_##K##_##V* table = __atomic_load_n(&self->table, __ATOMIC_ACQUIRE);               \
+    fprintf(stream, "{");                                                                                           \
+    bool first = true;                                                                                              \
+    for (int i = 0; i < table->capacity; i++) {                                                                     \
+        struct ReadMostlyHashmapEntry_##K##_##V* entry = __atomic_load_n(&table->buckets[i], __ATOMIC_ACQUIRE);     \
+        while (entry != NULL) {                                                                                     \
+            if (!first) {                                                                                           \
+                fprintf(stream, ", ");                                                                              \
+            }                                                                                                       \
+            first = false;                                                                                          \
+            __READ_MOSTLY_HASHMAP_VTABLE(self, K, V)->display_key(stream, entry->key);                              \
+            fprintf(stream, ": ");                                                                                  \
+            __READ_MOSTLY_HASHMAP_VTABLE(self, K, V)->display_value(stream, entry->value);                          \
+            entry = __atomic_load_n(&entry->next, __ATOMIC_ACQUIRE);                                                \
+        }                                                                                                           \
+    }                                                                                                               \
+    fprintf(stream, "}");                                                                                           \
+    Hashmap_ebr_exit(record);                                                                                       \
+}                                                                                                                   \
+                                                                                                                    \
+static void ReadMostlyHashmap_##K##_##V##_put(ReadMostlyHashmap_##K##_##V* self, K key, V value) {                  \
+    uint64_t hash = __READ_MOSTLY_HASHMAP_VTABLE(self, K, V)->hash(key);                                            \
+    pthread_mutex_lock(&self->write_lock);                                                                          \
+    struct ReadMostlyHashmapEntry_##K##_##V** link = ReadMostlyHashmap_##K##_##V##_find_link(self, key, hash);      \
+    struct ReadMostlyHashmapEntry_##K##_##V* old_entry = *link;                                                     \
+    if (old_entry != NULL) {                                                                                        \
+        struct ReadMostlyHashmapEntry_##K##_##V* entry =                                                            \
+            ReadMostlyHashmap_##K##_##V##_entry_new(key, value, hash, old_entry->next);                             \
+        __atomic_store_n(link, entry, __ATOMIC_RELEASE);                                                            \
+        Hashmap_ebr_retire(&self->retired, old_entry, free);                                                        \
+    } else {                                                                                                        \
+        struct ReadMostlyHashmapEntry_##K##_##V** bucket =                                                          \
+            &self->table->buckets[hash & (self->table->capacity - 1)];                                              \
+        struct ReadMostlyHashmapEntry_##K##_##V* entry =                                                            \
+            ReadMostlyHashmap_##K##_##V##_entry_new(key, value, hash, *bucket);                                     \
+        __atomic_store_n(bucket, entry, __ATOMIC_RELEASE);                                                          \
+        __atomic_store_n(&self->size, self->size + 1, __ATOMIC_RELAXED);                                            \
+        if (self->size > self->table->capacity * __HASHMAP_LOAD_FACTOR) {                                           \
+            ReadMostlyHashmap_##K##_##V##_resize(self);                                                             \
+        }                                                                                                           \
+    }                                                                                                               \
+    Hashmap_ebr_reclaim(&self->retired, false);                                                                     \
+    pthread_mutex_unlock(&self->write_lock);                                                                        \
+}                                                                                                                   \
+                                                                                                                    \
+static bool ReadMostlyHashmap_##K##_##V##_get(ReadMostlyHashmap_##K##_##V* self, K key, V* value) {                 \
+    uint64_t hash = __READ_MOSTLY_HASHMAP_VTABLE(self, K, V)->hash(key);                                            \
+    HashmapEbrRecord* record = Hashmap_ebr_enter();                                                                 \
+    struct ReadMostlyHashmapTable_##K##_##V* table = __atomic_load_n(&self->table, __ATOMIC_ACQUIRE);               \
+    struct ReadMostlyHashmapEntry_##K##_##V* entry =                                                                \
+        __atomic_load_n(&table->buckets[hash & (table->capacity - 1)], __ATOMIC_ACQUIRE);                           \
+    while (entry != NULL) {                                                                                         \
+        if (entry->hash == hash && __READ_MOSTLY_HASHMAP_VTABLE(self, K, V)->equals(entry->key, key)) {             \
+            if (value != NULL) {                                                                                    \
+                *value = entry->value;                                                                              \
+            }                                                                                                       \
+            break;                                                                                                  \
+        }                                                                                                           \
+        entry = __atomic_load_n(&entry->next, __ATOMIC_ACQUIRE);                                                    \
+    }                                                                                                               \
+    Hashmap_ebr_exit(record);                                                                                       \
+    return entry != NULL;                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static bool ReadMostlyHashmap_##K##_##V##_remove(ReadMostlyHashmap_##K##_##V* self, K key) {                        \
+    uint64_t hash = __READ_MOSTLY_HASHMAP_VTABLE(self, K, V)->hash(key);                                            \
+    pthread_mutex_lock(&self->write_lock);                                                                          \
+    struct ReadMostlyHashmapEntry_##K##_##V** link = ReadMostlyHashmap_##K##_##V##_find_link(self, key, hash);      \
+    struct ReadMostlyHashmapEntry_##K##_##V* entry = *link;                                                         \
+    if (entry != NULL) {                                                                                            \
+        __atomic_store_n(link, entry->next, __ATOMIC_RELEASE);                                                      \
+        __atomic_store_n(&self->size, self->size - 1, __ATOMIC_RELAXED);                                            \
+        Hashmap_ebr_retire(&self->retired, entry, free);                                                            \
+    }                                                                                                               \
+    Hashmap_ebr_reclaim(&self->retired, false);                                                                     \
+    pthread_mutex_unlock(&self->write_lock);                                                                        \
+    return entry != NULL;                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static bool ReadMostlyHashmap_##K##_##V##_contains(ReadMostlyHashmap_##K##_##V* self, K key) {                      \
+    return ReadMostlyHashmap_##K##_##V##_get(self, key, NULL);                                                      \
+}                                                                                                                   \
+                                                                                                                    \
+static void ReadMostlyHashmap_##K##_##V##_clear(ReadMostlyHashmap_##K##_##V* self) {                                \
+    pthread_mutex_lock(&self->write_lock);                                                                          \
+    struct ReadMostlyHashmapTable_##K##_##V* old_table = self->table;                                               \
+    __atomic_store_n(&self->table, ReadMostlyHashmap_##K##_##V##_table_new(16), __ATOMIC_RELEASE);                  \
+    __atomic_store_n(&self->size, 0, __ATOMIC_RELAXED);                                                             \
+    Hashmap_ebr_retire(&self->retired, old_table, ReadMostlyHashmap_##K##_##V##_table_free);                        \
+    Hashmap_ebr_reclaim(&self->retired, false);                                                                     \
+    pthread_mutex_unlock(&self->write_lock);                                                                        \
+}                                                                                                                   \
+                                                                                                                    \
+static void ReadMostlyHashmap_##K##_##V##_free(ReadMostlyHashmap_##K##_##V* self) {                                 \
+    Hashmap_ebr_reclaim(&self->retired, true);                                                                      \
+    ReadMostlyHashmap_##K##_##V##_table_free(self->table);                                                          \
+    pthread_mutex_destroy(&self->write_lock);                                                                       \
+    free(self);                                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+const static struct ReadMostlyHashmap_##K##_##V##_Functions READ_MOSTLY_HASHMAP_##K##V##FUNCTIONS = {               \
+    .hash = HashFn,                                                                                                 \
+    .equals = EqualsFn,                                                                                             \
+    .display_key = DisplayKeyFn,                                                                                    \
+    .display_value = DisplayValueFn,                                                                                \
+    .display = ReadMostlyHashmap_##K##_##V##_display,                                                               \
+    .put = ReadMostlyHashmap_##K##_##V##_put,                                                                       \
+    .get = ReadMostlyHashmap_##K##_##V##_get,                                                                       \
+    .remove = ReadMostlyHashmap_##K##_##V##_remove,                                                                 \
+    .contains = ReadMostlyHashmap_##K##_##V##_contains,                                                             \
+    .clear = ReadMostlyHashmap_##K##_##V##_clear,                                                                   \
+    .free = ReadMostlyHashmap_##K##_##V##_free,                                                                     \
+};                                                                                                                  \
+                                                                                                                    \
+static ReadMostlyHashmap_##K##_##V* ReadMostlyHashmap_##K##_##V##_new(int capacity) {                               \
+    ReadMostlyHashmap_##K##_##V* self = (ReadMostlyHashmap_##K##_##V*) malloc(sizeof(ReadMostlyHashmap_##K##_##V)); \
+    self->fns = &READ_MOSTLY_HASHMAP_##K##V##FUNCTIONS;                                                             \
+    self->table = ReadMostlyHashmap_##K##_##V##_table_new(capacity);                                                \
+    self->size = 0;                                                                                                 \
+    pthread_mutex_init(&self->write_lock, NULL);                                                                    \
+    self->retired = NULL;                                                                                           \
+    return self;                                                                                                    \
+}                                                                                                                   \
+
+// === 公共API: 类型与构造函数宏 ===
+/**
+ * @brief 声明一个指向特定读多写少哈希表类型的指针。
+ * @param K 在 READ_MOSTLY_HASHMAP_DEFINE 中使用的键类型。
+ * @param V 在 READ_MOSTLY_HASHMAP_DEFINE 中使用的值类型。
+ * @example read_mostly_hashmap(cstr, int) routes;
+ */
+#define read_mostly_hashmap(K, V) ReadMostlyHashmap_##K##_##V*
+/**
+ * @brief 创建一个具有默认初始容量 (16) 的新读多写少哈希表。
+ * @param K 键的类型。
+ * @param V 值的类型。
+ * @return 指向新创建的哈希表的指针。
+ * @example routes = read_mostly_hashmap_new(cstr, int);
+ */
+#define read_mostly_hashmap_new(K, V) ReadMostlyHashmap_##K##_##V##_new(16)
+// === 公共API: 核心操作宏 ===
+/**
+ * @brief 插入或更新一个键值对。写操作之间互斥，但不会阻塞并发的读操作。
+ * @param map (read_mostly_hashmap(K,V)) 哈希表实例。
+ * @param key (K) 键。
+ * @param ... (V value) 与键关联的值。
+ * @example read_mostly_hashmap_put(routes, "/api", 8080);
+ */
+#define read_mostly_hashmap_put(map, key, ...) __READ_MOSTLY_HASHMAP_FNS(map)->put((map), (key), __VA_ARGS__)
+/**
+ * @brief 无锁地查找键，并在找到时把值复制到 `*out`。可被任意多个线程同时调用。
+ * @param map (read_mostly_hashmap(K,V)) 哈希表实例。
+ * @param key (K) 要查找的键。
+ * @param out (V*) 接收值的变量地址，可以为 NULL。
+ * @return (bool) 如果找到键，则返回 `true`；否则返回 `false`。
+ * @example int port; if (read_mostly_hashmap_get(routes, "/api", &port)) { ... }
+ */
+#define read_mostly_hashmap_get(map, key, out) __READ_MOSTLY_HASHMAP_FNS(map)->get((map), (key), (out))
+/**
+ * @brief 移除一个键值对。被移除的节点在所有可能仍在读取它的线程离开后才被释放。
+ * @param map (read_mostly_hashmap(K,V)) 哈希表实例。
+ * @param key (K) 要移除条目的键。
+ * @return (bool) 如果成功移除了一个元素，则返回 `true`；否则返回 `false`。
+ * @example read_mostly_hashmap_remove(routes, "/api");
+ */
+#define read_mostly_hashmap_remove(map, key) __READ_MOSTLY_HASHMAP_FNS(map)->remove((map), (key))
+/**
+ * @brief 无锁地检查哈希表是否包含指定的键。
+ * @param map (read_mostly_hashmap(K,V)) 哈希表实例。
+ * @param key (K) 要检查的键。
+ * @return (bool) 如果键存在，则返回 `true`；否则返回 `false`。
+ * @example if (read_mostly_hashmap_contains(routes, "/api")) { ... }
+ */
+#define read_mostly_hashmap_contains(map, key) __READ_MOSTLY_HASHMAP_FNS(map)->contains((map), (key))
+// === 公共API: 工具与生命周期宏 ===
+/**
+ * @brief 将哈希表的内容显示到给定的文件流。
+ * @param map (read_mostly_hashmap(K,V)) 哈希表实例。
+ * @param stream (FILE*) 输出流。
+ * @example read_mostly_hashmap_display(routes, stdout);
+ */
+#define read_mostly_hashmap_display(map, stream) __READ_MOSTLY_HASHMAP_FNS(map)->display((map), (stream))
+/**
+ * @brief 返回哈希表中键值对的数量。
+ * @param map (read_mostly_hashmap(K,V)) 哈希表实例。
+ * @return (int) 当前大小。
+ * @example int count = read_mostly_hashmap_size(routes);
+ */
+#define read_mostly_hashmap_size(map) __atomic_load_n(&(map)->size, __ATOMIC_RELAXED)
+/**
+ * @brief 移除所有键值对。
+ * @param map (read_mostly_hashmap(K,V)) 哈希表实例。
+ * @example read_mostly_hashmap_clear(routes);
+ */
+#define read_mostly_hashmap_clear(map) __READ_MOSTLY_HASHMAP_FNS(map)->clear(map)
+/**
+ * @brief 释放与哈希表相关的所有内存，包括尚未回收的退休节点。调用时不能再有其他线程访问该哈希表。
+ * @param map (read_mostly_hashmap(K,V)) 哈希表实例。
+ * @example read_mostly_hashmap_free(routes);
+ */
+#define read_mostly_hashmap_free(map) __READ_MOSTLY_HASHMAP_FNS(map)->free(map)
+
+#endif // READ_MOSTLY_HASHMAP_H
@@ -0,0 +1,297 @@
+#ifndef SHARDED_HASHMAP_H
+#define SHARDED_HASHMAP_H
+
+#include <pthread.h>
+#include "hashmap.h"
+
+/**
+ * @file sharded_hashmap.h
+ * @brief 由每个线程独占的分片哈希表组成、可按哈希分区并行合并的泛型容器 (C-OOP-Container)。
+ *
+ * 适用于分组聚合这类"各线程先独立累计、最后汇总"的任务。
+ * - 构建阶段：每个线程拥有自己的一行分片，行内再按哈希值的高位划分为 `partitions` 个分区，
+ *   每个分片都是一个普通的 `hashmap(K,V)`。线程只访问自己的行，不需要任何同步，
+ *   可以直接使用全部 `hashmap_*` 操作。
+ * - 合并阶段：`sharded_hashmap_merge` 让多个工作线程各自认领分区，把同一分区在所有行中的
+ *   分片通过 `hashmap_merge_into` 合并到一起。不同分区的键集合互不相交，
+ *   因此合并过程完全没有锁，耗时约为单表合并的 1/线程数。
+ *
+ * 分片使用的是当前已定义的 `Hashmap_K_V`，因此可以与 `hashmap.h`、`hashmap_open.h` 或
+ * `hashmap_swiss.h` 中任意一种后端配合使用。
+ *
+ * @note 依赖 POSIX 线程，编译时需要 `-pthread`。
+ *
+ * @version 1.0
+ * @date 2026-10-16
+ */
+
+// === 公共API: 编译期配置 ===
+
+/**
+ * @brief 静态分派模式下需要直接绑定的分片哈希表类型列表，用法与 `COOP_HASHMAP_TYPES` 相同。
+ */
+#ifndef COOP_SHARDED_HASHMAP_TYPES
+#define COOP_SHARDED_HASHMAP_TYPES(X)
+#endif
+
+#ifdef COOP_STATIC_DISPATCH
+// --- Internal Macros ---
+#define __SHARDED_HASHMAP_VTABLE(self, K, V) (&SHARDED_HASHMAP_##K##V##FUNCTIONS)
+// --- Internal Macros ---
+#define __SHARDED_HASHMAP_FNS_CASE(K, V) ShardedHashmap_##K##_##V*: &SHARDED_HASHMAP_##K##V##FUNCTIONS,
+// --- Internal Macros ---
+#define __SHARDED_HASHMAP_FNS(map)                                                                                  \
+    _Generic((map), COOP_SHARDED_HASHMAP_TYPES(__SHARDED_HASHMAP_FNS_CASE) default: (map)->fns)
+#else
+// --- Internal Macros ---
+#define __SHARDED_HASHMAP_VTABLE(self, K, V) ((self)->fns)
+// --- Internal Macros ---
+#define __SHARDED_HASHMAP_FNS(map) (map)->fns
+#endif
+
+// === 公共API: 定义宏 ===
+
+/**
+ * @brief 为已经定义过的 `hashmap(K,V)` 类型定义对应的分片哈希表。
+ *
+ * 必须先用 `HASHMAP_DEFINE` (或任一后端的同名宏) 定义 `hashmap(K,V)`，
+ * 分片的哈希、比较与显示行为全部沿用该定义。
+ *
+ * @param K 键的类型（必须是单个词）。
+ * @param V 值的类型（必须是单个词）。
+ *
+ * @example
+ * HASHMAP_DEFINE(cstr, int)
+ * SHARDED_HASHMAP_DEFINE(cstr, int)
+ * sharded_hashmap(cstr, int) counts = sharded_hashmap_new(cstr, int, 8);
+ */
+#define SHARDED_HASHMAP_DEFINE(K, V)                                                                                \
+                                                                                                                    \
+typedef struct __ShardedHashmap_##K##_##V ShardedHashmap_##K##_##V;                                                 \
+                                                                                                                    \
+struct ShardedHashmap_##K##_##V##_Functions {                                                                       \
+    void (*display)(ShardedHashmap_##K##_##V* self, FILE* stream);                                                  \
+    Hashmap_##K##_##V* (*shard)(ShardedHashmap_##K##_##V* self, int thread, K key);                                 \
+    const V* (*get)(ShardedHashmap_##K##_##V* self, K key);                                                         \
+    int (*size)(ShardedHashmap_##K##_##V* self);                                                                    \
+    void (*merge)(ShardedHashmap_##K##_##V* self, void (*combine)(V* value, V other_value));                        \
+    void (*free)(ShardedHashmap_##K##_##V* self);                                                                   \
+};                                                                                                                  \
+                                                                                                                    \
+struct __ShardedHashmap_##K##_##V {                                                                                 \
+    const struct ShardedHashmap_##K##_##V##_Functions* fns;                                                         \
+    int threads;                                                                                                    \
+    int partitions;                                                                                                 \
+    HashmapSeed seed;                                                                                               \
+    Hashmap_##K##_##V** shards;                                                                                     \
+};                                                                                                                  \
+                                                                                                                    \
+struct ShardedHashmapMerge_##K##_##V {                                                                              \
+    ShardedHashmap_##K##_##V* self;                                                                                 \
+    void (*combine)(V* value, V other_value);                                                                       \
+    int next;                                                                                                       \
+};                                                                                                                  \
+                                                                                                                    \
+const static struct ShardedHashmap_##K##_##V##_Functions SHARDED_HASHMAP_##K##V##FUNCTIONS;                         \
+                                                                                                                    \
+static int ShardedHashmap_##K##_##V##_partition(ShardedHashmap_##K##_##V* self, K key) {                            \
+    uint64_t hash = HASHMAP_##K##V##FUNCTIONS.keyed_hash != NULL                                                    \
+                        ? HASHMAP_##K##V##FUNCTIONS.keyed_hash(key, &self->seed)                                    \
+                        : HASHMAP_##K##V##FUNCTIONS.hash(key);                                                      \
+    return (int) ((hash >> 32) & (uint64_t) (self->partitions - 1));                                                \
+}                                                                                                                   \
+                                                                                                                    \
+static void ShardedHashmap_##K##_##V##_display(ShardedHashmap_##K##_##V* self, FILE* stream) {                      \
+    fprintf(stream, "{");                                                                                           \
+    bool first = true;                                                                                              \
+    for (int i = 0; i < self->threads * self->partitions; i++) {                                                    \
+        struct HashmapIterator_##K##_##V iter = hashmap_get_iterator(self->shards[i]);                              \
+        while (hashmap_iterator_next(iter)) {                                                                       \
+            if (!first) {                                                                                           \
+                fprintf(stream, ", ");                                                                              \
+            }                                                                                                       \
+            first = false;                                                                                          \
+            HASHMAP_##K##V##FUNCTIONS.display_key(stream, *hashmap_iterator_current_key(iter));                     \
+            fprintf(stream, ": ");                                                                                  \
+            HASHMAP_##K##V##FUNCTIONS.display_value(stream, *hashmap_iterator_current_value(iter));                 \
+        }                                                                                                           \
+    }                                                                                                               \
+    fprintf(stream, "}");                                                                                           \
+}                                                                                                                   \
+                                                                                                                    \
+static Hashmap_##K##_##V* ShardedHashmap_##K##_##V##_shard(ShardedHashmap_##K##_##V* self, int thread, K key) {     \
+    return self->shards[thread * self->partitions + ShardedHashmap_##K##_##V##_partition(self, key)];               \
+}                                                                                                                   \
+                                                                                                                    \
+static const V* ShardedHashmap_##K##_##V##_get(ShardedHashmap_##K##_##V* self, K key) {                             \
+    return hashmap_get(self->shards[ShardedHashmap_##K##_##V##_partition(self, key)], key);                         \
+}                                                                                                                   \
+                                                                                                                    \
+static int ShardedHashmap_##K##_##V##_size(ShardedHashmap_##K##_##V* self) {                                        \
+    int size = 0;                                                                                                   \
+    for (int i = 0; i < self->threads * self->partitions; i++) {                                                    \
+        size += hashmap_size(self->shards[i]);                                                                      \
+    }                                                                                                               \
+    return size;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void* ShardedHashmap_##K##_##V##_merge_worker(void* arg) {                                                   \
+    struct ShardedHashmapMerge_##K##_##V* merge = (struct ShardedHashmapMerge_##K##_##V*) arg;                      \
+    ShardedHashmap_##K##_##V* self = merge->self;                                                                   \
+    int partition;                                                                                                  \
+    while ((partition = __atomic_fetch_add(&merge->next, 1, __ATOMIC_RELAXED)) < self->partitions) {                \
+        Hashmap_##K##_##V** column = self->shards + partition;                                                      \
+        int target = 0;                                                                                             \
+        for (int t = 1; t < self->threads; t++) {                                                                   \
+            if (hashmap_size(column[t * self->partitions]) > hashmap_size(column[target * self->partitions])) {     \
+                target = t;                                                                                         \
+            }                                                                                                       \
+        }                                                                                                           \
+        Hashmap_##K##_##V* dst = column[target * self->partitions];                                                 \
+        for (int t = 0; t < self->threads; t++) {                                                                   \
+            if (t != target) {                                                                                      \
+                hashmap_merge_into(dst, column[t * self->partitions], merge->combine);                              \
+                hashmap_free(column[t * self->partitions]);                                                         \
+            }                                                                                                       \
+        }                                                                                                           \
+        column[0] = dst;                                                                                            \
+    }                                                                                                               \
+    return NULL;                                                                                                    \
+}                                                                                                                   \
+                                                                                                                    \
+static void ShardedHashmap_##K##_##V##_merge(                                                                       \
+    ShardedHashmap_##K##_##V* self, void (*combine)(V* value, V other_value)) {                                     \
+    if (self->threads == 1) {                                                                                       \
+        return;                                                                                                     \
+    }                                                                                                               \
+    struct ShardedHashmapMerge_##K##_##V merge = {self, combine, 0};                                                \
+    pthread_t* workers = (pthread_t*) malloc((self->threads - 1) * sizeof(pthread_t));                              \
+    int started = 0;                                                                                                \
+    while (started < self->threads - 1 &&                                                                           \
+           pthread_create(&workers[started], NULL, ShardedHashmap_##K##_##V##_merge_worker, &merge) == 0) {         \
+        started++;                                                                                                  \
+    }                                                                                                               \
+    ShardedHashmap_##K##_##V##_merge_worker(&merge);                                                                \
+    for (int i = 0; i < started; i++) {                                                                             \
+        pthread_join(workers[i], NULL);                                                                             \
+    }                                                                                                               \
+    free(workers);                                                                                                  \
+    self->threads = 1;                                                                                              \
+    self->shards = (Hashmap_##K##_##V**) realloc(self->shards, self->partitions * sizeof(Hashmap_##K##_##V*));      \
+}                                                                                                                   \
+                                                                                                                    \
+static void ShardedHashmap_##K##_##V##_free(ShardedHashmap_##K##_##V* self) {                                       \
+    for (int i = 0; i < self->threads * self->partitions; i++) {                                                    \
+        hashmap_free(self->shards[i]);                                                                              \
+    }                                                                                                               \
+    free(self->shards);                                                                                             \
+    free(self);                                                                                                     \
+}                                                                                                                   \
+                                                                                                                    \
+const static struct ShardedHashmap_##K##_##V##_Functions SHARDED_HASHMAP_##K##V##FUNCTIONS = {                      \
+    .display = ShardedHashmap_##K##_##V##_display,                                                                  \
+    .shard = ShardedHashmap_##K##_##V##_shard,                                                                      \
+    .get = ShardedHashmap_##K##_##V##_get,                                                                          \
+    .size = ShardedHashmap_##K##_##V##_size,                                                                        \
+    .merge = ShardedHashmap_##K##_##V##_merge,                                                                      \
+    .free = ShardedHashmap_##K##_##V##_free,                                                                        \
+};                                                                                                                  \
+                                                                                                                    \
+static ShardedHashmap_##K##_##V* ShardedHashmap_##K##_##V##_new(int threads) {                                      \
+    ShardedHashmap_##K##_##V* self = (ShardedHashmap_##K##_##V*) malloc(sizeof(ShardedHashmap_##K##_##V));          \
+    self->fns = &SHARDED_HASHMAP_##K##V##FUNCTIONS;                                                                 \
+    self->threads = threads;                                                                                        \
+    self->partitions = 1;                                                                                           \
+    while (self->partitions < threads) {                                                                            \
+        self->partitions *= 2;                                                                                      \
+    }                                                                                                               \
+    Hashmap_random_seed(&self->seed);                                                                               \
+    self->shards = (Hashmap_##K##_##V**) malloc(threads * self->partitions * sizeof(Hashmap_##K##_##V*));           \
+    for (int i = 0; i < threads * self->partitions; i++) {                                                          \
+        self->shards[i] = hashmap_new(K, V);                                                                        \
+    }                                                                                                               \
+    return self;                                                                                                    \
+}                                                                                                                   \
+
+// === 公共API: 类型与构造函数宏 ===
+/**
+ * @brief 声明一个指向特定分片哈希表类型的指针。
+ * @param K 在 SHARDED_HASHMAP_DEFINE 中使用的键类型。
+ * @param V 在 SHARDED_HASHMAP_DEFINE 中使用的值类型。
+ * @example sharded_hashmap(cstr, int) counts;
+ */
+#define sharded_hashmap(K, V) ShardedHashmap_##K##_##V*
+/**
+ * @brief 为 `threads` 个构建线程创建一个新的分片哈希表。
+ * 分区数取不小于 `threads` 的最小 2 的幂，共创建 `threads * 分区数` 个分片。
+ * @param K 键的类型。
+ * @param V 值的类型。
+ * @param threads (int) 构建阶段的线程数量 (至少为 1)。
+ * @return 指向新创建的分片哈希表的指针。
+ * @example counts = sharded_hashmap_new(cstr, int, 8);
+ */
+#define sharded_hashmap_new(K, V, threads) ShardedHashmap_##K##_##V##_new(threads)
+// === 公共API: 核心操作宏 ===
+/**
+ * @brief 返回第 `thread` 个线程存放 `key` 时应使用的分片，之后可对它使用任意 `hashmap_*` 操作。
+ * 每个线程只能访问自己那一行的分片；合并之后只剩下第 0 行。
+ * @param map (sharded_hashmap(K,V)) 分片哈希表实例。
+ * @param thread (int) 线程编号，范围为 `[0, threads)`。
+ * @param key (K) 键。
+ * @return (hashmap(K,V)) 该键所属的分片。
+ * @example (*hashmap_get_or_insert(sharded_hashmap_shard(counts, id, word), word, 0, NULL))++;
+ */
+#define sharded_hashmap_shard(map, thread, key) __SHARDED_HASHMAP_FNS(map)->shard((map), (thread), (key))
+/**
+ * @brief 按哈希分区并行合并所有线程的分片，合并结果保留在第 0 行。
+ * 同一个键在多个线程中出现时，调用 `combine_fn(&value, other_value)` 合并；`combine_fn` 为 NULL 时
+ * 任取其中一个值。调用时不能再有构建线程访问该分片哈希表。
+ * @param map (sharded_hashmap(K,V)) 分片哈希表实例。
+ * @param combine_fn (void (*)(V* value, V other_value)) 合并函数，可以为 NULL。
+ * @example sharded_hashmap_merge(counts, add);
+ */
+#define sharded_hashmap_merge(map, combine_fn) __SHARDED_HASHMAP_FNS(map)->merge((map), (combine_fn))
+/**
+ * @brief 在合并后的结果中查找键。
+ * @param map (sharded_hashmap(K,V)) 已合并的分片哈希表实例。
+ * @param key (K) 要查找的键。
+ * @return (const V*) 指向值的常量指针；未找到则返回 NULL。
+ * @example const int* n = sharded_hashmap_get(counts, "the");
+ */
+#define sharded_hashmap_get(map, key) __SHARDED_HASHMAP_FNS(map)->get((map), (key))
+// === 公共API: 工具与生命周期宏 ===
+/**
+ * @brief 返回分区的数量。
+ * @param map (sharded_hashmap(K,V)) 分片哈希表实例。
+ * @return (int) 分区数。
+ */
+#define sharded_hashmap_partitions(map) (map)->partitions
+/**
+ * @brief 返回合并结果中第 `index` 个分区的哈希表，可用 `hashmap_get_iterator` 遍历。
+ * @param map (sharded_hashmap(K,V)) 已合并的分片哈希表实例。
+ * @param index (int) 分区编号，范围为 `[0, sharded_hashmap_partitions(map))`。
+ * @return (hashmap(K,V)) 该分区的哈希表。
+ */
+#define sharded_hashmap_partition(map, index) (map)->shards[(index)]
+/**
+ * @brief 返回所有分片中键值对数量之和。合并之前，出现在多个线程中的键会被重复计数。
+ * @param map (sharded_hashmap(K,V)) 分片哈希表实例。
+ * @return (int) 键值对数量。
+ * @example int distinct = sharded_hashmap_size(counts);
+ */
+#define sharded_hashmap_size(map) __SHARDED_HASHMAP_FNS(map)->size(map)
+/**
+ * @brief 将分片哈希表的内容显示到给定的文件流。
+ * @param map (sharded_hashmap(K,V)) 分片哈希表实例。
+ * @param stream (FILE*) 输出流。
+ * @example sharded_hashmap_display(counts, stdout);
+ */
+#define sharded_hashmap_display(map, stream) __SHARDED_HASHMAP_FNS(map)->display((map), (stream))
+/**
+ * @brief 释放分片哈希表及其全部分片。
+ * @param map (sharded_hashmap(K,V)) 分片哈希表实例。
+ * @example sharded_hashmap_free(counts);
+ */
+#define sharded_hashmap_free(map) __SHARDED_HASHMAP_FNS(map)->free(map)
+
+#endif // SHARDED_HASHMAP_H
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ *
+ *  concurrent_hashmap.h 回归测试：多线程并发 put / get / remove / compute，
+ *  期间桶数组经历多轮协作式扩容，结束后核对元素数量与全部内容。
+ *
+ *  构建并运行 (在仓库根目录)：
+ *    cc -std=gnu11 -O1 -g -pthread -fsanitize=address,undefined -I. \
+ *       tests/concurrent_hashmap_test.c -o concurrent_hashmap_test && ./concurrent_hashmap_test
+ *    cc -std=gnu11 -O1 -g -pthread -fsanitize=thread -I. \
+ *       tests/concurrent_hashmap_test.c -o concurrent_hashmap_test && ./concurrent_hashmap_test
+ *
+ ******************************************************************************/
+
+// 分段数取小值，让更多线程落在同一分段上，迁移与加锁的交错更密集
+#define CONCURRENT_HASHMAP_STRIPES 16
+#include "concurrent_hashmap.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                                \
+        }                                                                           \
+    } while (0)
+
+enum { WRITERS = 8, READERS = 2, KEYS_PER_WRITER = 40000, COUNTERS = 64 };
+
+CONCURRENT_HASHMAP_DEFINE(int, int);
+
+static concurrent_hashmap(int, int) map;
+static int writers_done;
+
+static void add(int* value, void* context) {
+    *value += *(const int*) context;
+}
+
+// 写线程 t 独占键区间 [t * KEYS_PER_WRITER, (t + 1) * KEYS_PER_WRITER)，
+// 值为键的相反数；下标是 3 的倍数的键插入后立即删除。另外所有写线程共享 COUNTERS 个计数键 (负数)。
+static void* writer(void* arg) {
+    int base = (int) (long) arg * KEYS_PER_WRITER;
+    int one = 1;
+    for (int i = 0; i < KEYS_PER_WRITER; i++) {
+        int key = base + i;
+        int value;
+        concurrent_hashmap_put(map, key, -key);
+        CHECK(concurrent_hashmap_get(map, key, &value) && value == -key);
+        concurrent_hashmap_compute(map, -1 - i % COUNTERS, 0, add, &one);
+        if (i % 3 == 0) {
+            CHECK(concurrent_hashmap_remove(map, key));
+            CHECK(!concurrent_hashmap_contains(map, key));
+            CHECK(!concurrent_hashmap_remove(map, key));
+        }
+    }
+    __atomic_add_fetch(&writers_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// 读线程在扩容进行中反复查找任意键：找得到时值必须正确
+static void* reader(void* arg) {
+    (void) arg;
+    unsigned state = 12345;
+    while (__atomic_load_n(&writers_done, __ATOMIC_ACQUIRE) < WRITERS) {
+        state = state * 1103515245u + 12345u;
+        int key = (int) (state >> 8) % (WRITERS * KEYS_PER_WRITER);
+        int value;
+        if (concurrent_hashmap_get(map, key, &value)) {
+            CHECK(value == -key);
+        }
+    }
+    return NULL;
+}
+
+int main(void) {
+    map = concurrent_hashmap_new(int, int);
+    int initial_capacity = map->table->capacity;
+    pthread_t threads[WRITERS + READERS];
+    for (long t = 0; t < WRITERS; t++) {
+        pthread_create(&threads[t], NULL, writer, (void*) t);
+    }
+    for (int t = 0; t < READERS; t++) {
+        pthread_create(&threads[WRITERS + t], NULL, reader, NULL);
+    }
+    for (int t = 0; t < WRITERS + READERS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    int kept = KEYS_PER_WRITER - (KEYS_PER_WRITER + 2) / 3;
+    CHECK(concurrent_hashmap_size(map) == WRITERS * kept + COUNTERS);
+    CHECK(map->table->capacity >= initial_capacity * 64);
+    for (int key = 0; key < WRITERS * KEYS_PER_WRITER; key++) {
+        int value = 0;
+        bool found = concurrent_hashmap_get(map, key, &value);
+        CHECK(found == (key % KEYS_PER_WRITER % 3 != 0));
+        CHECK(!found || value == -key);
+    }
+    for (int i = 0; i < COUNTERS; i++) {
+        int value = 0;
+        CHECK(concurrent_hashmap_get(map, -1 - i, &value));
+        CHECK(value == WRITERS * KEYS_PER_WRITER / COUNTERS);
+    }
+
+    concurrent_hashmap_clear(map);
+    CHECK(concurrent_hashmap_size(map) == 0);
+    concurrent_hashmap_put(map, 7, 70);
+    int value = 0;
+    CHECK(concurrent_hashmap_get(map, 7, &value) && value == 70);
+    concurrent_hashmap_free(map);
+    puts("concurrent_hashmap_test ok");
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*******************************************************************************
+ *
+ *  persistent_hashmap.h 崩溃恢复回归测试。
+ *
+ *  每个用例先用公共 API 写出真实的快照与日志，再按崩溃发生的时刻拼出对应的文件组合，
+ *  重新打开后与期望内容逐键比对：
+ *  1. 日志尾帧被截断或校验和不符：只丢弃该帧，日志被截回最后一个完整帧，之后追加的写入可以恢复。
+ *  2. 更新的快照旁残留旧一代的 `.log.old`：旧日志不得重放 (否则已删除的键会复活)，打开后被清理。
+ *  3. 压缩时日志已改名为 `.log.old`、新日志尚未创建：从 `.log.old` 恢复并补建日志。
+ *  4. 新日志已创建、新快照尚未写出：依次重放 `.log.old` 与 `.log`，打开时折叠为新快照。
+ *
+ *  构建并运行 (在仓库根目录)：
+ *    cc -std=gnu11 -O1 -g -pthread -fsanitize=address,undefined -I. \
+ *       tests/persistent_hashmap_test.c -o persistent_hashmap_test && ./persistent_hashmap_test
+ *
+ ******************************************************************************/
+
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "hashmap.h"
+#include "persistent_hashmap.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                                \
+        }                                                                           \
+    } while (0)
+
+HASHMAP_DEFINE(int, int);
+PERSISTENT_HASHMAP_DEFINE(int, int);
+
+enum { KEYS = 2000, ABSENT = INT_MIN };
+
+static char directory[] = "/tmp/persistent_hashmap_testXXXXXX";
+static const char* suffixes[] = {".snapshot", ".log", ".log.old", ".snapshot.tmp", ".saved"};
+
+// 期望内容：expected[key] 为值，ABSENT 表示键不存在
+static int expected[KEYS];
+
+static const char* path_of(const char* prefix, const char* suffix) {
+    static char paths[4][96];
+    static int next;
+    char* path = paths[next++ % 4];
+    snprintf(path, sizeof(paths[0]), "%s/%s%s", directory, prefix, suffix);
+    return path;
+}
+
+static bool exists(const char* path) {
+    return access(path, F_OK) == 0;
+}
+
+static off_t size_of(const char* path) {
+    struct stat status;
+    CHECK(stat(path, &status) == 0);
+    return status.st_size;
+}
+
+static void copy_file(const char* src, const char* dst) {
+    FILE* in = fopen(src, "rb");
+    FILE* out = fopen(dst, "wb");
+    CHECK(in != NULL && out != NULL);
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        CHECK(fwrite(buffer, 1, n, out) == n);
+    }
+    fclose(in);
+    fclose(out);
+}
+
+static void put(persistent_hashmap(int, int) map, int key, int value) {
+    persistent_hashmap_put(map, key, value);
+    expected[key] = value;
+}
+
+static void remove_key(persistent_hashmap(int, int) map, int key) {
+    CHECK(persistent_hashmap_remove(map, key));
+    expected[key] = ABSENT;
+}
+
+static void check_contents(persistent_hashmap(int, int) map) {
+    int count = 0;
+    for (int key = 0; key < KEYS; key++) {
+        const int* value = persistent_hashmap_get(map, key);
+        CHECK(expected[key] == ABSENT ? value == NULL : value != NULL && *value == expected[key]);
+        count += expected[key] != ABSENT;
+    }
+    CHECK(persistent_hashmap_size(map) == count);
+}
+
+// 重新打开并核对内容，返回打开的哈希表
+static persistent_hashmap(int, int) reopen(const char* prefix) {
+    persistent_hashmap(int, int) map = persistent_hashmap_open(int, int, path_of(prefix, ""));
+    CHECK(map != NULL);
+    check_contents(map);
+    return map;
+}
+
+static persistent_hashmap(int, int) start(const char* prefix) {
+    for (int key = 0; key < KEYS; key++) {
+        expected[key] = ABSENT;
+    }
+    return reopen(prefix);
+}
+
+static void test_torn_tail(void) {
+    persistent_hashmap(int, int) map = start("torn");
+    for (int key = 0; key < KEYS / 2; key++) {
+        put(map, key, key * 3);
+    }
+    CHECK(persistent_hashmap_sync(map));
+    off_t committed = size_of(path_of("torn", ".log"));
+    int saved[KEYS];
+    memcpy(saved, expected, sizeof(saved));
+    // 最后一帧：覆盖、删除并新增一批键
+    for (int key = 0; key < KEYS; key += 3) {
+        put(map, key, -key);
+    }
+    for (int key = 1; key < KEYS / 2; key += 3) {
+        remove_key(map, key);
+    }
+    CHECK(persistent_hashmap_free(map));
+    off_t full = size_of(path_of("torn", ".log"));
+    CHECK(full > committed + 64);
+    copy_file(path_of("torn", ".log"), path_of("torn", ".saved"));
+    memcpy(expected, saved, sizeof(saved));
+
+    // 尾帧只写了一部分：帧头完整、记录不完整，以及连帧头都不完整
+    off_t cuts[] = {full - 1, committed + 20, committed + 7};
+    for (size_t i = 0; i < sizeof(cuts) / sizeof(cuts[0]); i++) {
+        copy_file(path_of("torn", ".saved"), path_of("torn", ".log"));
+        CHECK(truncate(path_of("torn", ".log"), cuts[i]) == 0);
+        map = reopen("torn");
+        CHECK(size_of(path_of("torn", ".log")) == committed);
+        CHECK(persistent_hashmap_free(map));
+    }
+
+    // 尾帧长度完整但内容损坏，校验和不符
+    copy_file(path_of("torn", ".saved"), path_of("torn", ".log"));
+    FILE* log = fopen(path_of("torn", ".log"), "r+b");
+    CHECK(log != NULL && fseek(log, (long) full - 5, SEEK_SET) == 0);
+    int byte = fgetc(log);
+    CHECK(fseek(log, (long) full - 5, SEEK_SET) == 0 && fputc(byte ^ 0x5A, log) != EOF);
+    fclose(log);
+    map = reopen("torn");
+    CHECK(size_of(path_of("torn", ".log")) == committed);
+
+    // 截掉坏帧之后追加的写入必须能够恢复
+    put(map, KEYS - 1, 12345);
+    remove_key(map, 0);
+    CHECK(persistent_hashmap_free(map));
+    map = reopen("torn");
+    CHECK(persistent_hashmap_free(map));
+}
+
+static void test_stale_old_log(void) {
+    persistent_hashmap(int, int) map = start("stale");
+    for (int key = 0; key < KEYS; key++) {
+        put(map, key, key);
+    }
+    CHECK(persistent_hashmap_sync(map));
+    copy_file(path_of("stale", ".log"), path_of("stale", ".saved"));
+    // 删除发生在旧一代日志中，压缩后只体现在快照里
+    for (int key = 0; key < KEYS; key += 2) {
+        remove_key(map, key);
+    }
+    CHECK(persistent_hashmap_compact(map));
+    CHECK(exists(path_of("stale", ".snapshot")) && !exists(path_of("stale", ".log.old")));
+    for (int key = 1; key < KEYS; key += 4) {
+        put(map, key, key * 10);
+    }
+    CHECK(persistent_hashmap_free(map));
+
+    // 压缩线程写好快照、尚未删除旧日志时崩溃
+    copy_file(path_of("stale", ".saved"), path_of("stale", ".log.old"));
+    map = reopen("stale");
+    CHECK(!exists(path_of("stale", ".log.old")));
+    put(map, 0, 7);
+    CHECK(persistent_hashmap_free(map));
+    map = reopen("stale");
+    CHECK(persistent_hashmap_free(map));
+}
+
+static void test_renamed_without_new_log(void) {
+    persistent_hashmap(int, int) map = start("renamed");
+    for (int key = 0; key < KEYS; key++) {
+        put(map, key, key + 1);
+    }
+    CHECK(persistent_hashmap_compact(map));
+    for (int key = 0; key < KEYS; key += 5) {
+        put(map, key, -key);
+    }
+    for (int key = 3; key < KEYS; key += 5) {
+        remove_key(map, key);
+    }
+    CHECK(persistent_hashmap_free(map));
+
+    // 当前日志已改名为 .log.old，新日志尚未创建
+    CHECK(rename(path_of("renamed", ".log"), path_of("renamed", ".log.old")) == 0);
+    map = reopen("renamed");
+    CHECK(exists(path_of("renamed", ".log")) && !exists(path_of("renamed", ".log.old")));
+    put(map, 3, 33);
+    CHECK(persistent_hashmap_free(map));
+    map = reopen("renamed");
+    CHECK(persistent_hashmap_free(map));
+}
+
+static void test_fold_on_reopen(void) {
+    persistent_hashmap(int, int) map = start("fold");
+    for (int key = 0; key < KEYS; key++) {
+        put(map, key, key * 2);
+    }
+    CHECK(persistent_hashmap_sync(map));
+    copy_file(path_of("fold", ".log"), path_of("fold", ".saved"));
+    CHECK(persistent_hashmap_compact(map));
+    for (int key = 0; key < KEYS; key += 3) {
+        remove_key(map, key);
+    }
+    for (int key = 1; key < KEYS; key += 3) {
+        put(map, key, -key);
+    }
+    CHECK(persistent_hashmap_free(map));
+
+    // 新日志已经创建、压缩线程尚未写出快照时崩溃：只剩旧日志、新日志与写了一半的临时文件
+    CHECK(unlink(path_of("fold", ".snapshot")) == 0);
+    copy_file(path_of("fold", ".saved"), path_of("fold", ".log.old"));
+    FILE* temp = fopen(path_of("fold", ".snapshot.tmp"), "wb");
+    CHECK(temp != NULL && fputs("partial", temp) >= 0);
+    fclose(temp);
+
+    map = reopen("fold");
+    CHECK(exists(path_of("fold", ".snapshot")) && !exists(path_of("fold", ".log.old")));
+    CHECK(!exists(path_of("fold", ".snapshot.tmp")));
+    put(map, 0, 100);
+    CHECK(persistent_hashmap_free(map));
+
+    // 折叠出的快照与此后的日志足以恢复全部内容
+    map = reopen("fold");
+    CHECK(!exists(path_of("fold", ".log.old")));
+    CHECK(persistent_hashmap_free(map));
+}
+
+int main(void) {
+    CHECK(mkdtemp(directory) != NULL);
+    test_torn_tail();
+    test_stale_old_log();
+    test_renamed_without_new_log();
+    test_fold_on_reopen();
+
+    const char* prefixes[] = {"torn", "stale", "renamed", "fold"};
+    for (size_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+        for (size_t j = 0; j < sizeof(suffixes) / sizeof(suffixes[0]); j++) {
+            unlink(path_of(prefixes[i], suffixes[j]));
+        }
+    }
+    CHECK(rmdir(directory) == 0);
+    puts("persistent_hashmap_test ok");
+    return 0;
+}
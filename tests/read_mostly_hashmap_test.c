@@ -0,0 +1,111 @@
+/*******************************************************************************
+ *
+ *  read_mostly_hashmap.h 回归测试。
+ *
+ *  1. 跨翻译单元的纪元钉住：另一个翻译单元中的读者进入读取临界区后，
+ *     本单元的写者最多只能把全局纪元推进一代，读者离开后纪元恢复推进。
+ *  2. 读写压力：多个读者在另一个翻译单元中无锁查找，写者在本单元反复更新、删除、
+ *     清空并触发扩容，退休的节点与桶数组在读者仍可能访问时不得被释放
+ *     (配合 AddressSanitizer 检测释放后使用)，读到的值必须属于对应的键。
+ *
+ *  构建并运行 (在仓库根目录，两个源文件一起编译)：
+ *    cc -std=gnu11 -O1 -g -pthread -fsanitize=address,undefined -I. \
+ *       tests/read_mostly_hashmap_test.c tests/read_mostly_hashmap_test_reader.c \
+ *       -o read_mostly_hashmap_test && ./read_mostly_hashmap_test
+ *
+ ******************************************************************************/
+
+#include "read_mostly_hashmap.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                                \
+        }                                                                           \
+    } while (0)
+
+enum { READERS = 6, KEYS = 4096, ROUNDS = 8 };
+
+READ_MOSTLY_HASHMAP_DEFINE(int, int);
+
+// 定义于 read_mostly_hashmap_test_reader.c
+HashmapEbrRecord* other_unit_pin(void);
+void other_unit_unpin(HashmapEbrRecord* record);
+bool other_unit_get(read_mostly_hashmap(int, int) map, int key, int* value);
+
+static read_mostly_hashmap(int, int) map;
+static int done;
+
+static void* pinned_writer(void* arg) {
+    uint64_t* epochs = (uint64_t*) arg;
+    for (int i = 0; i < 3; i++) {
+        epochs[i] = Hashmap_ebr_try_advance();
+    }
+    return NULL;
+}
+
+static void test_cross_unit_pin(void) {
+    uint64_t pinned_at = __atomic_load_n(Hashmap_ebr_global_epoch(), __ATOMIC_ACQUIRE);
+    HashmapEbrRecord* record = other_unit_pin();
+    uint64_t epochs[3];
+    pthread_t writer;
+    pthread_create(&writer, NULL, pinned_writer, epochs);
+    pthread_join(writer, NULL);
+    CHECK(epochs[2] <= pinned_at + 1);
+    other_unit_unpin(record);
+    pthread_create(&writer, NULL, pinned_writer, epochs);
+    pthread_join(writer, NULL);
+    CHECK(epochs[2] >= epochs[0] + 2);
+}
+
+static void* reader(void* arg) {
+    (void) arg;
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+        for (int key = 0; key < KEYS; key++) {
+            int value;
+            if (other_unit_get(map, key, &value)) {
+                CHECK(value % KEYS == key);
+            }
+        }
+    }
+    return NULL;
+}
+
+static void test_stress(void) {
+    map = read_mostly_hashmap_new(int, int);
+    pthread_t threads[READERS];
+    for (int t = 0; t < READERS; t++) {
+        pthread_create(&threads[t], NULL, reader, NULL);
+    }
+    for (int round = 0; round < ROUNDS; round++) {
+        if (round % 3 == 2) {
+            read_mostly_hashmap_clear(map);
+        }
+        for (int key = 0; key < KEYS; key++) {
+            read_mostly_hashmap_put(map, key, round * KEYS + key);
+        }
+        for (int key = 0; key < KEYS; key += 2) {
+            CHECK(read_mostly_hashmap_remove(map, key));
+        }
+    }
+    __atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+    for (int t = 0; t < READERS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    CHECK(read_mostly_hashmap_size(map) == KEYS / 2);
+    for (int key = 0; key < KEYS; key++) {
+        int value = 0;
+        bool found = read_mostly_hashmap_get(map, key, &value);
+        CHECK(found == (key % 2 == 1));
+        CHECK(!found || value == (ROUNDS - 1) * KEYS + key);
+    }
+    read_mostly_hashmap_free(map);
+}
+
+int main(void) {
+    test_cross_unit_pin();
+    test_stress();
+    puts("read_mostly_hashmap_test ok");
+    return 0;
+}
@@ -0,0 +1,26 @@
+/*******************************************************************************
+ *
+ *  read_mostly_hashmap_test.c 的第二个翻译单元。
+ *
+ *  这里的读者与 read_mostly_hashmap_test.c 中的写者位于不同的翻译单元，
+ *  各自使用本单元展开的 static 实现，用来确认纪元回收的状态在整个程序中只有一份：
+ *  写者推进纪元、释放退休内存时，必须能看到在这里登记的读者。
+ *
+ ******************************************************************************/
+
+#include "read_mostly_hashmap.h"
+
+READ_MOSTLY_HASHMAP_DEFINE(int, int);
+
+HashmapEbrRecord* other_unit_pin(void) {
+    return Hashmap_ebr_enter();
+}
+
+void other_unit_unpin(HashmapEbrRecord* record) {
+    Hashmap_ebr_exit(record);
+}
+
+// 直接调用本单元生成的实现 (与静态分派模式相同)，而不是经由哈希表自带的、属于另一个单元的函数表
+bool other_unit_get(read_mostly_hashmap(int, int) map, int key, int* value) {
+    return ReadMostlyHashmap_int_int_get(map, key, value);
+}
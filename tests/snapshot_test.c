@@ -0,0 +1,278 @@
+/*******************************************************************************
+ *
+ *  hashmap_save / hashmap_open_mmap 快照回归测试。
+ *
+ *  1. 往返：int 键与 cstr 键 (含空表与空字符串键) 保存后重新映射，内容完全一致；
+ *     从映射出的冻结表再次保存，得到的文件同样可以打开。
+ *  2. 截断、魔数损坏、文件头字段损坏、段偏移量越界的文件打开时返回 NULL。
+ *  3. remap 表或字符串键偏移量越界的文件仍可打开 (这些项在查找时才检查)：
+ *     受影响的键按不存在处理，其余键的查找结果不受影响。
+ *
+ *  构建并运行 (在仓库根目录)：
+ *    cc -std=gnu11 -O1 -g -fsanitize=address,undefined -I. \
+ *       tests/snapshot_test.c -o snapshot_test && ./snapshot_test
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <unistd.h>
+#include "hashmap.h"
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                                \
+        }                                                                           \
+    } while (0)
+
+typedef const char* cstr;
+
+HASHMAP_DEFINE(int, int);
+HASHMAP_DEFINE(cstr, int);
+
+enum { KEYS = 5000 };
+
+static char directory[] = "/tmp/snapshot_testXXXXXX";
+static char names[KEYS][16];
+
+static const char* path_of(const char* name) {
+    static char paths[4][64];
+    static int next;
+    char* path = paths[next++ % 4];
+    snprintf(path, sizeof(paths[0]), "%s/%s", directory, name);
+    return path;
+}
+
+static char* read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    CHECK(file != NULL);
+    fseek(file, 0, SEEK_END);
+    *size = (size_t) ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* data = (char*) malloc(*size);
+    CHECK(fread(data, 1, *size, file) == *size);
+    fclose(file);
+    return data;
+}
+
+static void write_file(const char* path, const char* data, size_t size) {
+    FILE* file = fopen(path, "wb");
+    CHECK(file != NULL && fwrite(data, 1, size, file) == size);
+    fclose(file);
+}
+
+// 把 src 复制为 dst，并用 bytes 覆盖 offset 处的 count 字节
+static void patch(const char* src, const char* dst, uint64_t offset, const void* bytes, size_t count) {
+    size_t size;
+    char* data = read_file(src, &size);
+    CHECK(offset + count <= size);
+    memcpy(data + offset, bytes, count);
+    write_file(dst, data, size);
+    free(data);
+}
+
+static HashmapSnapshotHeader header_of(const char* path) {
+    size_t size;
+    char* data = read_file(path, &size);
+    HashmapSnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    free(data);
+    return header;
+}
+
+static void test_int_round_trip(void) {
+    const char* path = path_of("int.bin");
+    for (int n = 0; n <= KEYS; n = n * 4 + 1) {
+        hashmap(int, int) map = hashmap_new(int, int);
+        for (int i = 0; i < n; i++) {
+            hashmap_put(map, i * 7 - 100, i);
+        }
+        CHECK(hashmap_save(map, path));
+        frozen_hashmap(int, int) frozen = hashmap_open_mmap(int, int, path);
+        CHECK(frozen != NULL && frozen_hashmap_size(frozen) == n);
+        for (int i = 0; i < n; i++) {
+            const int* value = frozen_hashmap_get(frozen, i * 7 - 100);
+            CHECK(value != NULL && *value == i);
+            CHECK(!frozen_hashmap_contains(frozen, i * 7 - 99));
+        }
+        // 键值类型不匹配的快照拒绝打开
+        CHECK(hashmap_open_mmap(cstr, int, path) == NULL);
+        frozen_hashmap_free(frozen);
+        hashmap_free(map);
+    }
+}
+
+static void test_string_round_trip(void) {
+    hashmap(cstr, int) map = hashmap_new(cstr, int);
+    for (int i = 0; i < KEYS; i++) {
+        hashmap_put(map, names[i], i);
+    }
+    hashmap_put(map, "", -1);
+    CHECK(hashmap_save(map, path_of("cstr.bin")));
+
+    frozen_hashmap(cstr, int) frozen = hashmap_open_mmap(cstr, int, path_of("cstr.bin"));
+    CHECK(frozen != NULL && frozen_hashmap_size(frozen) == KEYS + 1);
+    char name[16];
+    for (int i = 0; i < KEYS; i++) {
+        snprintf(name, sizeof(name), "key-%d", i);
+        const int* value = frozen_hashmap_get(frozen, name);
+        CHECK(value != NULL && *value == i);
+    }
+    CHECK(*frozen_hashmap_get(frozen, "") == -1);
+    CHECK(!frozen_hashmap_contains(frozen, "key-"));
+    CHECK(!frozen_hashmap_contains(frozen, "key-5000"));
+    for (int i = 0; i < frozen_hashmap_size(frozen); i++) {
+        CHECK(*hashmap_get(map, frozen_hashmap_key_at(frozen, i)) == frozen_hashmap_value_at(frozen, i));
+    }
+
+    // 映射出的冻结表可以再次保存
+    CHECK(frozen_hashmap_save(frozen, path_of("cstr2.bin")));
+    frozen_hashmap(cstr, int) again = hashmap_open_mmap(cstr, int, path_of("cstr2.bin"));
+    CHECK(again != NULL && frozen_hashmap_size(again) == KEYS + 1);
+    CHECK(*frozen_hashmap_get(again, "key-17") == 17);
+    frozen_hashmap_free(again);
+    frozen_hashmap_free(frozen);
+
+    hashmap(cstr, int) empty = hashmap_new(cstr, int);
+    CHECK(hashmap_save(empty, path_of("empty.bin")));
+    frozen = hashmap_open_mmap(cstr, int, path_of("empty.bin"));
+    CHECK(frozen != NULL && frozen_hashmap_size(frozen) == 0 && !frozen_hashmap_contains(frozen, "key-1"));
+    frozen_hashmap_free(frozen);
+    hashmap_free(empty);
+    hashmap_free(map);
+}
+
+static void test_rejected_at_open(void) {
+    const char* good = path_of("cstr.bin");
+    const char* bad = path_of("bad.bin");
+    HashmapSnapshotHeader header = header_of(good);
+    size_t size;
+    char* data = read_file(good, &size);
+
+    CHECK(hashmap_open_mmap(cstr, int, path_of("missing.bin")) == NULL);
+    size_t lengths[] = {0, sizeof(HashmapSnapshotHeader) - 1, sizeof(HashmapSnapshotHeader), size / 2, size - 1};
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        write_file(bad, data, lengths[i]);
+        CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+    }
+    free(data);
+
+    patch(good, bad, offsetof(HashmapSnapshotHeader, magic), "XOOPHMAP", 8);
+    CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+    uint32_t version = 99;
+    patch(good, bad, offsetof(HashmapSnapshotHeader, version), &version, sizeof(version));
+    CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+    uint64_t slots = header.size;
+    patch(good, bad, offsetof(HashmapSnapshotHeader, slots), &slots, sizeof(slots));
+    CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+    uint64_t buckets = 0;
+    patch(good, bad, offsetof(HashmapSnapshotHeader, buckets), &buckets, sizeof(buckets));
+    CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+
+    // 各段偏移量：未对齐或超出文件末尾
+    size_t sections[] = {offsetof(HashmapSnapshotHeader, pilots), offsetof(HashmapSnapshotHeader, remap),
+                         offsetof(HashmapSnapshotHeader, keys), offsetof(HashmapSnapshotHeader, values),
+                         offsetof(HashmapSnapshotHeader, strings)};
+    for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); i++) {
+        uint64_t offset = size + __HASHMAP_SNAPSHOT_ALIGN;
+        patch(good, bad, sections[i], &offset, sizeof(offset));
+        CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+        offset = header.pilots + 1;
+        patch(good, bad, sections[i], &offset, sizeof(offset));
+        CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+    }
+    uint64_t strings_size = header.strings_size + 1;
+    patch(good, bad, offsetof(HashmapSnapshotHeader, strings_size), &strings_size, sizeof(strings_size));
+    CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+    // 字符串区最后一个字节必须是 '\0'
+    patch(good, bad, header.strings + header.strings_size - 1, "x", 1);
+    CHECK(hashmap_open_mmap(cstr, int, bad) == NULL);
+}
+
+// 越界的 remap 项或字符串偏移量只影响对应的键；远超映射范围的取值若未被检查会直接触发段错误
+static void test_rejected_at_lookup(void) {
+    const char* good = path_of("cstr.bin");
+    const char* bad = path_of("bad.bin");
+    HashmapSnapshotHeader header = header_of(good);
+    CHECK(header.slots > header.size);
+
+    uint32_t targets[] = {(uint32_t) header.size, INT32_MAX, UINT32_MAX};
+    for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+        for (uint64_t i = 0; i < header.slots - header.size; i++) {
+            patch(good, bad, header.remap + i * sizeof(uint32_t), &targets[t], sizeof(targets[t]));
+            frozen_hashmap(cstr, int) frozen = hashmap_open_mmap(cstr, int, bad);
+            CHECK(frozen != NULL);
+            for (int k = 0; k < KEYS; k++) {
+                const int* value = frozen_hashmap_get(frozen, names[k]);
+                CHECK(value == NULL || *value == k);
+            }
+            frozen_hashmap_free(frozen);
+        }
+    }
+
+    frozen_hashmap(cstr, int) frozen = hashmap_open_mmap(cstr, int, good);
+    const char* victim = frozen_hashmap_key_at(frozen, 17);
+    int victim_value = frozen_hashmap_value_at(frozen, 17);
+    char victim_name[16];
+    snprintf(victim_name, sizeof(victim_name), "%s", victim);
+    frozen_hashmap_free(frozen);
+
+    uint64_t offsets[] = {header.strings_size, header.strings_size + ((uint64_t) 1 << 40), UINT64_MAX};
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        patch(good, bad, header.keys + 17 * sizeof(uint64_t), &offsets[i], sizeof(offsets[i]));
+        frozen = hashmap_open_mmap(cstr, int, bad);
+        CHECK(frozen != NULL);
+        CHECK(frozen_hashmap_get(frozen, victim_name) == NULL);
+        CHECK(strcmp(frozen_hashmap_key_at(frozen, 17), "") == 0);
+        for (int k = 0; k < KEYS; k++) {
+            const int* value = frozen_hashmap_get(frozen, names[k]);
+            CHECK(k == victim_value ? value == NULL : value != NULL && *value == k);
+        }
+        frozen_hashmap_free(frozen);
+    }
+
+    // int 键：remap 全部指向越界位置时，所有经由 remap 的查找都按不存在处理
+    hashmap(int, int) map = hashmap_new(int, int);
+    for (int i = 0; i < KEYS; i++) {
+        hashmap_put(map, i, i);
+    }
+    const char* ints = path_of("int_remap.bin");
+    CHECK(hashmap_save(map, ints));
+    hashmap_free(map);
+    header = header_of(ints);
+    size_t size;
+    char* data = read_file(ints, &size);
+    memset(data + header.remap, 0xFF, (header.slots - header.size) * sizeof(uint32_t));
+    write_file(bad, data, size);
+    free(data);
+    frozen_hashmap(int, int) numbers = hashmap_open_mmap(int, int, bad);
+    CHECK(numbers != NULL);
+    int missing = 0;
+    for (int i = 0; i < KEYS; i++) {
+        const int* value = frozen_hashmap_get(numbers, i);
+        missing += value == NULL;
+        CHECK(value == NULL || *value == i);
+    }
+    CHECK(missing > 0);
+    frozen_hashmap_free(numbers);
+}
+
+int main(void) {
+    CHECK(mkdtemp(directory) != NULL);
+    for (int i = 0; i < KEYS; i++) {
+        snprintf(names[i], sizeof(names[i]), "key-%d", i);
+    }
+    test_int_round_trip();
+    test_string_round_trip();
+    test_rejected_at_open();
+    test_rejected_at_lookup();
+
+    const char* files[] = {"int.bin", "cstr.bin", "cstr2.bin", "empty.bin", "bad.bin", "int_remap.bin"};
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        unlink(path_of(files[i]));
+    }
+    rmdir(directory);
+    puts("snapshot_test ok");
+    return 0;
+}
@@ -3,6 +3,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include "container_memory.h"
 
 /**
  * @file vector.h
@@ -15,6 +16,40 @@
  * @date 2025-10-13
  */
 
+// === 公共API: 编译期配置 ===
+
+/**
+ * @brief 静态分派模式 (默认关闭，`#define COOP_STATIC_DISPATCH` 开启)。
+ *
+ * 开启后，列在 `COOP_VECTOR_TYPES` 中的元素类型，其 `vector_*` 宏在编译期通过
+ * `_Generic` 选中对应的静态函数表，`vector_get` 等调用因而可以被内联成一次访存；
+ * 生成的实现内部也直接调用 `EqualsFn`/`DisplayFn`。未列出的类型仍走 `(vec)->fns`，
+ * 函数表本身保持不变。`COOP_VECTOR_TYPES` 必须在包含本头文件之前定义，
+ * 其中列出的类型必须在第一次使用公共宏之前全部通过定义宏生成，且不能重复。
+ *
+ * @example
+ * #define COOP_STATIC_DISPATCH
+ * #define COOP_VECTOR_TYPES(X) X(int) X(double)
+ * #include "vector.h"
+ */
+#ifndef COOP_VECTOR_TYPES
+#define COOP_VECTOR_TYPES(X)
+#endif
+
+#ifdef COOP_STATIC_DISPATCH
+// --- Internal Macros ---
+#define __VECTOR_VTABLE(self, T) (&VECTOR_##T##_FUNCTIONS)
+// --- Internal Macros ---
+#define __VECTOR_FNS_CASE(T) Vector_##T*: &VECTOR_##T##_FUNCTIONS,
+// --- Internal Macros ---
+#define __VECTOR_FNS(vec) _Generic((vec), COOP_VECTOR_TYPES(__VECTOR_FNS_CASE) default: (vec)->fns)
+#else
+// --- Internal Macros ---
+#define __VECTOR_VTABLE(self, T) ((self)->fns)
+// --- Internal Macros ---
+#define __VECTOR_FNS(vec) (vec)->fns
+#endif
+
 // === 公共API: 定义宏 ===
 
 /**
@@ -101,6 +136,7 @@ struct Vector_##T##_Functions {
     struct VectorIterator_##T (*get_iterator)(Vector_##T* self);                    \
     bool (*iterator_next)(struct VectorIterator_##T* self);                         \
     const T* (*iterator_current)(struct VectorIterator_##T* self);                  \
+    ContainerMemoryUsage (*memory_usage)(Vector_##T* self);                         \
     void (*free)(Vector_##T* self);                                                 \
 };                                                                                  \
                                                                                     \
@@ -111,10 +147,16 @@ struct _Vector_##T {
     int capacity;                                                                   \
 };                                                                                  \
                                                                                     \
+const static struct Vector_##T##_Functions VECTOR_##T##_FUNCTIONS;                  \
+                                                                                    \
+static void Vector_##T##_track(long long bytes, int blocks) {                       \
+    __CONTAINER_MEMORY_TRACK("vector(" #T ")", bytes, blocks);                      \
+}                                                                                   \
+                                                                                    \
 static void Vector_##T##_display(Vector_##T* self, FILE* stream) {                  \
     fprintf(stream, "[");                                                           \
     for (int i = 0; i < self->size; i++) {                                          \
-        self->fns->display_element(stream, self->data[i]);                          \
+        __VECTOR_VTABLE(self, T)->display_element(stream, self->data[i]);           \
         if (i != self->size - 1) {                                                  \
             fprintf(stream, ", ");                                                  \
         }                                                                           \
@@ -124,6 +166,7 @@ static void Vector_##T##_display(Vector_##T* self, FILE* stream) {
                                                                                     \
 static void Vector_##T##_push(Vector_##T* self, T value) {                          \
     if (self->size == self->capacity) {                                             \
+        Vector_##T##_track((long long) self->capacity * sizeof(T), 0);              \
         self->capacity *= 2;                                                        \
         self->data = (T*) realloc(self->data, self->capacity * sizeof(T));          \
     }                                                                               \
@@ -166,7 +209,7 @@ static bool Vector_##T##_remove(Vector_##T* self, int index) {
                                                                                     \
 static int Vector_##T##_index_of(Vector_##T* self, T value) {                       \
     for (int i = 0; i < self->size; i++) {                                          \
-        if (self->fns->equals(self->data[i], value)) {                              \
+        if (__VECTOR_VTABLE(self, T)->equals(self->data[i], value)) {               \
             return i;                                                               \
         }                                                                           \
     }                                                                               \
@@ -190,6 +233,7 @@ static bool Vector_##T##_insert(Vector_##T* self, int index, T value) {
         return false;                                                               \
     }                                                                               \
     if (self->size == self->capacity) {                                             \
+        Vector_##T##_track((long long) self->capacity * sizeof(T), 0);              \
         self->capacity *= 2;                                                        \
         self->data = (T*) realloc(self->data, self->capacity * sizeof(T));          \
     }                                                                               \
@@ -232,7 +276,16 @@ static const T* Vector_##T##_iterator_current(struct VectorIterator_##T* self) {
     return NULL;                                                                    \
 }                                                                                   \
                                                                                     \
+static ContainerMemoryUsage Vector_##T##_memory_usage(Vector_##T* self) {           \
+    ContainerMemoryUsage usage = {self->size * sizeof(T), 0, 0, 0};                 \
+    ContainerMemory_add_block(&usage, self, sizeof(*self));                         \
+    ContainerMemory_add_block(&usage, self->data, self->capacity * sizeof(T));      \
+    return usage;                                                                   \
+}                                                                                   \
+                                                                                    \
 static void Vector_##T##_free(Vector_##T* self) {                                   \
+    long long bytes = sizeof(*self) + (long long) self->capacity * sizeof(T);       \
+    Vector_##T##_track(-bytes, -2);                                                 \
     free(self->data);                                                               \
     free(self);                                                                     \
 }                                                                                   \
@@ -255,6 +308,7 @@ const static struct Vector_##T##_Functions VECTOR_##T##_FUNCTIONS = {
     .get_iterator = Vector_##T##_get_iterator,                                      \
     .iterator_next = Vector_##T##_iterator_next,                                    \
     .iterator_current = Vector_##T##_iterator_current,                              \
+    .memory_usage = Vector_##T##_memory_usage,                                      \
     .free = Vector_##T##_free,                                                      \
 };                                                                                  \
                                                                                     \
@@ -264,6 +318,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
     self->data = (T*) malloc(capacity * sizeof(T));                                 \
     self->size = 0;                                                                 \
     self->capacity = capacity;                                                      \
+    Vector_##T##_track((long long) (sizeof(*self) + capacity * sizeof(T)), 2);      \
     return self;                                                                    \
 }                                                                                   \
 
@@ -312,7 +367,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * vector_push(my_vec, 42);
  * vector_push(student_vec, (Student){101, "Alice"});
  */
-#define vector_push(vec, ...) (vec)->fns->push((vec), __VA_ARGS__)
+#define vector_push(vec, ...) __VECTOR_FNS(vec)->push((vec), __VA_ARGS__)
 
 /**
  * @brief从向量中移除最后一个元素。
@@ -320,7 +375,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (bool) 如果成功移除了一个元素，则返回 `true`；如果向量已空，则返回 `false`。
  * @example vector_pop(my_vec);
  */
-#define vector_pop(vec) (vec)->fns->pop(vec)
+#define vector_pop(vec) __VECTOR_FNS(vec)->pop(vec)
 
 /**
  * @brief 检索特定索引处的元素。
@@ -329,7 +384,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (const T*) 如果索引有效，则返回指向元素的只读指针；否则返回 NULL。
  * @example const int* val = vector_get(my_vec, 0);
  */
-#define vector_get(vec, index) (vec)->fns->get((vec), (index))
+#define vector_get(vec, index) __VECTOR_FNS(vec)->get((vec), (index))
 
 /**
  * @brief 检索向量的最后一个元素。
@@ -337,7 +392,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (const T*) 指向最后一个元素的只读指针；如果向量为空，则返回 NULL。
  * @example const int* last_val = vector_last(my_vec);
  */
-#define vector_last(vec) (vec)->fns->last(vec)
+#define vector_last(vec) __VECTOR_FNS(vec)->last(vec)
 
 /**
  * @brief 用一个新值更新特定索引处的元素。
@@ -350,7 +405,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (bool) 如果索引有效且元素被设置，则返回 `true`；否则返回 `false`。
  * @example vector_set(my_vec, 0, 99);
  */
-#define vector_set(vec, index, ...) (vec)->fns->set((vec), (index), __VA_ARGS__)
+#define vector_set(vec, index, ...) __VECTOR_FNS(vec)->set((vec), (index), __VA_ARGS__)
 /**
  * @brief 在特定索引处插入一个值，并将后续元素后移。
  *
@@ -362,7 +417,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (bool) 如果插入成功，则返回 `true`；如果索引越界，则返回 `false`。
  * @example vector_insert(my_vec, 1, 123);
  */
-#define vector_insert(vec, index, ...) (vec)->fns->insert((vec), (index), __VA_ARGS__)
+#define vector_insert(vec, index, ...) __VECTOR_FNS(vec)->insert((vec), (index), __VA_ARGS__)
 
 /**
  * @brief 移除特定索引处的元素。
@@ -371,7 +426,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (bool) 如果成功移除了一个元素，则返回 `true`；如果索引越界，则返回 `false`。
  * @example vector_remove(my_vec, 1);
  */
-#define vector_remove(vec, index) (vec)->fns->remove((vec), (index))
+#define vector_remove(vec, index) __VECTOR_FNS(vec)->remove((vec), (index))
 
 
 // === 公共API: 搜索与查询宏 ===
@@ -384,7 +439,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (int) 值的第一个出现位置的索引；如果未找到，则返回 -1。
  * @example int pos = vector_index_of(my_vec, 42);
  */
-#define vector_index_of(vec, value) (vec)->fns->index_of((vec), (value))
+#define vector_index_of(vec, value) __VECTOR_FNS(vec)->index_of((vec), (value))
 
 /**
  * @brief 从向量中移除第一次出现的给定值。
@@ -393,7 +448,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (bool) 如果找到并移除了一个元素，则返回 `true`；否则返回 `false`。
  * @example vector_remove_element(my_vec, 42);
  */
-#define vector_remove_element(vec, value) (vec)->fns->remove_element((vec), (value))
+#define vector_remove_element(vec, value) __VECTOR_FNS(vec)->remove_element((vec), (value))
 
 /**
  * @brief 检查向量是否包含特定值。
@@ -402,7 +457,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (bool) 如果值存在，则返回 `true`；否则返回 `false`。
  * @example if (vector_contains(my_vec, 99)) { ... }
  */
-#define vector_contains(vec, value) (vec)->fns->contains((vec), (value))
+#define vector_contains(vec, value) __VECTOR_FNS(vec)->contains((vec), (value))
 
 
 // === 公共API: 工具与生命周期宏 ===
@@ -413,7 +468,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @param stream (FILE*) 输出流 (例如, stdout)。
  * @example vector_display(my_vec, stdout); // 输出: [elem1, elem2, elem3]
  */
-#define vector_display(vec, stream) (vec)->fns->display((vec), (stream))
+#define vector_display(vec, stream) __VECTOR_FNS(vec)->display((vec), (stream))
 
 /**
  * @brief 返回向量中元素的数量。
@@ -429,7 +484,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @param vec (vector(T)) 向量实例。
  * @example vector_clear(my_vec);
  */
-#define vector_clear(vec) (vec)->fns->clear(vec)
+#define vector_clear(vec) __VECTOR_FNS(vec)->clear(vec)
 
 /**
  * @brief 释放与向量相关的所有内存。
@@ -438,7 +493,18 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @param vec (vector(T)) 向量实例。
  * @example vector_free(my_vec);
  */
-#define vector_free(vec) (vec)->fns->free(vec)
+#define vector_free(vec) __VECTOR_FNS(vec)->free(vec)
+
+/**
+ * @brief 返回向量的内存占用：元素本身、包括容量余量在内的申请字节数，
+ * 以及分配器实际给出的字节数。
+ * @param vec (vector(T)) 向量实例。
+ * @return (ContainerMemoryUsage) 内存占用统计。
+ * @example
+ * ContainerMemoryUsage usage = vector_memory_usage(my_vec);
+ * size_t slack = usage.requested_bytes - usage.logical_bytes;
+ */
+#define vector_memory_usage(vec) __VECTOR_FNS(vec)->memory_usage(vec)
 
 
 // === 公共API: 迭代器宏 ===
@@ -457,7 +523,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (vector_iterator(T)) 一个用于该向量的迭代器。
  * @example vector_iterator(int) it = vector_get_iterator(my_vec);
  */
-#define vector_get_iterator(vec) (vec)->fns->get_iterator(vec)
+#define vector_get_iterator(vec) __VECTOR_FNS(vec)->get_iterator(vec)
 
 /**
  * @brief 将迭代器推进到向量中的下一个元素。
@@ -465,7 +531,7 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (bool) 如果迭代器成功指向一个有效元素，则返回 `true`；如果已到达末尾，则返回 `false`。
  * @example while (vector_iterator_next(&it)) { ... }
  */
-#define vector_iterator_next(iter) (iter).vec->fns->iterator_next(&(iter))
+#define vector_iterator_next(iter) __VECTOR_FNS((iter).vec)->iterator_next(&(iter))
 
 /**
  * @brief 检索迭代器当前位置的元素。
@@ -474,6 +540,6 @@ static Vector_##T* Vector_##T##_new(int capacity) {
  * @return (const T*) 指向当前元素的只读指针。
  * @example const int* val = vector_iterator_current(&it);
  */
-#define vector_iterator_current(iter) (iter).vec->fns->iterator_current(&(iter))
+#define vector_iterator_current(iter) __VECTOR_FNS((iter).vec)->iterator_current(&(iter))
 
 #endif // VECTOR_H
\ No newline at end of file